@@ -0,0 +1,632 @@
+// Throughput benchmarks for the player engine and its event queues
+//
+// Run with JSON output for comparison against bench/baseline.json:
+//   superspreader_benchmark --benchmark_out=results.json --benchmark_out_format=json
+
+// Google Benchmark
+#include <benchmark/benchmark.h>
+
+// C++ Standard Library
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "advertisement.h"
+#include "contact_set.h"
+#include "exposure_scan.h"
+#include "health_monitor_batch.h"
+#include "health_monitor_core.h"
+#include "scan_trace.h"
+#include "spsc_ring_buffer.h"
+#include "static_ring_buffer.h"
+#include "wake_cycle.h"
+
+//// Allocation counting //////////////////////////////////////////////
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+}  // namespace
+
+// Kept out of line, or gcc sees malloc() and free() through new and delete and warns
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* const p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+
+namespace {
+
+constexpr std::size_t kPlayers = 1 << 16;
+
+//// Inputs /////////////////////////////////////////////////////////////
+
+/** @brief Health distributions, selected by the first benchmark argument */
+enum HealthMix : int {
+    kUniform      = 0, /**< Every health value equally likely */
+    kSuperHealthy = 1, /**< Start of a game */
+    kHealthy      = 2, /**< Susceptible crowd */
+    kInfected     = 3, /**< Late game */
+    kTerminal     = 4, /**< Immune and zombie players only */
+};
+
+/** @brief Exposure distributions, selected by the second benchmark argument */
+enum ExposureMix : int {
+    kNone  = 0, /**< Nobody nearby */
+    kLight = 1, /**< Occasional infected human */
+    kHeavy = 2, /**< Crowded room with cats */
+};
+
+std::vector<health_t> make_health(int mix) {
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<health_t> uniform{0, to_health(StateBounds::ZOMBIE)};
+    std::uniform_int_distribution<health_t> super_healthy{to_health(StateBounds::SUPER_HEALTHY),
+                                                          to_health(StateBounds::HEALTHY) - 1};
+    std::uniform_int_distribution<health_t> healthy{to_health(StateBounds::HEALTHY),
+                                                    to_health(StateBounds::INFECTED_ASYM) - 1};
+    std::uniform_int_distribution<health_t> infected{to_health(StateBounds::INFECTED_ASYM),
+                                                     to_health(StateBounds::ZOMBIE) - 1};
+    std::bernoulli_distribution coin;
+
+    std::vector<health_t> health(kPlayers);
+    for (auto& h : health) {
+        switch (mix) {
+            case kSuperHealthy:
+                h = super_healthy(gen);
+                break;
+            case kHealthy:
+                h = healthy(gen);
+                break;
+            case kInfected:
+                h = infected(gen);
+                break;
+            case kTerminal:
+                h = coin(gen) ? to_health(StateBounds::IMMUNE) : to_health(StateBounds::ZOMBIE);
+                break;
+            default:
+                h = uniform(gen);
+                break;
+        }
+    }
+    return health;
+}
+
+std::vector<ExposureEvent> make_exposures(int mix) {
+    std::mt19937 gen{2};
+    std::bernoulli_distribution light{0.1};
+    std::uniform_int_distribution<health_t> heavy_human{0, 8};
+    std::uniform_int_distribution<health_t> heavy_cat{0, 2};
+
+    std::vector<ExposureEvent> exposures(kPlayers);
+    for (auto& exposure : exposures) {
+        if (mix == kLight) {
+            exposure.human = light(gen);
+        } else if (mix == kHeavy) {
+            exposure.human = heavy_human(gen);
+            exposure.cat   = heavy_cat(gen);
+        }
+    }
+    return exposures;
+}
+
+void health_and_exposure_args(benchmark::internal::Benchmark* bench) {
+    for (int health = kUniform; health <= kTerminal; ++health) {
+        for (int exposure = kNone; exposure <= kHeavy; ++exposure) {
+            bench->Args({health, exposure});
+        }
+    }
+}
+
+//// Player engine //////////////////////////////////////////////////////
+
+void BM_ExposureUpdate(benchmark::State& state) {
+    auto health          = make_health(static_cast<int>(state.range(0)));
+    auto const exposures = make_exposures(static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kPlayers; ++i) {
+            health[i] = exposure_update(HealthState{health[i]}, exposures[i]).health;
+        }
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_ExposureUpdate)->Apply(health_and_exposure_args);
+
+void BM_ExposureUpdateLut(benchmark::State& state) {
+    auto health          = make_health(static_cast<int>(state.range(0)));
+    auto const exposures = make_exposures(static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kPlayers; ++i) {
+            health[i] = exposure_update_lut(HealthState{health[i]}, exposures[i]).health;
+        }
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_ExposureUpdateLut)->Apply(health_and_exposure_args);
+
+void BM_ExposureUpdateBatch(benchmark::State& state) {
+    auto const kernel = static_cast<BatchKernel>(state.range(2));
+    if (!is_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    auto health          = make_health(static_cast<int>(state.range(0)));
+    auto const exposures = make_exposures(static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        exposure_update_batch(health.data(), exposures.data(), kPlayers, kernel);
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_ExposureUpdateBatch)
+    ->ArgsProduct({{kUniform, kHealthy},
+                   {kNone, kHeavy},
+                   {static_cast<int>(BatchKernel::SCALAR),
+                    static_cast<int>(BatchKernel::SSE4_1),
+                    static_cast<int>(BatchKernel::AVX2)}});
+
+void BM_TreatmentUpdate(benchmark::State& state) {
+    auto const initial = make_health(static_cast<int>(state.range(0)));
+    auto health        = initial;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kPlayers; ++i) {
+            health[i] = treament_update(HealthState{initial[i]}).health;
+        }
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_TreatmentUpdate)->DenseRange(kUniform, kTerminal);
+
+void BM_TreatmentUpdateBatch(benchmark::State& state) {
+    auto const kernel = static_cast<BatchKernel>(state.range(1));
+    if (!is_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    auto const initial = make_health(static_cast<int>(state.range(0)));
+    auto health        = initial;
+    for (auto _ : state) {
+        state.PauseTiming();
+        health = initial;
+        state.ResumeTiming();
+        treament_update_batch(health.data(), kPlayers, kernel);
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_TreatmentUpdateBatch)
+    ->ArgsProduct({{kUniform, kInfected},
+                   {static_cast<int>(BatchKernel::SCALAR),
+                    static_cast<int>(BatchKernel::SSE4_1),
+                    static_cast<int>(BatchKernel::AVX2)}});
+
+/** @brief One device wake: @p range(0) events, every @p range(1)-th one a treatment */
+void BM_GameUpdate(benchmark::State& state) {
+    auto const num_events      = static_cast<std::size_t>(state.range(0));
+    auto const treatment_every = static_cast<std::size_t>(state.range(1));
+    auto const exposures       = make_exposures(kHeavy);
+
+    std::vector<Event> events;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        events.push_back(treatment_every != 0 && i % treatment_every == 0
+                             ? Event{TreatmentEvent{}}
+                             : Event{exposures[i % exposures.size()]});
+    }
+
+    auto const initial = make_health(kUniform);
+    std::size_t player = 0;
+    for (auto _ : state) {
+        PlayerState player_state;
+        player_state.health.health = initial[player++ % kPlayers];
+        std::size_t next           = 0;
+        game_update(
+            player_state,
+            [&events, &next]() { return next < events.size() ? events[next++] : Event{}; },
+            [](ExposureEvent const& exposure) { benchmark::DoNotOptimize(&exposure); },
+            [](TreatmentEvent const& treatment) { benchmark::DoNotOptimize(&treatment); });
+        benchmark::DoNotOptimize(player_state);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(num_events));
+}
+BENCHMARK(BM_GameUpdate)->ArgsProduct({{1, 2, 4, 16, 64}, {0, 2}});
+
+/** @brief Same wake as @c BM_GameUpdate, tracing into a @c GameTraceBuffer */
+void BM_GameUpdateTraced(benchmark::State& state) {
+    auto const num_events      = static_cast<std::size_t>(state.range(0));
+    auto const treatment_every = static_cast<std::size_t>(state.range(1));
+    auto const exposures       = make_exposures(kHeavy);
+
+    std::vector<Event> events;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        events.push_back(treatment_every != 0 && i % treatment_every == 0
+                             ? Event{TreatmentEvent{}}
+                             : Event{exposures[i % exposures.size()]});
+    }
+
+    auto const initial = make_health(kUniform);
+    std::size_t player = 0;
+    GameTraceBuffer<128> trace{};
+    for (auto _ : state) {
+        PlayerState player_state;
+        player_state.health.health = initial[player++ % kPlayers];
+        std::size_t next           = 0;
+        trace.clear();
+        game_update(
+            player_state,
+            [&events, &next]() { return next < events.size() ? events[next++] : Event{}; },
+            [](ExposureEvent const& exposure) { benchmark::DoNotOptimize(&exposure); },
+            [](TreatmentEvent const& treatment) { benchmark::DoNotOptimize(&treatment); },
+            trace);
+        benchmark::DoNotOptimize(player_state);
+        benchmark::DoNotOptimize(trace);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(num_events));
+}
+BENCHMARK(BM_GameUpdateTraced)->ArgsProduct({{1, 4, 64}, {0, 2}});
+
+/** @brief Same wake as @c BM_GameUpdate, through the batch overload */
+void BM_GameUpdateBatch(benchmark::State& state) {
+    auto const num_events      = static_cast<std::size_t>(state.range(0));
+    auto const treatment_every = static_cast<std::size_t>(state.range(1));
+    auto const exposures       = make_exposures(kHeavy);
+
+    std::vector<Event> events;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        events.push_back(treatment_every != 0 && i % treatment_every == 0
+                             ? Event{TreatmentEvent{}}
+                             : Event{exposures[i % exposures.size()]});
+    }
+
+    auto const initial = make_health(kUniform);
+    std::size_t player = 0;
+    for (auto _ : state) {
+        PlayerState player_state;
+        player_state.health.health = initial[player++ % kPlayers];
+        game_update(
+            player_state,
+            events.data(),
+            events.size(),
+            [](ExposureEvent const& exposure) { benchmark::DoNotOptimize(&exposure); },
+            [](TreatmentEvent const& treatment) { benchmark::DoNotOptimize(&treatment); });
+        benchmark::DoNotOptimize(player_state);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(num_events));
+}
+BENCHMARK(BM_GameUpdateBatch)->ArgsProduct({{1, 2, 4, 16, 64}, {0, 2}});
+
+/** @brief Catching up @p range(0) idle ticks one exposure update at a time */
+void BM_IdleTicksLoop(benchmark::State& state) {
+    auto const ticks   = static_cast<int>(state.range(0));
+    auto const initial = make_health(kUniform);
+    auto health        = initial;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kPlayers; ++i) {
+            HealthState player{initial[i]};
+            for (int t = 0; t < ticks; ++t) {
+                player = exposure_update(player, ExposureEvent{});
+            }
+            health[i] = player.health;
+        }
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_IdleTicksLoop)->Arg(10)->Arg(1000);
+
+/** @brief Catching up @p range(0) idle ticks with @c idle_update */
+void BM_IdleUpdate(benchmark::State& state) {
+    auto const ticks   = static_cast<unsigned long>(state.range(0));
+    auto const initial = make_health(kUniform);
+    auto health        = initial;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kPlayers; ++i) {
+            health[i] = idle_update(HealthState{initial[i]}, ticks).health;
+        }
+        benchmark::DoNotOptimize(health.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kPlayers);
+}
+BENCHMARK(BM_IdleUpdate)->Arg(10)->Arg(1000);
+
+//// Scan classification //////////////////////////////////////////////
+
+/** @returns names of a crowded scan: monitors in every state mixed with other devices */
+std::vector<std::string> make_scan_names() {
+    std::vector<std::string> names;
+    for (auto state = static_cast<int>(AdvertisedState::IMMUNE);
+         state <= static_cast<int>(AdvertisedState::CAT);
+         ++state) {
+        names.push_back(std::string{kMonitorPrefix} +
+                        to_display_name(static_cast<AdvertisedState>(state)));
+    }
+    names.push_back("");
+    names.push_back("Galaxy Buds Pro (A1B2)");
+    names.push_back("[TV] Living Room");
+    return names;
+}
+
+/** @brief Scan classification as the firmware did it before @c classify_name */
+AdvertisedState classify_name_with_strings(std::string const& name) {
+    if (name.rfind(kMonitorPrefix, 0) != 0) {
+        return AdvertisedState::UNKNOWN;
+    }
+    auto const state = name.substr(std::string(kMonitorPrefix).length());
+    if (state == "Asymptomatic" || state == "Sick" || state == "Zombie") {
+        return AdvertisedState::SICK;
+    }
+    if (state == "Zombie -1") {
+        return AdvertisedState::CAT;
+    }
+    return AdvertisedState::UNKNOWN;
+}
+
+/** @brief Reports heap allocations per classified device since @p before */
+void report_allocations(benchmark::State& state, std::size_t before, std::size_t devices) {
+    auto const count = allocations.load(std::memory_order_relaxed) - before;
+    state.counters["allocs_per_device"] =
+        static_cast<double>(count) / static_cast<double>(state.iterations() * devices);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(devices));
+}
+
+void BM_ClassifyName(benchmark::State& state) {
+    auto const names  = make_scan_names();
+    auto const before = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        for (auto const& name : names) {
+            benchmark::DoNotOptimize(classify_name(name.data(), name.size()));
+        }
+    }
+    report_allocations(state, before, names.size());
+}
+BENCHMARK(BM_ClassifyName);
+
+void BM_ClassifyNameWithStrings(benchmark::State& state) {
+    auto const names  = make_scan_names();
+    auto const before = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        for (auto const& scanned : names) {
+            // BLEAdvertisedDevice::getName() returns a copy of the name
+            std::string const name = scanned;
+            benchmark::DoNotOptimize(classify_name_with_strings(name));
+        }
+    }
+    report_allocations(state, before, names.size());
+}
+BENCHMARK(BM_ClassifyNameWithStrings);
+
+void BM_ClassifyAdvertisement(benchmark::State& state) {
+    // Flags followed by the complete local name, as a monitor advertises
+    std::vector<std::vector<std::uint8_t>> payloads;
+    for (auto const& name : make_scan_names()) {
+        std::vector<std::uint8_t> payload{0x02, 0x01, 0x06};
+        payload.push_back(static_cast<std::uint8_t>(name.size() + 1));
+        payload.push_back(0x09);
+        payload.insert(payload.end(), name.begin(), name.end());
+        payloads.push_back(payload);
+    }
+
+    auto const before = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        for (auto const& payload : payloads) {
+            benchmark::DoNotOptimize(classify_advertisement(payload.data(), payload.size()));
+        }
+    }
+    report_allocations(state, before, payloads.size());
+}
+BENCHMARK(BM_ClassifyAdvertisement);
+
+void BM_ClassifyBinaryAdvertisement(benchmark::State& state) {
+    // Flags followed by manufacturer data, as a monitor advertises since the binary codec
+    std::vector<std::vector<std::uint8_t>> payloads;
+    for (auto s = static_cast<int>(AdvertisedState::IMMUNE);
+         s <= static_cast<int>(AdvertisedState::CAT);
+         ++s) {
+        std::vector<std::uint8_t> payload{0x02, 0x01, 0x06, kManufacturerDataSize + 1, 0xFF};
+        payload.resize(payload.size() + kManufacturerDataSize);
+        encode_manufacturer_data(static_cast<AdvertisedState>(s),
+                                 to_health(StateBounds::HEALTHY),
+                                 payload.data() + payload.size() - kManufacturerDataSize);
+        payloads.push_back(payload);
+    }
+
+    auto const before = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        for (auto const& payload : payloads) {
+            benchmark::DoNotOptimize(classify_advertisement(payload.data(), payload.size()));
+        }
+    }
+    report_allocations(state, before, payloads.size());
+}
+BENCHMARK(BM_ClassifyBinaryAdvertisement);
+
+//// Streaming scan /////////////////////////////////////////////////////
+
+/** @returns a crowded scan: mostly healthy monitors, a few infected, and other devices */
+ScanTrace make_scan_trace() {
+    std::mt19937 rng{3};
+    std::uniform_int_distribution<int> rssi{-90, -40};
+    std::uniform_int_distribution<int> kind{0, 9};
+    ScanTrace trace;
+    for (int i = 0; i < 64; ++i) {
+        auto const k = kind(rng);
+        if (k < 7) {
+            auto const state = k < 5 ? AdvertisedState::HEALTHY
+                               : k < 6 ? AdvertisedState::SICK
+                                       : AdvertisedState::CAT;
+            std::uint8_t payload[5 + kManufacturerDataSize] = {
+                0x02, 0x01, 0x06, kManufacturerDataSize + 1, 0xFF};
+            encode_manufacturer_data(state, to_health(StateBounds::HEALTHY), payload + 5);
+            trace.add(static_cast<ble_address_t>(i), rssi(rng), payload, sizeof(payload));
+        } else {
+            // Another vendor's manufacturer data
+            std::uint8_t const payload[] = {
+                0x02, 0x01, 0x1A, 0x0B, 0xFF, 0x4C, 0x00, 0x10, 0x06, 0x31, 0x1D, 0x8E, 0x2A, 0x77};
+            trace.add(static_cast<ble_address_t>(i), rssi(rng), payload, sizeof(payload));
+        }
+    }
+    return trace;
+}
+
+/** @brief Scan as the firmware did it before @c scan_exposure: keep every result, then count */
+ExposureEvent collect_then_count(ScanTrace& trace) {
+    struct Result {
+        int rssi;
+        std::vector<std::uint8_t> payload;
+    };
+    std::vector<Result> results;
+    auto const collect = [&results](ble_address_t,
+                                    int rssi,
+                                    std::uint8_t const* payload,
+                                    std::size_t length) {
+        results.push_back(Result{rssi, std::vector<std::uint8_t>(payload, payload + length)});
+        return true;
+    };
+    trace.scan(SCAN_SECONDS, collect);
+
+    ExposureEvent exposure;
+    for (auto const& result : results) {
+        if (is_close(result.rssi)) {
+            auto const state = classify_advertisement(result.payload.data(), result.payload.size());
+            exposure.human += is_infected_human(state) ? 1 : 0;
+            exposure.cat += is_cat(state) ? 1 : 0;
+        }
+    }
+    return exposure;
+}
+
+void BM_ScanCollectThenCount(benchmark::State& state) {
+    auto trace = make_scan_trace();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(collect_then_count(trace));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(trace.size()));
+}
+BENCHMARK(BM_ScanCollectThenCount);
+
+// Healthy and scanning the whole trace, close to zombie so it stops early, and immune
+void BM_ScanExposure(benchmark::State& state) {
+    auto trace = make_scan_trace();
+    HealthState const health{static_cast<health_t>(state.range(0))};
+    std::size_t delivered = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scan_exposure(trace, SCAN_SECONDS, health));
+        delivered += trace.delivered();
+    }
+    state.counters["delivered"] =
+        static_cast<double>(delivered) / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(trace.size()));
+}
+BENCHMARK(BM_ScanExposure)->Arg(12)->Arg(38)->Arg(1);
+
+//// Unique contacts ////////////////////////////////////////////////////
+
+/** @returns addresses of @p contacts devices each heard three times, in shuffled order */
+std::vector<ble_address_t> make_sightings(std::size_t contacts) {
+    std::mt19937_64 rng{9};
+    std::vector<ble_address_t> sightings;
+    for (std::size_t i = 0; i < contacts; ++i) {
+        // Espressif OUI with a random device part, as monitors advertise
+        auto const address = 0x240AC4000000ULL | (rng() & 0xFFFFFF);
+        sightings.insert(sightings.end(), 3, address);
+    }
+    std::shuffle(sightings.begin(), sightings.end(), rng);
+    return sightings;
+}
+
+// One scan: clear the set, then record every sighting
+void BM_ContactSetScan(benchmark::State& state) {
+    auto const sightings = make_sightings(static_cast<std::size_t>(state.range(0)));
+    contact_set<2048> contacts;
+    for (auto _ : state) {
+        contacts.clear();
+        for (auto const address : sightings) {
+            benchmark::DoNotOptimize(contacts.insert(address, -60));
+        }
+    }
+    state.counters["contacts"] = static_cast<double>(contacts.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(sightings.size()));
+}
+BENCHMARK(BM_ContactSetScan)->Arg(10)->Arg(100)->Arg(1000);
+
+//// Event queues ///////////////////////////////////////////////////////
+
+template <std::size_t Depth>
+void BM_StaticRingBufferEach(benchmark::State& state) {
+    static_ring_buffer<Event, Depth> buffer;
+    Event const event{ExposureEvent{1, 0}};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < Depth; ++i) {
+            buffer.emplace_back(event);
+        }
+        for (std::size_t i = 0; i < Depth; ++i) {
+            benchmark::DoNotOptimize(buffer.front());
+            buffer.pop_front();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * Depth);
+}
+BENCHMARK_TEMPLATE(BM_StaticRingBufferEach, 4);
+BENCHMARK_TEMPLATE(BM_StaticRingBufferEach, 16);
+BENCHMARK_TEMPLATE(BM_StaticRingBufferEach, 64);
+BENCHMARK_TEMPLATE(BM_StaticRingBufferEach, 100);
+
+template <std::size_t Depth>
+void BM_StaticRingBufferBulk(benchmark::State& state) {
+    static_ring_buffer<Event, Depth> buffer;
+    std::array<Event, Depth> in;
+    std::array<Event, Depth> out;
+    in.fill(Event{ExposureEvent{1, 0}});
+    for (auto _ : state) {
+        buffer.push_n(in.begin(), Depth);
+        buffer.drain_into(out.begin());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * Depth);
+}
+BENCHMARK_TEMPLATE(BM_StaticRingBufferBulk, 4);
+BENCHMARK_TEMPLATE(BM_StaticRingBufferBulk, 16);
+BENCHMARK_TEMPLATE(BM_StaticRingBufferBulk, 64);
+BENCHMARK_TEMPLATE(BM_StaticRingBufferBulk, 100);
+
+template <std::size_t Depth>
+void BM_SpscRingBufferEach(benchmark::State& state) {
+    spsc_ring_buffer<Event, Depth> buffer;
+    Event const event{ExposureEvent{1, 0}};
+    Event out;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < Depth; ++i) {
+            buffer.try_emplace_back(event);
+        }
+        for (std::size_t i = 0; i < Depth; ++i) {
+            buffer.try_pop_front(out);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * Depth);
+}
+BENCHMARK_TEMPLATE(BM_SpscRingBufferEach, 4);
+BENCHMARK_TEMPLATE(BM_SpscRingBufferEach, 16);
+BENCHMARK_TEMPLATE(BM_SpscRingBufferEach, 64);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,207 @@
+// Throughput comparison of static_ring_buffer and spsc_ring_buffer
+//
+// Reports millions of Events moved per second for:
+//  - one thread pushing and popping in batches (no contention), one at a
+//    time and with push_n/drain_into, for each static_ring_buffer error policy
+//    and for the previous bool SafeMode buffer
+//  - a producer thread and a consumer thread, using a mutex around
+//    static_ring_buffer versus the lock-free spsc_ring_buffer
+
+// C++ Standard Library
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// Superspreader
+#include "health_monitor_core.h"
+#include "safe_mode_ring_buffer.h"
+#include "spsc_ring_buffer.h"
+#include "static_ring_buffer.h"
+
+namespace {
+
+constexpr std::size_t kCapacity = 64;
+constexpr std::size_t kBatch    = 16;
+constexpr std::size_t kEvents   = 20000000;
+
+template <typename F>
+double events_per_second(F&& run) {
+    auto const start = std::chrono::steady_clock::now();
+    auto const moved = run();
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(moved) / elapsed;
+}
+
+health_t sink = 0;
+
+std::array<Event, kBatch> make_batch() {
+    std::array<Event, kBatch> batch;
+    for (std::size_t j = 0; j < kBatch; ++j) {
+        batch[j] = Event{ExposureEvent{static_cast<health_t>(j), 0}};
+    }
+    return batch;
+}
+
+// Producer and consumer sides are kept out of line, as they are in real code,
+// so the compiler cannot forward values straight from push to pop
+template <typename BufferT>
+__attribute__((noinline)) void push_each(BufferT& buffer, Event const* events) {
+    for (std::size_t j = 0; j < kBatch; ++j) {
+        buffer.emplace_back(events[j]);
+    }
+}
+
+template <typename BufferT>
+__attribute__((noinline)) void pop_each(BufferT& buffer, Event* events) {
+    for (std::size_t j = 0; j < kBatch; ++j) {
+        events[j] = buffer.front();
+        buffer.pop_front();
+    }
+}
+
+template <typename BufferT>
+__attribute__((noinline)) void push_bulk(BufferT& buffer, Event const* events) {
+    buffer.push_n(events, kBatch);
+}
+
+template <typename BufferT>
+__attribute__((noinline)) void pop_bulk(BufferT& buffer, Event* events) {
+    buffer.drain_into(events, kBatch);
+}
+
+template <typename ErrorPolicy>
+using policy_buffer = static_ring_buffer<Event, kCapacity, ErrorPolicy>;
+
+using safe_mode_buffer = safe_mode_ring_buffer<Event, kCapacity>;
+
+template <typename BufferT>
+std::size_t single_thread_static() {
+    BufferT buffer;
+    auto const batch = make_batch();
+    Event drained[kBatch];
+    for (std::size_t i = 0; i < kEvents; i += kBatch) {
+        push_each(buffer, batch.data());
+        pop_each(buffer, drained);
+        sink += drained[i % kBatch].data.exposure.human;
+    }
+    return kEvents;
+}
+
+template <typename BufferT>
+std::size_t single_thread_static_bulk() {
+    BufferT buffer;
+    auto const batch = make_batch();
+    Event drained[kBatch];
+    for (std::size_t i = 0; i < kEvents; i += kBatch) {
+        push_bulk(buffer, batch.data());
+        pop_bulk(buffer, drained);
+        sink += drained[i % kBatch].data.exposure.human;
+    }
+    return kEvents;
+}
+
+std::size_t single_thread_spsc() {
+    spsc_ring_buffer<Event, kCapacity> buffer;
+    Event event;
+    for (std::size_t i = 0; i < kEvents; i += kBatch) {
+        for (std::size_t j = 0; j < kBatch; ++j) {
+            buffer.try_emplace_back(ExposureEvent{static_cast<health_t>(j), 0});
+        }
+        for (std::size_t j = 0; j < kBatch; ++j) {
+            buffer.try_pop_front(event);
+            sink += event.data.exposure.human;
+        }
+    }
+    return kEvents;
+}
+
+std::size_t two_threads_static_mutex() {
+    static_ring_buffer<Event, kCapacity> buffer;
+    std::mutex mutex;
+
+    std::thread producer{[&buffer, &mutex]() {
+        for (std::size_t i = 0; i < kEvents;) {
+            std::unique_lock<std::mutex> lock{mutex};
+            if (buffer.size() < kCapacity) {
+                buffer.emplace_back(ExposureEvent{static_cast<health_t>(i), 0});
+                ++i;
+            } else {
+                lock.unlock();
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    for (std::size_t i = 0; i < kEvents;) {
+        std::unique_lock<std::mutex> lock{mutex};
+        if (!buffer.empty()) {
+            sink += buffer.front().data.exposure.human;
+            buffer.pop_front();
+            ++i;
+        } else {
+            lock.unlock();
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    return kEvents;
+}
+
+std::size_t two_threads_spsc() {
+    spsc_ring_buffer<Event, kCapacity> buffer;
+
+    std::thread producer{[&buffer]() {
+        for (std::size_t i = 0; i < kEvents;) {
+            if (buffer.try_emplace_back(ExposureEvent{static_cast<health_t>(i), 0})) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    Event event;
+    for (std::size_t i = 0; i < kEvents;) {
+        if (buffer.try_pop_front(event)) {
+            sink += event.data.exposure.human;
+            ++i;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    return kEvents;
+}
+
+/** @brief Prints one result row of millions of events per second */
+template <typename F>
+void print_row(char const* name, F&& run) {
+    std::printf("%-36s %10.1f\n", name, events_per_second(run) / 1e6);
+}
+
+}  // namespace
+
+int main() {
+    std::printf("%-36s %10s\n", "case", "Mevents/s");
+    print_row("single thread, static_ring_buffer",
+              single_thread_static<policy_buffer<ring_buffer_default_policy>>);
+    print_row("  returning status",
+              single_thread_static<policy_buffer<ring_buffer_returns_status>>);
+    print_row("  asserting", single_thread_static<policy_buffer<ring_buffer_asserts>>);
+    print_row("  unchecked", single_thread_static<policy_buffer<ring_buffer_unchecked>>);
+    print_row("  previous SafeMode buffer", single_thread_static<safe_mode_buffer>);
+    print_row("single thread, static_ring_buffer bulk",
+              single_thread_static_bulk<policy_buffer<ring_buffer_default_policy>>);
+    print_row("  returning status",
+              single_thread_static_bulk<policy_buffer<ring_buffer_returns_status>>);
+    print_row("  asserting", single_thread_static_bulk<policy_buffer<ring_buffer_asserts>>);
+    print_row("  unchecked", single_thread_static_bulk<policy_buffer<ring_buffer_unchecked>>);
+    print_row("  previous SafeMode buffer", single_thread_static_bulk<safe_mode_buffer>);
+    print_row("single thread, spsc_ring_buffer", single_thread_spsc);
+    print_row("two threads, static_ring_buffer+mutex", two_threads_static_mutex);
+    print_row("two threads, spsc_ring_buffer", two_threads_spsc);
+    return sink == 0xdeadbeef;
+}
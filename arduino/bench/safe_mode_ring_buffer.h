@@ -0,0 +1,239 @@
+// Event queue as it was before static_ring_buffer took an error policy, kept
+// only so the benchmarks can compare the policies against it
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Previous @c static_ring_buffer, which threw when @p SafeMode and
+ *        destroyed every value as it was removed
+ */
+template <typename ValueT, std::size_t N, bool SafeMode = true>
+class safe_mode_ring_buffer {
+    static_assert(N > 0, "effective size of ring buffer must be > 0");
+
+    // Wrapping uses a mask instead of a compare when the capacity allows it
+    static constexpr bool kPowerOfTwo = (N & (N - 1)) == 0;
+
+   public:
+    using value_type = ValueT;
+    using size_type  = std::size_t;
+
+    /** @brief Contiguous run of stored values */
+    template <typename PointerT>
+    struct basic_segment {
+        PointerT data;
+        std::size_t size;
+
+        constexpr PointerT begin() const { return data; }
+        constexpr PointerT end() const { return data + size; }
+        constexpr bool empty() const { return size == 0; }
+    };
+
+    using segment       = basic_segment<ValueT*>;
+    using const_segment = basic_segment<ValueT const*>;
+
+    /**
+     * @brief Readable region, oldest values first
+     * @note @c second is empty unless the stored values wrap around the end of the buffer
+     */
+    template <typename SegmentT>
+    struct basic_segments {
+        SegmentT first;
+        SegmentT second;
+    };
+
+    using segments       = basic_segments<segment>;
+    using const_segments = basic_segments<const_segment>;
+
+    /** @brief Iterates stored values from oldest to newest */
+    class const_iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = ValueT;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = ValueT const*;
+        using reference         = ValueT const&;
+
+        constexpr const_iterator() : buffer_{nullptr}, offset_{0} {}
+
+        reference operator*() const { return buffer_->at_offset(offset_); }
+        pointer operator->() const { return &buffer_->at_offset(offset_); }
+
+        const_iterator& operator++() {
+            ++offset_;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto const previous = *this;
+            ++offset_;
+            return previous;
+        }
+
+        constexpr bool operator==(const_iterator const& other) const {
+            return buffer_ == other.buffer_ && offset_ == other.offset_;
+        }
+        constexpr bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+       private:
+        friend class safe_mode_ring_buffer;
+
+        constexpr const_iterator(safe_mode_ring_buffer const* buffer, std::size_t offset)
+            : buffer_{buffer}, offset_{offset} {}
+
+        safe_mode_ring_buffer const* buffer_;
+        std::size_t offset_;
+    };
+
+    // Constant-initialized with static storage, so a buffer can live in RTC memory
+    constexpr safe_mode_ring_buffer() : rd_{0}, buffer_{}, size_{0} {}
+
+    ~safe_mode_ring_buffer() {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+
+    constexpr bool empty() const { return size_ == 0; }
+
+    constexpr bool full() const { return size_ == N; }
+
+    constexpr std::size_t size() const { return size_; }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if /*constexpr*/ (SafeMode) {
+            if (size_ == N) {
+                throw std::range_error{"adding value would exceed max container capacity"};
+            }
+        }
+        new (data() + wrap(rd_ + size_)) ValueT{std::forward<Args>(args)...};
+        ++size_;
+    }
+
+    ValueT& front() { return data()[rd_]; }
+
+    ValueT const& front() const { return data()[rd_]; }
+
+    void pop_front() {
+        if /*constexpr*/ (SafeMode) {
+            if (size_ == 0) {
+                throw std::range_error{"container is already empty"};
+            }
+        }
+        data()[rd_].~ValueT();
+        rd_ = wrap(rd_ + 1);
+        --size_;
+    }
+
+    /**
+     * @brief Copies @p count values to the back of the buffer
+     * @param first Iterator to the first value to copy
+     * @param count Number of values to copy
+     */
+    template <typename InputIt>
+    void push_n(InputIt first, std::size_t count) {
+        if /*constexpr*/ (SafeMode) {
+            if (count > N - size_) {
+                throw std::range_error{"adding values would exceed max container capacity"};
+            }
+        }
+        // Fill up to the end of the storage, then continue from the start
+        auto const wr   = wrap(rd_ + size_);
+        auto const head = count < N - wr ? count : N - wr;
+        for (std::size_t i = 0; i < head; ++i, ++first) {
+            new (data() + wr + i) ValueT{*first};
+        }
+        for (std::size_t i = 0; i < count - head; ++i, ++first) {
+            new (data() + i) ValueT{*first};
+        }
+        size_ += count;
+    }
+
+    /**
+     * @brief Moves up to @p max_count values, oldest first, to @p out and removes them
+     * @param out Output iterator to write values to
+     * @param max_count Maximum number of values to move
+     * @returns @p out advanced past the last value written
+     */
+    template <typename OutputIt>
+    OutputIt drain_into(OutputIt out, std::size_t max_count = N) {
+        auto const count = size_ < max_count ? size_ : max_count;
+        auto const head  = count < N - rd_ ? count : N - rd_;
+        for (std::size_t i = 0; i < head; ++i, ++out) {
+            auto& value = data()[rd_ + i];
+            *out        = std::move(value);
+            value.~ValueT();
+        }
+        for (std::size_t i = 0; i < count - head; ++i, ++out) {
+            auto& value = data()[i];
+            *out        = std::move(value);
+            value.~ValueT();
+        }
+        rd_ = wrap(rd_ + count);
+        size_ -= count;
+        return out;
+    }
+
+    /**
+     * @brief Removes the @p count oldest values, for use after processing @c readable() in place
+     * @param count Number of values to remove
+     */
+    void consume(std::size_t count) {
+        if /*constexpr*/ (SafeMode) {
+            if (count > size_) {
+                throw std::range_error{"container holds fewer values than requested"};
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            data()[rd_].~ValueT();
+            rd_ = wrap(rd_ + 1);
+        }
+        size_ -= count;
+    }
+
+    /** @returns the stored values as at most two contiguous segments, oldest first */
+    segments readable() {
+        auto const head = size_ < N - rd_ ? size_ : N - rd_;
+        return segments{segment{data() + rd_, head}, segment{data(), size_ - head}};
+    }
+
+    /** @returns the stored values as at most two contiguous segments, oldest first */
+    const_segments readable() const {
+        auto const head = size_ < N - rd_ ? size_ : N - rd_;
+        return const_segments{const_segment{data() + rd_, head},
+                              const_segment{data(), size_ - head}};
+    }
+
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{this, size_}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+   private:
+    /** @returns @p index wrapped into the storage, for any @p index < 2 * N */
+    static constexpr std::size_t wrap(std::size_t index) {
+        if /*constexpr*/ (kPowerOfTwo) {
+            return index & (N - 1);
+        }
+        return index >= N ? index - N : index;
+    }
+
+    ValueT* data() { return reinterpret_cast<ValueT*>(buffer_); }
+    ValueT const* data() const { return reinterpret_cast<ValueT const*>(buffer_); }
+
+    ValueT const& at_offset(std::size_t offset) const { return data()[wrap(rd_ + offset)]; }
+
+    std::size_t rd_;
+    alignas(ValueT) std::uint8_t buffer_[N * sizeof(ValueT)];
+    std::size_t size_;
+};
@@ -0,0 +1,37 @@
+// Wake-queue pattern of run_wake_cycle, built once per event queue so
+// compare_code_size can track what each one costs at -Os
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+/**
+ * @brief Queues a treatment, then moves @p pending into a 4 event queue as it has
+ *        room and polls it empty, as @c run_wake_cycle does with ISR presses
+ * @param pending events waiting in the interrupt queue
+ * @param count number of @p pending events
+ * @param out receives the polled events, at least @p count + 1 of them
+ * @returns number of events written to @p out
+ */
+template <typename QueueT>
+std::size_t poll_wake_queue(Event const* pending, std::size_t count, Event* out) {
+    QueueT event_queue;
+    event_queue.emplace_back(TreatmentEvent{});
+
+    std::size_t next   = 0;
+    std::size_t polled = 0;
+    for (;;) {
+        while (next < count && !event_queue.full()) {
+            event_queue.emplace_back(pending[next++]);
+        }
+        if (event_queue.empty()) {
+            return polled;
+        }
+        out[polled++] = event_queue.front();
+        event_queue.pop_front();
+    }
+}
@@ -0,0 +1,10 @@
+// Wake queue on the previous bool SafeMode buffer, as a code size reference
+
+// Superspreader
+#include "safe_mode_ring_buffer.h"
+#include "wake_queue_pattern.h"
+
+std::size_t poll_wake_queue_safe_mode(Event const* pending, std::size_t count, Event* out) {
+    using QueueT = safe_mode_ring_buffer<Event, 4>;
+    return poll_wake_queue<QueueT>(pending, count, out);
+}
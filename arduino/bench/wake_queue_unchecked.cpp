@@ -0,0 +1,10 @@
+// Wake queue on an unchecked static_ring_buffer
+
+// Superspreader
+#include "static_ring_buffer.h"
+#include "wake_queue_pattern.h"
+
+std::size_t poll_wake_queue_unchecked(Event const* pending, std::size_t count, Event* out) {
+    using QueueT = static_ring_buffer<Event, 4, ring_buffer_unchecked>;
+    return poll_wake_queue<QueueT>(pending, count, out);
+}
@@ -0,0 +1,13 @@
+project(benchmark-download NONE)
+
+include(ExternalProject)
+ExternalProject_Add(benchmark
+  GIT_REPOSITORY    https://github.com/google/benchmark.git
+  GIT_TAG           v1.7.1
+  SOURCE_DIR        "${CMAKE_CURRENT_BINARY_DIR}/benchmark-src"
+  BINARY_DIR        "${CMAKE_CURRENT_BINARY_DIR}/benchmark-build"
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND     ""
+  INSTALL_COMMAND   ""
+  TEST_COMMAND      ""
+)
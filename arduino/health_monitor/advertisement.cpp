@@ -0,0 +1,155 @@
+// Superspreader
+#include "advertisement.h"
+
+namespace {
+
+/** @brief Text advertised after the prefix for one state */
+struct DisplayName {
+    char const* text;
+    std::size_t length;
+    AdvertisedState state;
+};
+
+// Indexed by AdvertisedState
+constexpr DisplayName kDisplayNames[] = {
+    {"", 0, AdvertisedState::UNKNOWN},
+    {"Immune", 6, AdvertisedState::IMMUNE},
+    {"Super Healthy", 13, AdvertisedState::SUPER_HEALTHY},
+    {"Healthy", 7, AdvertisedState::HEALTHY},
+    {"Asymptomatic", 12, AdvertisedState::ASYMPTOMATIC},
+    {"Sick", 4, AdvertisedState::SICK},
+    {"Zombie", 6, AdvertisedState::ZOMBIE},
+    {"Zombie -1", 9, AdvertisedState::CAT},
+};
+
+constexpr std::size_t kNumDisplayNames = sizeof(kDisplayNames) / sizeof(kDisplayNames[0]);
+
+/** @returns true if the first @p length characters of @p a and @p b match */
+constexpr bool equal(char const* a, char const* b, std::size_t length) {
+    for (std::size_t i = 0; i < length; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+/** @returns number of characters before the terminator of @p text */
+constexpr std::size_t length_of(char const* text) {
+    std::size_t length = 0;
+    while (text[length] != '\0') ++length;
+    return length;
+}
+
+constexpr bool display_names_consistent() {
+    for (std::size_t i = 0; i < kNumDisplayNames; ++i) {
+        if (static_cast<std::size_t>(kDisplayNames[i].state) != i ||
+            length_of(kDisplayNames[i].text) != kDisplayNames[i].length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(display_names_consistent(), "display names must be indexed by state");
+
+// AD types, from the Bluetooth assigned numbers
+constexpr std::uint8_t kShortenedLocalName = 0x08;
+constexpr std::uint8_t kCompleteLocalName  = 0x09;
+constexpr std::uint8_t kManufacturerData   = 0xFF;
+
+static_assert(static_cast<std::size_t>(AdvertisedState::CAT) < 16,
+              "state must fit in the low nibble of the header byte");
+
+}  // namespace
+
+AdvertisedState to_advertised_state(health_t health) {
+    if (is_immune(health)) {
+        return AdvertisedState::IMMUNE;
+    } else if (is_super_healthy(health)) {
+        return AdvertisedState::SUPER_HEALTHY;
+    } else if (is_healthy(health)) {
+        return AdvertisedState::HEALTHY;
+    } else if (is_infected_asym(health)) {
+        return AdvertisedState::ASYMPTOMATIC;
+    } else if (is_infected(health)) {
+        return AdvertisedState::SICK;
+    }
+    return AdvertisedState::ZOMBIE;
+}
+
+char const* to_display_name(AdvertisedState state) {
+    auto const index = static_cast<std::size_t>(state);
+    return index < kNumDisplayNames ? kDisplayNames[index].text : "";
+}
+
+AdvertisedState classify_name(char const* name, std::size_t length) {
+    if (length <= kMonitorPrefixLength || !equal(name, kMonitorPrefix, kMonitorPrefixLength)) {
+        return AdvertisedState::UNKNOWN;
+    }
+
+    // Names differ in length except "Immune" and "Zombie", so at most two are compared in full
+    auto const* const state_name = name + kMonitorPrefixLength;
+    auto const state_length      = length - kMonitorPrefixLength;
+    for (std::size_t i = 1; i < kNumDisplayNames; ++i) {
+        auto const& candidate = kDisplayNames[i];
+        if (candidate.length == state_length &&
+            equal(state_name, candidate.text, state_length)) {
+            return candidate.state;
+        }
+    }
+    return AdvertisedState::UNKNOWN;
+}
+
+void encode_manufacturer_data(AdvertisedState state, health_t health, std::uint8_t* out) {
+    auto const clamped = health < to_health(StateBounds::ZOMBIE) ? health
+                                                                 : to_health(StateBounds::ZOMBIE);
+    out[0] = static_cast<std::uint8_t>(kManufacturerId & 0xFF);
+    out[1] = static_cast<std::uint8_t>(kManufacturerId >> 8);
+    out[2] = kAdvertisementMagic;
+    out[3] = static_cast<std::uint8_t>(kAdvertisementVersion << 4 | static_cast<int>(state));
+    out[4] = static_cast<std::uint8_t>(clamped);
+}
+
+DecodedAdvertisement decode_manufacturer_data(std::uint8_t const* data, std::size_t length) {
+    if (length < kManufacturerDataSize) {
+        return DecodedAdvertisement{};
+    }
+
+    // Every field is checked without branching, then the result is masked
+    auto const company = static_cast<std::uint16_t>(data[0] | data[1] << 8);
+    auto const version = data[3] >> 4;
+    auto const state   = data[3] & 0x0Fu;
+    auto const health  = static_cast<health_t>(data[4]);
+    bool const valid   = (company == kManufacturerId) & (data[2] == kAdvertisementMagic) &
+                       (version == kAdvertisementVersion) &
+                       (state - 1u < static_cast<unsigned>(AdvertisedState::CAT)) &
+                       (health <= to_health(StateBounds::ZOMBIE));
+
+    DecodedAdvertisement decoded;
+    decoded.state  = static_cast<AdvertisedState>(state * valid);
+    decoded.health = health * valid;
+    return decoded;
+}
+
+AdvertisedState classify_advertisement(std::uint8_t const* payload, std::size_t length) {
+    std::size_t offset = 0;
+    while (offset < length) {
+        // Each AD structure is [length][type][length - 1 bytes of data]
+        auto const field_length = payload[offset];
+        if (field_length == 0 || field_length > length - offset - 1) {
+            break;  // padding or truncated structure
+        }
+        auto const type  = payload[offset + 1];
+        auto const* data = payload + offset + 2;
+        auto state       = AdvertisedState::UNKNOWN;
+        if (type == kManufacturerData) {
+            state = decode_manufacturer_data(data, field_length - 1u).state;
+        } else if (type == kCompleteLocalName || type == kShortenedLocalName) {
+            state = classify_name(reinterpret_cast<char const*>(data), field_length - 1u);
+        }
+        if (state != AdvertisedState::UNKNOWN) {
+            return state;
+        }
+        offset += field_length + 1u;
+    }
+    return AdvertisedState::UNKNOWN;
+}
@@ -0,0 +1,111 @@
+// Classifies what nearby devices advertise, without allocating
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+/** @file **/
+
+/** @brief Prefix of the device name of every health monitor and cat */
+constexpr char kMonitorPrefix[] = "HM - ";
+
+/** @brief Length of @c kMonitorPrefix, excluding the terminator */
+constexpr std::size_t kMonitorPrefixLength = sizeof(kMonitorPrefix) - 1;
+
+/**
+ * @brief State another device advertises, as seen by a scanning monitor
+ * @note The advertised states are coarser than @c StateBounds: every
+ *       symptomatic player advertises @c SICK
+ */
+enum struct AdvertisedState : std::uint8_t {
+    UNKNOWN       = 0, /**< Not a health monitor, or an unrecognised state */
+    IMMUNE        = 1,
+    SUPER_HEALTHY = 2,
+    HEALTHY       = 3,
+    ASYMPTOMATIC  = 4,
+    SICK          = 5,
+    ZOMBIE        = 6,
+    CAT           = 7,
+};
+
+/**
+ * @brief State advertised in binary form, with the exact health of the sender
+ * @note @c state is @c AdvertisedState::UNKNOWN and @c health is 0 if decoding failed
+ */
+struct DecodedAdvertisement {
+    AdvertisedState state = AdvertisedState::UNKNOWN;
+    health_t health       = 0;
+};
+
+/**
+ * @brief Manufacturer specific data layout, version 1
+ * @code
+ *      byte 0-1  company identifier, little endian (0xFFFF, reserved for testing)
+ *      byte 2    kAdvertisementMagic
+ *      byte 3    version << 4 | AdvertisedState
+ *      byte 4    health, clamped to StateBounds::ZOMBIE
+ * @endcode
+ * Decoders accept longer data so later minor additions can append fields, and
+ * reject any other version.
+ */
+constexpr std::uint16_t kManufacturerId      = 0xFFFF;
+constexpr std::uint8_t kAdvertisementMagic   = 0x5A;
+constexpr std::uint8_t kAdvertisementVersion = 1;
+constexpr std::size_t kManufacturerDataSize  = 5;
+
+/** @returns true if @p state counts towards @c ExposureEvent::human */
+constexpr bool is_infected_human(AdvertisedState state) {
+    return state == AdvertisedState::ASYMPTOMATIC || state == AdvertisedState::SICK ||
+           state == AdvertisedState::ZOMBIE;
+}
+
+/** @returns true if @p state counts towards @c ExposureEvent::cat */
+constexpr bool is_cat(AdvertisedState state) { return state == AdvertisedState::CAT; }
+
+/** @returns state a player with @p health advertises */
+AdvertisedState to_advertised_state(health_t health);
+
+/**
+ * @returns text advertised after @c kMonitorPrefix for @p state, such as "Sick",
+ *          or an empty string for @c AdvertisedState::UNKNOWN
+ */
+char const* to_display_name(AdvertisedState state);
+
+/**
+ * @brief Classifies a device name such as "HM - Sick" in a single pass
+ * @param name Device name, need not be null terminated
+ * @param length Number of characters in @p name
+ * @returns advertised state, or @c AdvertisedState::UNKNOWN if @p name is not a monitor
+ */
+AdvertisedState classify_name(char const* name, std::size_t length);
+
+/**
+ * @brief Packs a state into manufacturer specific data
+ * @param state State to advertise
+ * @param health Health of the sender
+ * @param out Receives @c kManufacturerDataSize bytes, including the company identifier
+ */
+void encode_manufacturer_data(AdvertisedState state, health_t health, std::uint8_t* out);
+
+/**
+ * @brief Unpacks manufacturer specific data written by @c encode_manufacturer_data
+ * @param data Manufacturer specific data, starting with the company identifier
+ * @param length Number of bytes in @p data
+ * @returns decoded state, with @c AdvertisedState::UNKNOWN if @p data is not ours
+ */
+DecodedAdvertisement decode_manufacturer_data(std::uint8_t const* data, std::size_t length);
+
+/**
+ * @brief Classifies a raw BLE advertisement by its manufacturer data or local name
+ * @param payload Advertising data, a sequence of length-type-value AD structures
+ * @param length Number of bytes in @p payload
+ * @returns state of the first structure that is recognised, or @c AdvertisedState::UNKNOWN
+ * @note Binary manufacturer data and text names are both accepted, so monitors
+ *       running older firmware are still counted
+ */
+AdvertisedState classify_advertisement(std::uint8_t const* payload, std::size_t length);
@@ -0,0 +1,131 @@
+// Fixed-capacity set of BLE addresses heard during one scan
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+
+/** @file **/
+
+/** @brief 48-bit BLE device address, in the low bits */
+using ble_address_t = std::uint64_t;
+
+/**
+ * @brief Packs a BLE address as stored by the ESP32 stack, most significant byte first
+ * @param bytes six address bytes
+ * @returns address in the low 48 bits
+ */
+constexpr ble_address_t to_ble_address(std::uint8_t const* bytes) {
+    return static_cast<ble_address_t>(bytes[0]) << 40 |
+           static_cast<ble_address_t>(bytes[1]) << 32 |
+           static_cast<ble_address_t>(bytes[2]) << 24 |
+           static_cast<ble_address_t>(bytes[3]) << 16 |
+           static_cast<ble_address_t>(bytes[4]) << 8 |
+           static_cast<ble_address_t>(bytes[5]);
+}
+
+/** @brief Signal aggregated over every advertisement from one address */
+struct Contact {
+    std::int16_t rssi_sum;      /**< Sum of RSSI over @c sightings, in dBm */
+    std::int8_t strongest_rssi; /**< Strongest RSSI heard, in dBm */
+    std::uint8_t sightings;     /**< Advertisements heard, saturating at 255 */
+    bool counted;               /**< Free for the caller, false when first heard */
+
+    /** @returns mean RSSI in dBm */
+    int mean_rssi() const { return rssi_sum / sightings; }
+};
+
+/**
+ * @brief Open-addressing hash set of BLE addresses with per-address RSSI aggregation
+ *
+ * All storage is inline, so the set costs the same memory however many devices
+ * are heard, and never touches the heap. Lookups use linear probing and the table
+ * is kept at most three quarters full, so each advertisement costs O(1).
+ *
+ * @tparam Slots table size, a power of two; holds up to 3/4 of @p Slots addresses
+ */
+template <std::size_t Slots>
+class contact_set {
+    static_assert(Slots >= 4 && (Slots & (Slots - 1)) == 0, "slots must be a power of two >= 4");
+
+    // Never a 48-bit address
+    static constexpr ble_address_t kEmpty = ~ble_address_t{0};
+
+   public:
+    /** @returns most addresses the set holds */
+    static constexpr std::size_t capacity() { return Slots - Slots / 4; }
+
+    contact_set() { clear(); }
+
+    /** @brief Forgets every address, as at the start of a tick */
+    void clear() {
+        for (auto& address : addresses_) {
+            address = kEmpty;
+        }
+        size_    = 0;
+        dropped_ = 0;
+    }
+
+    /**
+     * @brief Records one advertisement from @p address
+     * @param address 48-bit device address
+     * @param rssi signal strength of this advertisement in dBm
+     * @returns aggregate for @p address, or nullptr if it is new and the set is full
+     */
+    Contact* insert(ble_address_t address, int rssi) {
+        auto const clamped = static_cast<std::int8_t>(rssi < -128 ? -128 : rssi > 127 ? 127 : rssi);
+        auto slot          = find_slot(address);
+        if (addresses_[slot] == kEmpty) {
+            if (size_ == capacity()) {
+                ++dropped_;
+                return nullptr;
+            }
+            addresses_[slot] = address;
+            contacts_[slot]  = Contact{clamped, clamped, 1, false};
+            ++size_;
+            return &contacts_[slot];
+        }
+
+        auto& contact = contacts_[slot];
+        if (contact.sightings < 255) {
+            contact.rssi_sum = static_cast<std::int16_t>(contact.rssi_sum + clamped);
+            ++contact.sightings;
+        }
+        if (clamped > contact.strongest_rssi) {
+            contact.strongest_rssi = clamped;
+        }
+        return &contact;
+    }
+
+    /** @returns aggregate for @p address, or nullptr if it was not heard */
+    Contact const* find(ble_address_t address) const {
+        auto const slot = find_slot(address);
+        return addresses_[slot] == kEmpty ? nullptr : &contacts_[slot];
+    }
+
+    /** @returns number of distinct addresses */
+    std::size_t size() const { return size_; }
+
+    /** @returns true if no address was heard */
+    bool empty() const { return size_ == 0; }
+
+    /** @returns advertisements from new addresses turned away because the set was full */
+    std::size_t dropped() const { return dropped_; }
+
+   private:
+    /** @returns slot holding @p address, or the empty slot where it belongs */
+    std::size_t find_slot(ble_address_t address) const {
+        // Fibonacci hashing: the upper half of the product mixes every address bit
+        auto slot = static_cast<std::size_t>((address * 0x9E3779B97F4A7C15ULL) >> 32) & (Slots - 1);
+        while (addresses_[slot] != kEmpty && addresses_[slot] != address) {
+            slot = (slot + 1) & (Slots - 1);
+        }
+        return slot;
+    }
+
+    ble_address_t addresses_[Slots];
+    Contact contacts_[Slots];
+    std::size_t size_    = 0;
+    std::size_t dropped_ = 0;
+};
@@ -0,0 +1,92 @@
+// C++ Standard Library
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Superspreader
+#include "event_log.h"
+
+namespace {
+
+constexpr char kRecordTag[]      = "event_log,";
+constexpr unsigned kRecordFormat = 1;
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+/** @returns value of hex digit @p c, or -1 */
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+PlayerState replay_event_log_record(EventLogRecord const& record) {
+    Event events[kLoggedEventsPerWake];
+    auto const count = record.event_count < kLoggedEventsPerWake ? record.event_count
+                                                                 : kLoggedEventsPerWake;
+    for (std::size_t i = 0; i < count; ++i) {
+        events[i] = unpack_event(record.events[i]);
+    }
+
+    PlayerState player;
+    player.tick          = static_cast<int>(record.tick) - 1;
+    player.health.health = record.start_health;
+    game_update(player, events, count, [](ExposureEvent const&) {}, [](TreatmentEvent const&) {});
+    return player;
+}
+
+bool verify_event_log_record(EventLogRecord const& record) {
+    if ((record.flags & kEventLogTruncated) != 0 || record.event_count > kLoggedEventsPerWake) {
+        return false;
+    }
+    auto const player = replay_event_log_record(record);
+    return player.health.health == record.end_health &&
+           static_cast<std::uint32_t>(player.tick) == record.tick;
+}
+
+std::size_t format_event_log_record(EventLogRecord const& record, char* out, std::size_t size) {
+    auto written = std::snprintf(out, size, "%s%u,", kRecordTag, kRecordFormat);
+    if (written <= 0 || static_cast<std::size_t>(written) + 2 * sizeof(record) >= size) {
+        return 0;
+    }
+
+    // Both the ESP32 and the host are little-endian, so the bytes are portable between them
+    auto const* bytes = reinterpret_cast<std::uint8_t const*>(&record);
+    for (std::size_t i = 0; i < sizeof(record); ++i) {
+        out[written++] = kHexDigits[bytes[i] >> 4];
+        out[written++] = kHexDigits[bytes[i] & 0x0F];
+    }
+    out[written] = '\0';
+    return static_cast<std::size_t>(written);
+}
+
+bool parse_event_log_record(char const* line, EventLogRecord& record) {
+    auto const* cursor = std::strstr(line, kRecordTag);
+    if (cursor == nullptr) {
+        return false;
+    }
+    cursor += sizeof(kRecordTag) - 1;
+
+    char* end         = nullptr;
+    auto const format = std::strtoul(cursor, &end, 10);
+    if (end == cursor || *end != ',' || format != kRecordFormat) {
+        return false;
+    }
+    cursor = end + 1;
+
+    EventLogRecord parsed;
+    auto* bytes = reinterpret_cast<std::uint8_t*>(&parsed);
+    for (std::size_t i = 0; i < sizeof(parsed); ++i) {
+        auto const high = hex_value(cursor[2 * i]);
+        auto const low  = high < 0 ? -1 : hex_value(cursor[2 * i + 1]);
+        if (low < 0) {
+            return false;
+        }
+        bytes[i] = static_cast<std::uint8_t>(high << 4 | low);
+    }
+    record = parsed;
+    return true;
+}
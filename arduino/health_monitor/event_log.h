@@ -0,0 +1,146 @@
+// Binary log of the events applied on each wake, kept across deep sleep
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Superspreader
+#include "health_monitor_core.h"
+#include "static_ring_buffer.h"
+
+/** @file **/
+
+/** @brief Wakes held in RTC memory before the log is flushed */
+constexpr std::size_t kEventLogSize = 32;
+
+/** @brief Events kept per wake: a treatment wake, the scan, and the two the ISR queue holds */
+constexpr std::size_t kLoggedEventsPerWake = 4;
+
+/** @brief Set in @c EventLogRecord::flags if the wake applied more events than were kept */
+constexpr std::uint8_t kEventLogTruncated = 0x01;
+
+/**
+ * @brief One @c Event in 2 bytes
+ *
+ * Type in bits 14-15, humans in bits 0-6 and cats in bits 7-13. Counts saturate
+ * at 127, far past the exposure that makes a zombie, so replay is unaffected.
+ */
+using logged_event_t = std::uint16_t;
+
+/** @returns @p event packed into a @c logged_event_t */
+inline logged_event_t pack_event(Event const& event) {
+    auto const saturate = [](health_t count) -> logged_event_t { return count < 127 ? count : 127; };
+    auto const type     = static_cast<logged_event_t>(static_cast<logged_event_t>(event.type) << 14);
+    if (event.type != Event::Type::EXPOSURE) {
+        return type;
+    }
+    return static_cast<logged_event_t>(type | saturate(event.data.exposure.human) |
+                                       saturate(event.data.exposure.cat) << 7);
+}
+
+/** @returns the @c Event packed into @p packed, invalid if the type is unknown */
+inline Event unpack_event(logged_event_t packed) {
+    switch (static_cast<Event::Type>(packed >> 14)) {
+        case Event::Type::EXPOSURE:
+            return Event{ExposureEvent{static_cast<health_t>(packed & 0x7F),
+                                       static_cast<health_t>((packed >> 7) & 0x7F)}};
+        case Event::Type::TREATMENT:
+            return Event{TreatmentEvent{}};
+        default:
+            return Event{};
+    }
+}
+
+/**
+ * @brief Everything one wake's @c game_update saw, in 16 bytes
+ *
+ * Replaying @c events from @c start_health with @c game_update gives @c end_health
+ * and @c tick, unless @c kEventLogTruncated is set.
+ */
+struct EventLogRecord {
+    std::uint32_t tick;                           /**< @c PlayerState::tick after the wake */
+    std::uint8_t start_health;                    /**< Health before @c game_update */
+    std::uint8_t end_health;                      /**< Health after @c game_update */
+    std::uint8_t event_count;                     /**< Entries used in @c events */
+    std::uint8_t flags;                           /**< @c kEventLogTruncated */
+    logged_event_t events[kLoggedEventsPerWake];  /**< Events in the order they were polled */
+};
+
+static_assert(std::is_trivial<EventLogRecord>::value, "records are copied as bytes");
+static_assert(sizeof(EventLogRecord) == 16, "records are packed");
+
+/**
+ * @brief Records of recent wakes, oldest first
+ * @note Constant-initialized, so it can live in @c RTC_DATA_ATTR memory
+ */
+using EventLog = static_ring_buffer<EventLogRecord, kEventLogSize, ring_buffer_unchecked>;
+
+/** @returns an empty record for a wake starting from @p player */
+inline EventLogRecord begin_event_log_record(PlayerState const& player) {
+    EventLogRecord record{};
+    record.start_health = static_cast<std::uint8_t>(player.health.health);
+    return record;
+}
+
+/** @brief Adds @p event, polled by @c game_update, to @p record */
+inline void log_event(EventLogRecord& record, Event const& event) {
+    if (record.event_count == kLoggedEventsPerWake) {
+        record.flags |= kEventLogTruncated;
+        return;
+    }
+    record.events[record.event_count++] = pack_event(event);
+}
+
+/** @brief Completes @p record with @p player as it is after @c game_update */
+inline void end_event_log_record(EventLogRecord& record, PlayerState const& player) {
+    record.tick       = static_cast<std::uint32_t>(player.tick);
+    record.end_health = static_cast<std::uint8_t>(player.health.health);
+}
+
+/**
+ * @brief Appends @p record to @p log, dropping the oldest record if it is full
+ * @returns true if @p log is full afterwards and due to be flushed
+ */
+inline bool append_event_log(EventLog& log, EventLogRecord const& record) {
+    if (log.full()) {
+        log.pop_front();
+    }
+    log.emplace_back(record);
+    return log.full();
+}
+
+/**
+ * @brief Replays @p record with @c game_update
+ * @param record logged wake
+ * @returns player after the replayed wake
+ */
+PlayerState replay_event_log_record(EventLogRecord const& record);
+
+/** @returns true if replaying @p record reproduces its end health and tick */
+bool verify_event_log_record(EventLogRecord const& record);
+
+/** @brief Longest line written by @c format_event_log_record, including the terminator */
+constexpr std::size_t kEventLogLineSize = 16 + 2 * sizeof(EventLogRecord);
+
+/**
+ * @brief Writes @p record as one serial log line, the record bytes in hex
+ * @code
+ *      event_log,1,<32 hex digits>
+ * @endcode
+ * @param record to write
+ * @param out buffer of at least @c kEventLogLineSize characters
+ * @param size size of @p out
+ * @returns number of characters written, excluding the terminator
+ */
+std::size_t format_event_log_record(EventLogRecord const& record, char* out, std::size_t size);
+
+/**
+ * @brief Reads a line written by @c format_event_log_record
+ * @param line text, possibly with other output before the record
+ * @param record set to the parsed record on success
+ * @returns true if @p line held a record
+ */
+bool parse_event_log_record(char const* line, EventLogRecord& record);
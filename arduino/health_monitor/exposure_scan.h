@@ -0,0 +1,140 @@
+// Counts exposures while a BLE scan is running, stopping once the outcome is settled
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Superspreader
+#include "advertisement.h"
+#include "contact_set.h"
+#include "health_monitor_core.h"
+#include "proximity.h"
+
+/** @file **/
+
+/**
+ * @brief Streaming scan stage: classifies each advertisement into a running @c ExposureEvent
+ *
+ * Nothing is kept per advertisement. Each address is remembered once in a
+ * @c contact_set, so a device heard several times, or first far away and then
+ * close, counts once per tick, when its strongest RSSI is first close. @c add
+ * reports when further advertisements cannot change the player's health this
+ * tick, so the scan can stop early:
+ * - the player is immune, infected or a zombie, so exposure is ignored
+ * - the exposure counted so far already turns the player into a zombie
+ * - @p max_advertisements advertisements have been classified
+ */
+class ExposureScan {
+   public:
+    /** @brief No limit on the number of advertisements classified */
+    static constexpr std::size_t kUnlimited = std::numeric_limits<std::size_t>::max();
+
+    /** @brief Hash table size for distinct addresses per scan, about 2 KB of stack */
+    static constexpr std::size_t kContactSlots = 128;
+
+    /**
+     * @param health health the exposure will be applied to
+     * @param max_advertisements stop after classifying this many advertisements
+     */
+    explicit ExposureScan(HealthState health, std::size_t max_advertisements = kUnlimited)
+        : remaining_{max_advertisements} {
+        auto const index = health.health < kNumHealthValues ? health.health : kNumHealthValues - 1;
+        // Exposure adds linearly on top of progression and saturates at zombie
+        if (kTransitionTables.susceptibility[index] != 0) {
+            load_to_zombie_ =
+                to_health(StateBounds::ZOMBIE) - kTransitionTables.progression[index];
+        }
+        if (load_to_zombie_ == 0) {
+            remaining_ = 0;
+        }
+    }
+
+    /**
+     * @brief Classifies one advertisement
+     * @param address 48-bit address of the advertiser
+     * @param rssi signal strength in dBm
+     * @param payload raw advertising data
+     * @param length number of bytes in @p payload
+     * @returns true to keep scanning, false once the outcome is settled
+     * @note Addresses beyond @c contact_set::capacity are ignored
+     */
+    bool add(ble_address_t address, int rssi, std::uint8_t const* payload, std::size_t length) {
+        if (remaining_ == 0) {
+            return false;
+        }
+        --remaining_;
+        auto* const contact = contacts_.insert(address, rssi);
+        if (contact != nullptr && !contact->counted && is_close(contact->strongest_rssi)) {
+            contact->counted = true;
+            auto const state = classify_advertisement(payload, length);
+            if (is_infected_human(state)) {
+                exposure_.human += 1;
+                load_ += to_health(InfectionRate::HUMAN);
+            }
+            if (is_cat(state)) {
+                exposure_.cat += 1;
+                load_ += to_health(InfectionRate::CAT);
+            }
+            if (load_ >= load_to_zombie_) {
+                remaining_ = 0;
+            }
+        }
+        return remaining_ != 0;
+    }
+
+    /** @returns true if further advertisements cannot change the outcome */
+    bool done() const { return remaining_ == 0; }
+
+    /** @returns exposure counted so far */
+    ExposureEvent const& exposure() const { return exposure_; }
+
+    /** @returns distinct addresses heard so far */
+    contact_set<kContactSlots> const& contacts() const { return contacts_; }
+
+   private:
+    contact_set<kContactSlots> contacts_;
+    ExposureEvent exposure_;
+    health_t load_           = 0;
+    health_t load_to_zombie_ = 0;
+    std::size_t remaining_;
+};
+
+/**
+ * @brief Runs a streaming scan of @p source and counts the exposure it finds
+ *
+ * @p SourceT delivers advertisements as they arrive:
+ * @code
+ *      template <typename F> void scan(int seconds, F on_device);
+ *          // calls bool on_device(ble_address_t address, int rssi,
+ *          //                      std::uint8_t const* payload, std::size_t length)
+ *          // for each advertisement, duplicates included, and stops once it returns false
+ * @endcode
+ * The firmware passes its HAL, tests and benchmarks pass a @c ScanTrace.
+ *
+ * @param source advertisement source
+ * @param seconds longest the scan may run
+ * @param health health the exposure will be applied to
+ * @param max_advertisements stop after classifying this many advertisements
+ * @returns exposure counted before the scan ended
+ * @note @p source is not scanned at all if exposure cannot matter
+ */
+template <typename SourceT>
+ExposureEvent scan_exposure(SourceT& source,
+                            int seconds,
+                            HealthState health,
+                            std::size_t max_advertisements = ExposureScan::kUnlimited) {
+    ExposureScan scan{health, max_advertisements};
+    if (!scan.done()) {
+        auto on_device = [&scan](ble_address_t address,
+                                 int rssi,
+                                 std::uint8_t const* payload,
+                                 std::size_t length) {
+            return scan.add(address, rssi, payload, length);
+        };
+        source.scan(seconds, on_device);
+    }
+    return scan.exposure();
+}
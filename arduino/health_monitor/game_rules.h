@@ -0,0 +1,324 @@
+// Player engine rules as a policy, so rule variants share one implementation
+
+#pragma once
+
+// C++ Standard Library
+#include <cassert>
+#include <type_traits>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+/** @file **/
+
+/**
+ * @brief Every constant the player engine rules depend on
+ * @note A literal type, so a rule set known at compile time folds into the engine
+ */
+struct RuleSet {
+    health_t immune;             /**< @c StateBounds::IMMUNE */
+    health_t super_healthy;      /**< @c StateBounds::SUPER_HEALTHY */
+    health_t healthy;            /**< @c StateBounds::HEALTHY */
+    health_t infected_asym;      /**< @c StateBounds::INFECTED_ASYM */
+    health_t infected_sym;       /**< @c StateBounds::INFECTED_SYM */
+    health_t infected_sym_late;  /**< @c StateBounds::INFECTED_SYM_LATE */
+    health_t zombie;             /**< @c StateBounds::ZOMBIE */
+    health_t super_healthy_rate; /**< @c ProgressRate::SUPER_HEALTHY */
+    health_t healthy_rate;       /**< @c ProgressRate::HEALTHY */
+    health_t infected_rate;      /**< @c ProgressRate::INFECTED */
+    health_t human_rate;         /**< @c InfectionRate::HUMAN */
+    health_t cat_rate;           /**< @c InfectionRate::CAT */
+    health_t asym_treatment;     /**< Health removed by treating an asymptomatic infection */
+    bool cat_resistance;         /**< Cats stop infecting a player once it has been infected */
+};
+
+/**
+ * @brief Compile-time policy for the shipping rules
+ * @note Every constant is a static member, so the engine reads literals that fold
+ *       into the code at any optimisation level, including the firmware's -Os
+ */
+struct DefaultRules {
+    static constexpr health_t immune             = to_health(StateBounds::IMMUNE);
+    static constexpr health_t super_healthy      = to_health(StateBounds::SUPER_HEALTHY);
+    static constexpr health_t healthy            = to_health(StateBounds::HEALTHY);
+    static constexpr health_t infected_asym      = to_health(StateBounds::INFECTED_ASYM);
+    static constexpr health_t infected_sym       = to_health(StateBounds::INFECTED_SYM);
+    static constexpr health_t infected_sym_late  = to_health(StateBounds::INFECTED_SYM_LATE);
+    static constexpr health_t zombie             = to_health(StateBounds::ZOMBIE);
+    static constexpr health_t super_healthy_rate = to_health(ProgressRate::SUPER_HEALTHY);
+    static constexpr health_t healthy_rate       = to_health(ProgressRate::HEALTHY);
+    static constexpr health_t infected_rate      = to_health(ProgressRate::INFECTED);
+    static constexpr health_t human_rate         = to_health(InfectionRate::HUMAN);
+    static constexpr health_t cat_rate           = to_health(InfectionRate::CAT);
+    static constexpr health_t asym_treatment     = 35;
+    static constexpr bool cat_resistance         = false;
+
+    /** @returns the constants as a @c RuleSet */
+    static constexpr RuleSet rules();
+};
+
+/**
+ * @brief Compile-time policy for cat resistance as in the Rust simulator: cats
+ *        infect at half the rate, and not at all once a player has been infected
+ */
+struct CatResistantRules : DefaultRules {
+    static constexpr health_t cat_rate   = 8;
+    static constexpr bool cat_resistance = true;
+
+    /** @returns the constants as a @c RuleSet */
+    static constexpr RuleSet rules();
+};
+
+/** @returns the constants of the compile-time policy @p RulesT as a @c RuleSet */
+template <typename RulesT>
+constexpr RuleSet to_rule_set() {
+    return RuleSet{RulesT::immune,
+                   RulesT::super_healthy,
+                   RulesT::healthy,
+                   RulesT::infected_asym,
+                   RulesT::infected_sym,
+                   RulesT::infected_sym_late,
+                   RulesT::zombie,
+                   RulesT::super_healthy_rate,
+                   RulesT::healthy_rate,
+                   RulesT::infected_rate,
+                   RulesT::human_rate,
+                   RulesT::cat_rate,
+                   RulesT::asym_treatment,
+                   RulesT::cat_resistance};
+}
+
+constexpr RuleSet DefaultRules::rules() { return to_rule_set<DefaultRules>(); }
+constexpr RuleSet CatResistantRules::rules() { return to_rule_set<CatResistantRules>(); }
+
+/** @brief Rules shipping on the firmware */
+constexpr RuleSet kDefaultRuleSet = DefaultRules::rules();
+
+/** @brief Rules of @c CatResistantRules */
+constexpr RuleSet kCatResistantRuleSet = CatResistantRules::rules();
+
+/** @brief Policy with rules chosen at runtime, for parameter sweeps on the host */
+struct RuntimeRules : RuleSet {
+    constexpr explicit RuntimeRules(RuleSet rules) : RuleSet{rules} {}
+
+    constexpr RuleSet const& rules() const { return *this; }
+};
+
+/**
+ * @brief Health of a player under rules with @c RuleSet::cat_resistance
+ * @note The shipping rules keep no such flag, so they use the narrower @c HealthState
+ */
+struct ResistantHealthState {
+    health_t health    = 2;     /**< Numerical health value, as @c HealthState::health */
+    bool cat_resistant = false; /**< Set once the player has been infected */
+};
+
+/** @returns true if cats can no longer infect @p health_state */
+constexpr bool is_cat_resistant(HealthState const&) { return false; }
+constexpr bool is_cat_resistant(ResistantHealthState const& health_state) {
+    return health_state.cat_resistant;
+}
+
+/** @brief Marks @p health_state cat resistant, if it can track it */
+constexpr void set_cat_resistant(HealthState&) {}
+constexpr void set_cat_resistant(ResistantHealthState& health_state) {
+    health_state.cat_resistant = true;
+}
+
+/** @brief true if @p StateT keeps cat resistance, as @c ResistantHealthState does */
+template <typename StateT>
+struct tracks_cat_resistance : std::false_type {};
+template <>
+struct tracks_cat_resistance<ResistantHealthState> : std::true_type {};
+
+/** @brief true if @p RulesT turns cat resistance on at compile time, false for @c RuntimeRules */
+template <typename RulesT, typename = void>
+struct has_static_cat_resistance : std::false_type {};
+template <typename RulesT>
+struct has_static_cat_resistance<
+    RulesT,
+    std::enable_if_t<std::is_pointer<decltype(&RulesT::cat_resistance)>::value>>
+    : std::integral_constant<bool, RulesT::cat_resistance> {};
+
+/**
+ * @brief Player engine over a rules policy
+ *
+ * @c RulesT provides every field of @c RuleSet as a member of the same name,
+ * and @c rules() returning them as a @c RuleSet. A compile-time policy such as
+ * @c DefaultRules makes them static constants, which fold into the code even at
+ * -Os, so the engine is as small and fast as hand-written rules. Cat resistant
+ * rules need a state that tracks it: a compile-time policy rejects any other
+ * state, and @c RuntimeRules asserts. The free
+ * functions in @c health_monitor_core.h are this engine with @c DefaultRules.
+ *
+ * @tparam RulesT rules policy, such as @c DefaultRules or @c RuntimeRules
+ */
+template <typename RulesT>
+class PlayerEngine {
+   public:
+    constexpr explicit PlayerEngine(RulesT policy = RulesT{}) : policy_{policy} {}
+
+    /** @returns constants of the rules policy */
+    constexpr decltype(auto) rules() const { return policy_.rules(); }
+
+    constexpr bool is_immune(health_t health) const { return health <= policy_.immune; }
+
+    constexpr bool is_super_healthy(health_t health) const {
+        return policy_.super_healthy <= health && health < policy_.healthy;
+    }
+
+    constexpr bool is_healthy(health_t health) const {
+        return policy_.healthy <= health && health < policy_.infected_asym;
+    }
+
+    constexpr bool is_infected(health_t health) const {
+        return policy_.infected_asym <= health && health < policy_.zombie;
+    }
+
+    constexpr bool is_infected_asym(health_t health) const {
+        return policy_.infected_asym <= health && health < policy_.infected_sym;
+    }
+
+    constexpr bool is_infected_sym(health_t health) const {
+        return policy_.infected_sym <= health && health < policy_.infected_sym_late;
+    }
+
+    constexpr bool is_infected_sym_late(health_t health) const {
+        return policy_.infected_sym_late <= health && health < policy_.zombie;
+    }
+
+    constexpr bool is_zombie(health_t health) const { return policy_.zombie <= health; }
+
+    /**
+     * @returns the new health affected by exposure, see @c exposure_update
+     * @tparam StateT @c HealthState, or @c ResistantHealthState to track cat resistance
+     */
+    template <typename StateT>
+    constexpr StateT exposure_update(StateT health_state, ExposureEvent const exposures) const {
+        auto const health = health_state.health;
+        update_cat_resistance(health_state);
+        if (is_zombie(health)) {
+            health_state.health = policy_.zombie;
+            return health_state;
+        }
+        if (is_immune(health)) {
+            health_state.health = policy_.immune;
+            return health_state;
+        }
+        health_state.health = health + time_increase(health) - time_decrease(health) +
+                              exposure_increase(health_state, exposures);
+        if (is_zombie(health_state.health)) {
+            health_state.health = policy_.zombie;
+        }
+        return health_state;
+    }
+
+    /** @returns new health given treatment, see @c treament_update */
+    template <typename StateT>
+    constexpr StateT treatment_update(StateT health_state) const {
+        auto& health = health_state.health;
+        if (is_infected_sym_late(health)) {
+            health = policy_.immune;
+        } else if (is_infected_sym(health)) {
+            health = policy_.healthy;
+        } else if (is_infected_asym(health)) {
+            health -= policy_.asym_treatment;  // sometimes you go healthy, other times super
+        } else if (is_healthy(health)) {
+            health = policy_.super_healthy;
+        }
+        return health_state;
+    }
+
+    /**
+     * @returns health after @p ticks idle ticks, see @c idle_update
+     * @pre super healthy players do not overshoot HEALTHY: @c super_healthy_rate <= @c healthy
+     * @note A zero rate leaves that range where it is, as a single tick does
+     */
+    template <typename StateT>
+    constexpr StateT idle_update(StateT health_state, unsigned long ticks) const {
+        auto& health = health_state.health;
+        if (ticks == 0) {
+            return health_state;
+        }
+        update_cat_resistance(health_state);
+        if (is_zombie(health)) {
+            health = policy_.zombie;
+        } else if (is_immune(health)) {
+            health = policy_.immune;
+        } else if (is_infected(health)) {
+            // Linear progression, saturating at zombie, which is then left alone
+            auto const rate = policy_.infected_rate;
+            if (rate != 0) {
+                auto const remaining = (policy_.zombie - health + rate - 1) / rate;
+                health = ticks < remaining ? health + static_cast<health_t>(ticks) * rate
+                                           : policy_.zombie;
+            }
+        } else if (is_super_healthy(health)) {
+            // Climbs to exactly HEALTHY, where healthy decay leaves it
+            auto const rate = policy_.super_healthy_rate;
+            if (rate != 0) {
+                auto const remaining = (policy_.healthy - health + rate - 1) / rate;
+                health = ticks < remaining ? health + static_cast<health_t>(ticks) * rate
+                                           : policy_.healthy;
+            }
+        } else if (health > policy_.healthy) {
+            // Decays while the result stays above HEALTHY
+            auto const rate = policy_.healthy_rate;
+            if (rate != 0) {
+                auto const remaining = (health - policy_.healthy - 1) / rate;
+                health -= static_cast<health_t>(ticks < remaining ? ticks : remaining) * rate;
+            }
+        }
+        return health_state;
+    }
+
+   private:
+    /** @brief Marks @p health_state cat resistant once infected, under rules with resistance */
+    template <typename StateT>
+    constexpr void update_cat_resistance(StateT& health_state) const {
+        static_assert(!has_static_cat_resistance<RulesT>::value ||
+                          tracks_cat_resistance<StateT>::value,
+                      "cat resistant rules need a state that tracks it, such as ResistantHealthState");
+        if (policy_.cat_resistance && policy_.infected_asym <= health_state.health) {
+            assert(tracks_cat_resistance<StateT>::value &&
+                   "cat resistant rules need a state that tracks it");
+            set_cat_resistant(health_state);
+        }
+    }
+
+    /** @returns amount to increase health by, given @p exposures */
+    template <typename StateT>
+    constexpr health_t exposure_increase(StateT const& health_state,
+                                         ExposureEvent const exposures) const {
+        if (is_immune(health_state.health) || is_infected(health_state.health)) return 0;
+
+        auto const cats = is_cat_resistant(health_state) ? 0 : exposures.cat;
+        return exposures.human * policy_.human_rate + cats * policy_.cat_rate;
+    }
+
+    /** @returns amount to increase @p health by, given current progression */
+    constexpr health_t time_increase(health_t health) const {
+        if (is_super_healthy(health)) {
+            auto const rate      = policy_.super_healthy_rate;
+            auto const sum       = health + rate;
+            auto const remainder = sum % policy_.healthy;
+            auto const quotient  = sum / policy_.healthy;  // unsigned, so floored
+            return rate - remainder * quotient;
+        }
+        if (is_infected(health)) return policy_.infected_rate;
+        return 0;
+    }
+
+    /** @returns amount to decrease @p health by, given current progression */
+    constexpr health_t time_decrease(health_t health) const {
+        if (is_healthy(health)) {
+            // Preview the result
+            auto const sum = health - policy_.healthy_rate;
+            // If the result is too healthy, do nothing
+            return sum > policy_.healthy ? policy_.healthy_rate : 0;
+        }
+        return 0;
+    }
+
+    RulesT policy_;
+};
@@ -0,0 +1,91 @@
+// C++ Standard Library
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Superspreader
+#include "game_trace.h"
+
+namespace {
+
+constexpr char kRecordTag[]      = "game_trace,";
+constexpr unsigned kRecordFormat = 1;
+
+/** @brief Reads an unsigned field of at most @p max followed by a comma or the end of the line */
+bool parse_field(char const*& cursor, unsigned long max, unsigned long& value) {
+    char* end = nullptr;
+    value     = std::strtoul(cursor, &end, 10);
+    if (end == cursor || value > max ||
+        (*end != ',' && *end != '\0' && *end != '\n' && *end != '\r')) {
+        return false;
+    }
+    cursor = *end == ',' ? end + 1 : end;
+    return true;
+}
+
+}  // namespace
+
+#if !defined(__XTENSA__)
+std::uint32_t read_host_cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return static_cast<std::uint32_t>(__rdtsc());
+#else
+    return static_cast<std::uint32_t>(
+        std::chrono::steady_clock::now().time_since_epoch() / std::chrono::nanoseconds{1});
+#endif
+}
+#endif
+
+std::size_t format_game_trace_record(GameTraceRecord const& record, char* out, std::size_t size) {
+    auto const written = std::snprintf(out,
+                                       size,
+                                       "%s%u,%lu,%u,%u,%u,%u,%lu",
+                                       kRecordTag,
+                                       kRecordFormat,
+                                       static_cast<unsigned long>(record.tick),
+                                       static_cast<unsigned>(record.type),
+                                       static_cast<unsigned>(record.health_before),
+                                       static_cast<unsigned>(record.health_after),
+                                       static_cast<unsigned>(record.events),
+                                       static_cast<unsigned long>(record.cycles));
+    return written > 0 && static_cast<std::size_t>(written) < size
+               ? static_cast<std::size_t>(written)
+               : 0;
+}
+
+bool parse_game_trace_record(char const* line, GameTraceRecord& record) {
+    auto const* cursor = std::strstr(line, kRecordTag);
+    if (cursor == nullptr) {
+        return false;
+    }
+    cursor += sizeof(kRecordTag) - 1;
+
+    unsigned long format = 0;
+    unsigned long fields[6];
+    if (!parse_field(cursor, 0xFFFFFFFFUL, format) || format != kRecordFormat) {
+        return false;
+    }
+    constexpr unsigned long kMax[6] = {0xFFFFFFFFUL, kNumGameTraceTypes - 1, 255, 255, 255,
+                                       0xFFFFFFFFUL};
+    for (std::size_t i = 0; i < 6; ++i) {
+        if (!parse_field(cursor, kMax[i], fields[i])) {
+            return false;
+        }
+    }
+    if (fields[1] == 0) {
+        return false;
+    }
+
+    record.tick          = static_cast<std::uint32_t>(fields[0]);
+    record.type          = static_cast<GameTraceType>(fields[1]);
+    record.health_before = static_cast<std::uint8_t>(fields[2]);
+    record.health_after  = static_cast<std::uint8_t>(fields[3]);
+    record.events        = static_cast<std::uint8_t>(fields[4]);
+    record.cycles        = static_cast<std::uint32_t>(fields[5]);
+    return true;
+}
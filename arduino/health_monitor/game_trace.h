@@ -0,0 +1,135 @@
+// Structured trace of each event game_update applies, compiled out unless a sink is given
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+
+/** @file **/
+
+// Define as 1 to trace game_update on the device, written to serial after each wake
+#ifndef SUPERSPREADER_GAME_TRACING
+#define SUPERSPREADER_GAME_TRACING 0
+#endif
+
+/** @brief true if the firmware passes a tracing sink to @c run_wake_cycle */
+constexpr bool kGameTracing = SUPERSPREADER_GAME_TRACING != 0;
+
+/** @brief What a @c GameTraceRecord describes */
+enum struct GameTraceType : std::uint8_t {
+    EXPOSURE          = 1, /**< Exposure applied */
+    TREATMENT         = 2, /**< Treatment applied */
+    TREATMENT_LATCHED = 3, /**< Treatment dropped, the player was already treated this tick */
+    TICK              = 4, /**< End of a @c game_update, covering every event it polled */
+};
+
+/** @brief Number of @c GameTraceType values, including the unused 0 */
+constexpr std::size_t kNumGameTraceTypes = 5;
+
+/**
+ * @brief One traced event of @c game_update, in 12 bytes
+ * @note Health saturates at 255, cycles wrap at 2^32
+ */
+struct GameTraceRecord {
+    std::uint32_t tick;         /**< Player tick the event was applied on */
+    std::uint32_t cycles;       /**< Cycles spent in the rule, or in the whole update for TICK */
+    GameTraceType type;         /**< What happened */
+    std::uint8_t health_before; /**< Health before the event, or at the start of the tick */
+    std::uint8_t health_after;  /**< Health after the event, or at the end of the tick */
+    std::uint8_t events;        /**< Events polled before this one, or in the whole tick */
+};
+
+/** @returns @p health as stored in a @c GameTraceRecord */
+constexpr std::uint8_t to_trace_health(unsigned long health) {
+    return static_cast<std::uint8_t>(health < 255 ? health : 255);
+}
+
+#if !defined(__XTENSA__)
+/**
+ * @returns low 32 bits of the time stamp counter on x86, or nanoseconds of the
+ *          steady clock on other hosts
+ * @note Out of line so the core header does not pull in the intrinsics headers
+ */
+std::uint32_t read_host_cycle_counter();
+#endif
+
+/**
+ * @returns current value of the CPU cycle counter, or of a nanosecond clock on
+ *          hosts without a readable one
+ */
+inline std::uint32_t read_cycle_counter() {
+#if defined(__XTENSA__)
+    std::uint32_t ccount;
+    asm volatile("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#else
+    return read_host_cycle_counter();
+#endif
+}
+
+/**
+ * @brief Sink that discards the trace, the default of @c game_update
+ * @note Every member is empty or constant, so tracing with it compiles away
+ */
+struct NullTraceSink {
+    constexpr std::uint32_t cycles() const { return 0; }
+    void record(GameTraceRecord const&) {}
+};
+
+/** @brief Sink that keeps the first @p N records in a preallocated array */
+template <std::size_t N>
+struct GameTraceBuffer {
+    std::uint32_t cycles() const { return read_cycle_counter(); }
+
+    /** @brief Stores @p record, or counts it as dropped if the buffer is full */
+    void record(GameTraceRecord const& record) {
+        if (size_ < N) {
+            records_[size_++] = record;
+        } else {
+            ++dropped_;
+        }
+    }
+
+    GameTraceRecord const* begin() const { return records_; }
+    GameTraceRecord const* end() const { return records_ + size_; }
+
+    /** @returns number of records stored */
+    std::size_t size() const { return size_; }
+
+    /** @returns number of records lost to a full buffer since the last @c clear */
+    std::size_t dropped() const { return dropped_; }
+
+    /** @brief Empties the buffer */
+    void clear() {
+        size_    = 0;
+        dropped_ = 0;
+    }
+
+    GameTraceRecord records_[N];
+    std::size_t size_    = 0;
+    std::size_t dropped_ = 0;
+};
+
+/** @brief Longest line written by @c format_game_trace_record, including the terminator */
+constexpr std::size_t kGameTraceLineSize = 80;
+
+/**
+ * @brief Writes @p record as one text line for the serial log
+ * @code
+ *      game_trace,1,<tick>,<type>,<health_before>,<health_after>,<events>,<cycles>
+ * @endcode
+ * @param record record to write
+ * @param out buffer of at least @c kGameTraceLineSize characters
+ * @param size size of @p out
+ * @returns number of characters written, excluding the terminator, or 0 if @p out is too small
+ */
+std::size_t format_game_trace_record(GameTraceRecord const& record, char* out, std::size_t size);
+
+/**
+ * @brief Reads a line written by @c format_game_trace_record
+ * @param line null terminated text, possibly with other text before the record
+ * @param record set from @p line on success
+ * @returns false, leaving @p record untouched, if @p line holds no valid record
+ */
+bool parse_game_trace_record(char const* line, GameTraceRecord& record);
@@ -2,295 +2,216 @@
 #include <cmath>
 
 #include "health_monitor_core.h"
-#include "static_ring_buffer.h"
+#include "wake_cycle.h"
 
 namespace globals {
 
 //// Persistent State ///////////////////////////////////////////////////
 
-RTC_DATA_ATTR PlayerState player_state_persistent;
+// Versioned and checksummed, see load_player_state
+RTC_DATA_ATTR PersistentState persistent_state;
+
+// Time and energy per wake phase since power on, logged at the end of each wake
+RTC_DATA_ATTR WakeProfile wake_profile;
+
+// Events of recent wakes, written to serial once full. Constant-initialized, so
+// it is kept across deep sleep.
+RTC_DATA_ATTR EventLog event_log;
 
 //// Temporary State ////////////////////////////////////////////////////
 
-RTC_DATA_ATTR bool treatment_received_interrupt_fired = false;
+// Filled directly by ISRs. Constant-initialized, so events raised after the
+// last game update of a wake are kept in RTC memory for the next wake.
+RTC_DATA_ATTR InterruptEventQueue interrupt_event_queue;
+
+hw_timer_t* led_timer = NULL;
 
 }  // namespace globals
 
 //// Device stuff ///////////////////////////////////////////////////////
 
-constexpr auto uS_TO_S_FACTOR   = 1000000; /* Conversion factor for micro seconds to seconds */
-constexpr auto TIME_TO_SLEEP    = 5;       /* Time ESP32 will go to sleep (in seconds) */
-constexpr auto RSSI_LOWER_BOUND = -77;     // rssi less than this ignored
-constexpr auto SCAN_SECONDS     = 3;
-
-constexpr auto PREFIX_STR        = "HM - ";
-constexpr auto CAT_STR           = "Zombie -1";
-constexpr auto IMMUNE_STR        = "Immune";
-constexpr auto SUPER_STR         = "Super Healthy";
-constexpr auto HEALTY_STR        = "Healthy";
-constexpr auto A_SYMPTOMATIC_STR = "Asymptomatic";
-constexpr auto SICK_STR          = "Sick";
-constexpr auto ZOMBIE_STR        = "Zombie";
-
 constexpr auto blue_led_pin  = 27;
 constexpr auto green_led_pin = 14;
 constexpr auto red_led_pin   = 12;
 constexpr auto treatment_pin = GPIO_NUM_4;
 
-bool is_monitor(std::string const& name) { return name.rfind(PREFIX_STR, 0) == 0; }
-
-bool is_close(int rssi) { return rssi >= RSSI_LOWER_BOUND; }
-
-bool is_infected_human(std::string const& name) {
-    auto const state = name.substr(std::string(PREFIX_STR).length());
-    return state == A_SYMPTOMATIC_STR || state == SICK_STR || state == ZOMBIE_STR;
+constexpr int to_pin(Led led) {
+    return led == Led::BLUE ? blue_led_pin : led == Led::GREEN ? green_led_pin : red_led_pin;
 }
 
-bool is_cat(std::string const& name) {
-    auto const state = name.substr(std::string(PREFIX_STR).length());
-    return state == CAT_STR;
+void IRAM_ATTR receive_treatment() {
+    globals::interrupt_event_queue.try_emplace_back(TreatmentEvent{});
+    // treatment can only happen once per wakeup
+    detachInterrupt(treatment_pin);
 }
 
-BLEScanResults scan_ble() {
-    auto* scan = BLEDevice::getScan();
-    scan->setActiveScan(true);
-    scan->start(SCAN_SECONDS);
-    delay(1000 * SCAN_SECONDS);
-    scan->stop();
-    return scan->getResults();
-}
+void IRAM_ATTR on_timer() { digitalWrite(red_led_pin, !digitalRead(red_led_pin)); }
 
-ExposureEvent make_exposure_event_from_scan(BLEScanResults& results) {
-    ExposureEvent exposure;
-    exposure.human = 0;
-    exposure.cat   = 0;
-    for (auto i = 0; i < results.getCount(); ++i) {
-        auto device     = results.getDevice(i);
-        auto const rssi = device.getRSSI();
-        auto const name = device.getName();
-
-        if (is_monitor(name) && is_close(rssi)) {
-            if (is_infected_human(name)) {
-                exposure.human += 1;
-            }
-            if (is_cat(name)) {
-                exposure.cat += 1;
-            }
+/** @brief Passes each scan result on as it arrives, stopping the scan when asked to */
+template <typename OnDeviceT>
+class StreamingScanCallbacks : public BLEAdvertisedDeviceCallbacks {
+   public:
+    explicit StreamingScanCallbacks(OnDeviceT& on_device) : on_device_{on_device} {}
+
+    void onResult(BLEAdvertisedDevice device) override {
+        // Parse straight from the raw advertisement, without building strings
+        if (!stopped_ && !on_device_(to_ble_address(*device.getAddress().getNative()),
+                                     device.getRSSI(),
+                                     device.getPayload(),
+                                     device.getPayloadLength())) {
+            stopped_ = true;
+            BLEDevice::getScan()->stop();
         }
     }
-    return exposure;
-}
 
-void print_scan_results(BLEScanResults& results) {
-    Serial.println("---<< scan results >>--");
-    for (auto i = 0; i < results.getCount(); ++i) {
-        auto device     = results.getDevice(i);
-        auto address    = BLEAddress(device.getAddress());
-        auto const rssi = device.getRSSI();
-        auto const name = device.getName();
-
-        Serial.print("Addr: ");
-        Serial.print(address.toString().c_str());
-        Serial.print(", RSSI: ");
-        Serial.print(rssi);
-        Serial.print(", Name: ");
-        Serial.print(name.c_str());
-        Serial.println("");
-    }
-    Serial.println("---");
-}
+   private:
+    OnDeviceT& on_device_;
+    bool stopped_ = false;
+};
+
+/** @brief ESP32 hardware behind the wake cycle, see @c run_wake_cycle */
+struct Esp32Hal {
+    PersistentState& persistent_state() { return globals::persistent_state; }
+
+    InterruptEventQueue& interrupt_queue() { return globals::interrupt_event_queue; }
+
+    void begin() {
+        pinMode(blue_led_pin, OUTPUT);
+        pinMode(green_led_pin, OUTPUT);
+        pinMode(red_led_pin, OUTPUT);
+        pinMode(treatment_pin, INPUT);
+        attachInterrupt(treatment_pin, receive_treatment, RISING);
 
-std::string to_display_state(health_t health) {
-    if (is_immune(health)) {
-        return IMMUNE_STR;
-    } else if (is_super_healthy(health)) {
-        return SUPER_STR;
-    } else if (is_healthy(health)) {
-        return HEALTY_STR;
-    } else if (is_infected_asym(health)) {
-        return A_SYMPTOMATIC_STR;
-    } else if (is_infected(health)) {
-        return SICK_STR;
+        // start serial
+        Serial.begin(115200);
     }
-    return ZOMBIE_STR;
-}
 
-void IRAM_ATTR receive_treatment() {
-    globals::treatment_received_interrupt_fired = true;
-    // treatment can only happen once per wakeup
-    detachInterrupt(treatment_pin);
-}
+    WakeCause wakeup_cause() {
+        auto const wakeup_reason = esp_sleep_get_wakeup_cause();
+        switch (wakeup_reason) {
+            case ESP_SLEEP_WAKEUP_EXT0:
+                Serial.println("Wakeup caused by external signal using RTC_IO");
+                return WakeCause::TREATMENT;
+            case ESP_SLEEP_WAKEUP_TIMER:
+                Serial.println("Wakeup caused by timer");
+                return WakeCause::TIMER;
+            default:
+                Serial.printf("Wakeup was not caused by treatment or timer: %d\n", wakeup_reason);
+                return WakeCause::OTHER;
+        }
+    }
 
-hw_timer_t* led_timer = NULL;
+    void set_led(Led led, bool on) { digitalWrite(to_pin(led), on ? HIGH : LOW); }
 
-uint64_t get_blink_period(health_t health) {
-    if (is_infected_sym(health)) {
-        return 1.5e6;
-    } else if (is_infected_sym_late(health)) {
-        return 1e5;
+    void blink_led(Led led, uint64_t period_us) {
+        // Only the red LED blinks, toggled from the timer ISR
+        (void)led;
+        globals::led_timer = timerBegin(0, 80, true);
+        timerAttachInterrupt(globals::led_timer, &on_timer, true);
+        // wait time in microseconds
+        timerAlarmWrite(globals::led_timer, period_us, true);
+        timerAlarmEnable(globals::led_timer);  // Just Enable
     }
-    return 1e9;
-}
 
-void IRAM_ATTR on_timer() { digitalWrite(red_led_pin, !digitalRead(red_led_pin)); }
+    void advertise(char const* display_name, uint8_t const* data, size_t length) {
+        BLEDevice::init(kMonitorPrefix + std::string(display_name));
 
-void configure_led_timer(uint64_t period_us) {
-    led_timer = timerBegin(0, 80, true);
-    timerAttachInterrupt(led_timer, &on_timer, true);
-    // wait time in microseconds
-    timerAlarmWrite(led_timer, period_us, true);
-    timerAlarmEnable(led_timer);  // Just Enable
-}
+        // Binary state in the advertisement itself, so scanners need no name lookup
+        BLEAdvertisementData advertisement;
+        advertisement.setFlags(ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT);
+        advertisement.setManufacturerData(
+            std::string(reinterpret_cast<char const*>(data), length));
+
+        // Text name only in the scan response, for monitors running older firmware
+        BLEAdvertisementData scan_response;
+        scan_response.setName(kMonitorPrefix + std::string(display_name));
 
-void configure_hw(const struct PlayerState& player) {
-    pinMode(blue_led_pin, OUTPUT);
-    digitalWrite(blue_led_pin, HIGH);
-    pinMode(green_led_pin, OUTPUT);
-    pinMode(red_led_pin, OUTPUT);
-    pinMode(treatment_pin, INPUT);
-    attachInterrupt(treatment_pin, receive_treatment, RISING);
-
-    if (is_immune(player.health.health)) {
-        digitalWrite(green_led_pin, HIGH);
-    } else if (is_zombie(player.health.health)) {
-        digitalWrite(red_led_pin, HIGH);
-    } else if (is_infected(player.health.health)) {
-        auto const period = get_blink_period(player.health.health);
-        configure_led_timer(period);
+        auto* advertising = BLEDevice::getAdvertising();
+        advertising->setAdvertisementData(advertisement);
+        advertising->setScanResponseData(scan_response);
+        BLEDevice::startAdvertising();
     }
 
-    // start serial
-    Serial.begin(115200);
-}
+    template <typename OnDeviceT>
+    void scan(int seconds, OnDeviceT on_device) {
+        StreamingScanCallbacks<OnDeviceT> callbacks{on_device};
+        auto* scan = BLEDevice::getScan();
+        // Duplicates are filtered by the exposure scan's contact set, so the
+        // BLE library keeps no per-device result list
+        scan->setAdvertisedDeviceCallbacks(&callbacks, true);
+        scan->setActiveScan(true);
+
+        // Blocks until the window ends, or until a callback stops the scan
+        scan->start(seconds, false);
+        scan->setAdvertisedDeviceCallbacks(nullptr);
+    }
 
-template <std::size_t N>
-void poll_wakeup_events(static_ring_buffer<Event, N>& event_queue) {
-    auto const wakeup_reason = esp_sleep_get_wakeup_cause();
+    void delay_ms(uint32_t ms) { delay(ms); }
 
-    switch (wakeup_reason) {
-        case ESP_SLEEP_WAKEUP_EXT0: {
-            Serial.println("Wakeup caused by external signal using RTC_IO");
-            event_queue.emplace_back(TreatmentEvent{});
-            break;
-        }
-        case ESP_SLEEP_WAKEUP_EXT1: {
-            Serial.println("Wakeup caused by external signal using RTC_CNTL");
-            break;
-        }
-        case ESP_SLEEP_WAKEUP_TIMER: {
-            Serial.println("Wakeup caused by timer");
-            break;
-        }
-        case ESP_SLEEP_WAKEUP_TOUCHPAD: {
-            Serial.println("Wakeup caused by touchpad");
-            break;
-        }
-        case ESP_SLEEP_WAKEUP_ULP: {
-            Serial.println("Wakeup caused by ULP program");
-            break;
-        }
-        default: {
-            Serial.printf("Wakeup was not caused by deep sleep: %d\n", wakeup_reason);
-            break;
-        }
+    // Tests confirm that random does not produce the same number after reset
+    long random(long low, long high) { return ::random(low, high); }
+
+    void log(char const* message) { Serial.println(message); }
+
+    void log(char const* label, long value) { Serial.println(label + String(value)); }
+
+    void deep_sleep(uint64_t timer_us) {
+        // Flush the serial buffer
+        Serial.flush();
+
+        esp_sleep_enable_timer_wakeup(timer_us);
+
+        // Wakeup when treatment pin goes high
+        esp_sleep_enable_ext0_wakeup(treatment_pin, 1);
+        esp_deep_sleep_start();
     }
-}
 
-template <std::size_t N>
-void poll_bt_events(static_ring_buffer<Event, N>& event_queue) {
-    // Scan for nearby devices and count infected
-    auto devices = scan_ble();
-    print_scan_results(devices);
+    uint64_t micros() { return static_cast<uint64_t>(esp_timer_get_time()); }
 
-    // Create exposure data from BT scan results
-    auto const exposure = make_exposure_event_from_scan(devices);
-    Serial.println("Infected human exposure: " + String(exposure.human));
-    Serial.println("Infected cat exposure: " + String(exposure.cat));
+    WakeProfile& wake_profile() { return globals::wake_profile; }
 
-    // Add exposure event to queue for this update
-    event_queue.emplace_back(exposure);
-}
+    EventLog& event_log() { return globals::event_log; }
 
-void show_treatment_animation() {
-    // Two slow blinks
-    for (int n = 0; n < 2; ++n) {
-        digitalWrite(green_led_pin, HIGH);
-        delay(1000);
-        digitalWrite(green_led_pin, LOW);
-        delay(1000);
+    void write_event_log(EventLogRecord const* records, size_t count) {
+        char line[kEventLogLineSize];
+        for (size_t i = 0; i < count; ++i) {
+            format_event_log_record(records[i], line, sizeof(line));
+            Serial.println(line);
+        }
     }
-    // Eight fast blinks
-    for (int n = 0; n < 8; ++n) {
-        digitalWrite(green_led_pin, HIGH);
-        delay(100);
-        digitalWrite(green_led_pin, LOW);
-        delay(100);
+};
+
+/** @brief Writes each wake's game_update trace to serial once the update is done */
+struct SerialGameTrace {
+    uint32_t cycles() const { return buffer.cycles(); }
+
+    void record(GameTraceRecord const& record) {
+        buffer.record(record);
+        if (record.type != GameTraceType::TICK) {
+            return;
+        }
+        char line[kGameTraceLineSize];
+        for (auto const& traced : buffer) {
+            format_game_trace_record(traced, line, sizeof(line));
+            Serial.println(line);
+        }
+        if (buffer.dropped() > 0) {
+            Serial.printf("game_trace dropped %u records\n", static_cast<unsigned>(buffer.dropped()));
+        }
+        buffer.clear();
     }
-}
 
-void setup() {
-    configure_hw(globals::player_state_persistent);
-
-    Serial.println("Start Health: " + String(globals::player_state_persistent.health.health));
-
-    // String representing our state (used by other devices to observe us)
-    auto const display_state = to_display_state(globals::player_state_persistent.health.health);
-    Serial.println(display_state.c_str());
-    Serial.println("Health: " + String(globals::player_state_persistent.health.health));
-
-    // Start bluetooth to advertise our state
-    BLEDevice::init(PREFIX_STR + display_state);
-    BLEDevice::startAdvertising();
-
-    // Event queue will hold semi-dynamic events to process on this tick
-    static_ring_buffer<Event, 4> event_queue;
-
-    // Get any events caused by device wakeup events
-    poll_wakeup_events(event_queue);
-
-    // Get any events from BT scan
-    poll_bt_events(event_queue);
-
-    // Run game update for all enqueued events
-    game_update(
-        globals::player_state_persistent,
-        // get next event
-        [&event_queue]() -> Event {
-            if (globals::treatment_received_interrupt_fired) {
-                event_queue.emplace_back(TreatmentEvent{});
-                globals::treatment_received_interrupt_fired = false;
-            }
-
-            Event next_event;  // null state
-            if (!event_queue.empty()) {
-                next_event = event_queue.front();
-                event_queue.pop_front();
-            }
-
-            return next_event;
-        },
-        // on exposure
-        [](ExposureEvent const&) { Serial.println("Player exposed to virus"); },
-        // on treatment
-        [](TreatmentEvent const&) {
-            Serial.println("Player administered treatment");
-
-            // Do some beep boops
-            show_treatment_animation();
-        });
-
-    // Flush the serial buffer
-    Serial.flush();
-
-    Serial.println("End Health: " + String(globals::player_state_persistent.health.health));
-
-    // Enable waking up in some amount of time and sleep
-    // Tests confirm that random does not produce the same number after reset
-    esp_sleep_enable_timer_wakeup(random(1, TIME_TO_SLEEP) * uS_TO_S_FACTOR);
+    GameTraceBuffer<8> buffer;
+};
 
-    // Wakeup when treatment pin goes high
-    esp_sleep_enable_ext0_wakeup(treatment_pin, 1);
-    esp_deep_sleep_start();
+void setup() {
+    Esp32Hal hal;
+#if SUPERSPREADER_GAME_TRACING
+    SerialGameTrace trace{};
+    run_wake_cycle(hal, trace);
+#else
+    run_wake_cycle(hal);
+#endif
 }
 
 void loop() {
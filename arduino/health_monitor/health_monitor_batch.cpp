@@ -0,0 +1,373 @@
+// C++ Standard Library
+#include <cstring>
+
+// Game
+#include "health_monitor_batch.h"
+
+// x86 kernels are compiled with per-function target attributes and selected at
+// runtime, so the library runs on any x86-64 host and still builds for the ESP32
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SUPERSPREADER_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define SUPERSPREADER_X86_KERNELS 0
+#endif
+
+namespace {
+
+//// Scalar /////////////////////////////////////////////////////////////
+
+void exposure_scalar(health_t* health,
+                     health_t const* human,
+                     health_t const* cat,
+                     std::size_t begin,
+                     std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        health[i] = exposure_update_branchless(health[i], human[i], cat[i]);
+    }
+}
+
+void exposure_scalar(health_t* health,
+                     ExposureEvent const* exposures,
+                     std::size_t begin,
+                     std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        health[i] = exposure_update_branchless(health[i], exposures[i].human, exposures[i].cat);
+    }
+}
+
+void treatment_scalar(health_t* health, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        health[i] = treament_update_branchless(health[i]);
+    }
+}
+
+void treatment_scalar(health_t* health,
+                      std::uint8_t const* treated,
+                      std::size_t begin,
+                      std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        health[i] = treated[i] ? treament_update_branchless(health[i]) : health[i];
+    }
+}
+
+#if SUPERSPREADER_X86_KERNELS
+
+//// SSE4.1 /////////////////////////////////////////////////////////////
+
+#define SSE41_TARGET __attribute__((target("sse4.1")))
+
+/** @returns mask of lanes where lo <= x < hi, compared as unsigned */
+SSE41_TARGET inline __m128i in_range_sse(__m128i x, health_t lo, health_t hi) {
+    auto const offset = _mm_sub_epi32(x, _mm_set1_epi32(static_cast<int>(lo)));
+    auto const last   = _mm_set1_epi32(static_cast<int>(hi - lo - 1));
+    return _mm_cmpeq_epi32(_mm_min_epu32(offset, last), offset);
+}
+
+SSE41_TARGET inline __m128i exposure_sse(__m128i h, __m128i human, __m128i cat) {
+    auto const immune = _mm_cmpeq_epi32(
+        _mm_min_epu32(h, _mm_set1_epi32(DefaultRules::immune)), h);
+    auto const super_healthy =
+        in_range_sse(h, DefaultRules::super_healthy, DefaultRules::healthy);
+    auto const healthy =
+        in_range_sse(h, DefaultRules::healthy, DefaultRules::infected_asym);
+    auto const infected =
+        in_range_sse(h, DefaultRules::infected_asym, DefaultRules::zombie);
+
+    auto const super_healthy_next =
+        _mm_min_epu32(_mm_add_epi32(h, _mm_set1_epi32(DefaultRules::super_healthy_rate)),
+                      _mm_set1_epi32(DefaultRules::healthy));
+
+    // Healthy players above HEALTHY + rate decay, infected players progress
+    auto const no_decay = _mm_cmpeq_epi32(
+        _mm_min_epu32(h, _mm_set1_epi32(DefaultRules::healthy + DefaultRules::healthy_rate)), h);
+    auto const decays     = _mm_andnot_si128(no_decay, healthy);
+    auto const other_next = _mm_sub_epi32(
+        _mm_add_epi32(h, _mm_and_si128(infected, _mm_set1_epi32(DefaultRules::infected_rate))),
+        _mm_and_si128(decays, _mm_set1_epi32(DefaultRules::healthy_rate)));
+
+    auto const load =
+        _mm_add_epi32(_mm_mullo_epi32(human, _mm_set1_epi32(DefaultRules::human_rate)),
+                      _mm_mullo_epi32(cat, _mm_set1_epi32(DefaultRules::cat_rate)));
+    auto const susceptible = _mm_or_si128(super_healthy, healthy);
+
+    auto const next = _mm_add_epi32(_mm_blendv_epi8(other_next, super_healthy_next, super_healthy),
+                                    _mm_and_si128(load, susceptible));
+    auto const clamped = _mm_min_epu32(next, _mm_set1_epi32(DefaultRules::zombie));
+    return _mm_blendv_epi8(clamped, _mm_set1_epi32(DefaultRules::immune), immune);
+}
+
+SSE41_TARGET inline __m128i treatment_sse(__m128i h) {
+    auto const late    = in_range_sse(h, DefaultRules::infected_sym_late, DefaultRules::zombie);
+    auto const sym =
+        in_range_sse(h, DefaultRules::infected_sym, DefaultRules::infected_sym_late);
+    auto const asym    = in_range_sse(h, DefaultRules::infected_asym, DefaultRules::infected_sym);
+    auto const healthy = in_range_sse(h, DefaultRules::healthy, DefaultRules::infected_asym);
+    auto const treated_asym = _mm_sub_epi32(h, _mm_set1_epi32(DefaultRules::asym_treatment));
+
+    auto result = _mm_blendv_epi8(h, treated_asym, asym);
+    result      = _mm_blendv_epi8(result, _mm_set1_epi32(DefaultRules::super_healthy), healthy);
+    result      = _mm_blendv_epi8(result, _mm_set1_epi32(DefaultRules::healthy), sym);
+    return _mm_blendv_epi8(result, _mm_set1_epi32(DefaultRules::immune), late);
+}
+
+SSE41_TARGET void exposure_sse41(health_t* health,
+                                 health_t const* human,
+                                 health_t const* cat,
+                                 std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto const h = _mm_loadu_si128(reinterpret_cast<__m128i const*>(health + i));
+        auto const u = _mm_loadu_si128(reinterpret_cast<__m128i const*>(human + i));
+        auto const c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(cat + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(health + i), exposure_sse(h, u, c));
+    }
+    exposure_scalar(health, human, cat, i, count);
+}
+
+SSE41_TARGET void exposure_sse41(health_t* health,
+                                 ExposureEvent const* exposures,
+                                 std::size_t count) {
+    static_assert(sizeof(ExposureEvent) == 2 * sizeof(health_t), "expected packed exposures");
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto const h  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(health + i));
+        auto const lo = _mm_loadu_ps(reinterpret_cast<float const*>(exposures + i));
+        auto const hi = _mm_loadu_ps(reinterpret_cast<float const*>(exposures + i + 2));
+        auto const u  = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        auto const c  = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(health + i), exposure_sse(h, u, c));
+    }
+    exposure_scalar(health, exposures, i, count);
+}
+
+SSE41_TARGET void treatment_sse41(health_t* health, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto const h = _mm_loadu_si128(reinterpret_cast<__m128i const*>(health + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(health + i), treatment_sse(h));
+    }
+    treatment_scalar(health, i, count);
+}
+
+SSE41_TARGET void treatment_sse41(health_t* health, std::uint8_t const* treated, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto const h = _mm_loadu_si128(reinterpret_cast<__m128i const*>(health + i));
+        int flags    = 0;
+        std::memcpy(&flags, treated + i, sizeof(flags));
+        auto const untreated = _mm_cmpeq_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(flags)),
+                                               _mm_setzero_si128());
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(health + i),
+                         _mm_blendv_epi8(treatment_sse(h), h, untreated));
+    }
+    treatment_scalar(health, treated, i, count);
+}
+
+//// AVX2 ///////////////////////////////////////////////////////////////
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+/** @returns mask of lanes where lo <= x < hi, compared as unsigned */
+AVX2_TARGET inline __m256i in_range_avx(__m256i x, health_t lo, health_t hi) {
+    auto const offset = _mm256_sub_epi32(x, _mm256_set1_epi32(static_cast<int>(lo)));
+    auto const last   = _mm256_set1_epi32(static_cast<int>(hi - lo - 1));
+    return _mm256_cmpeq_epi32(_mm256_min_epu32(offset, last), offset);
+}
+
+AVX2_TARGET inline __m256i exposure_avx(__m256i h, __m256i human, __m256i cat) {
+    auto const immune = _mm256_cmpeq_epi32(
+        _mm256_min_epu32(h, _mm256_set1_epi32(DefaultRules::immune)), h);
+    auto const super_healthy =
+        in_range_avx(h, DefaultRules::super_healthy, DefaultRules::healthy);
+    auto const healthy =
+        in_range_avx(h, DefaultRules::healthy, DefaultRules::infected_asym);
+    auto const infected =
+        in_range_avx(h, DefaultRules::infected_asym, DefaultRules::zombie);
+
+    auto const super_healthy_next = _mm256_min_epu32(
+        _mm256_add_epi32(h, _mm256_set1_epi32(DefaultRules::super_healthy_rate)),
+        _mm256_set1_epi32(DefaultRules::healthy));
+
+    // Healthy players above HEALTHY + rate decay, infected players progress
+    auto const no_decay = _mm256_cmpeq_epi32(
+        _mm256_min_epu32(h,
+                         _mm256_set1_epi32(DefaultRules::healthy + DefaultRules::healthy_rate)),
+        h);
+    auto const decays     = _mm256_andnot_si256(no_decay, healthy);
+    auto const other_next = _mm256_sub_epi32(
+        _mm256_add_epi32(h,
+                         _mm256_and_si256(infected,
+                                          _mm256_set1_epi32(DefaultRules::infected_rate))),
+        _mm256_and_si256(decays, _mm256_set1_epi32(DefaultRules::healthy_rate)));
+
+    auto const load = _mm256_add_epi32(
+        _mm256_mullo_epi32(human, _mm256_set1_epi32(DefaultRules::human_rate)),
+        _mm256_mullo_epi32(cat, _mm256_set1_epi32(DefaultRules::cat_rate)));
+    auto const susceptible = _mm256_or_si256(super_healthy, healthy);
+
+    auto const next =
+        _mm256_add_epi32(_mm256_blendv_epi8(other_next, super_healthy_next, super_healthy),
+                         _mm256_and_si256(load, susceptible));
+    auto const clamped = _mm256_min_epu32(next, _mm256_set1_epi32(DefaultRules::zombie));
+    return _mm256_blendv_epi8(clamped, _mm256_set1_epi32(DefaultRules::immune), immune);
+}
+
+AVX2_TARGET inline __m256i treatment_avx(__m256i h) {
+    auto const late    = in_range_avx(h, DefaultRules::infected_sym_late, DefaultRules::zombie);
+    auto const sym =
+        in_range_avx(h, DefaultRules::infected_sym, DefaultRules::infected_sym_late);
+    auto const asym    = in_range_avx(h, DefaultRules::infected_asym, DefaultRules::infected_sym);
+    auto const healthy = in_range_avx(h, DefaultRules::healthy, DefaultRules::infected_asym);
+    auto const treated_asym =
+        _mm256_sub_epi32(h, _mm256_set1_epi32(DefaultRules::asym_treatment));
+
+    auto result = _mm256_blendv_epi8(h, treated_asym, asym);
+    result      = _mm256_blendv_epi8(
+        result, _mm256_set1_epi32(DefaultRules::super_healthy), healthy);
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(DefaultRules::healthy), sym);
+    return _mm256_blendv_epi8(result, _mm256_set1_epi32(DefaultRules::immune), late);
+}
+
+AVX2_TARGET void exposure_avx2(health_t* health,
+                               health_t const* human,
+                               health_t const* cat,
+                               std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto const h = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(health + i));
+        auto const u = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(human + i));
+        auto const c = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(cat + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(health + i), exposure_avx(h, u, c));
+    }
+    exposure_scalar(health, human, cat, i, count);
+}
+
+AVX2_TARGET void exposure_avx2(health_t* health,
+                               ExposureEvent const* exposures,
+                               std::size_t count) {
+    // Gathers human counts into the low half and cat counts into the high half
+    auto const deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    std::size_t i           = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto const h  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(health + i));
+        auto const lo = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(exposures + i)), deinterleave);
+        auto const hi = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(exposures + i + 4)), deinterleave);
+        auto const u = _mm256_permute2x128_si256(lo, hi, 0x20);
+        auto const c = _mm256_permute2x128_si256(lo, hi, 0x31);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(health + i), exposure_avx(h, u, c));
+    }
+    exposure_scalar(health, exposures, i, count);
+}
+
+AVX2_TARGET void treatment_avx2(health_t* health, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto const h = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(health + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(health + i), treatment_avx(h));
+    }
+    treatment_scalar(health, i, count);
+}
+
+AVX2_TARGET void treatment_avx2(health_t* health, std::uint8_t const* treated, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto const h         = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(health + i));
+        auto const flags     = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(treated + i));
+        auto const untreated = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(flags),
+                                                  _mm256_setzero_si256());
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(health + i),
+                            _mm256_blendv_epi8(treatment_avx(h), h, untreated));
+    }
+    treatment_scalar(health, treated, i, count);
+}
+
+#endif  // SUPERSPREADER_X86_KERNELS
+
+}  // namespace
+
+bool is_supported(BatchKernel kernel) {
+    switch (kernel) {
+        case BatchKernel::SCALAR:
+            return true;
+#if SUPERSPREADER_X86_KERNELS
+        case BatchKernel::SSE4_1:
+            return __builtin_cpu_supports("sse4.1");
+        case BatchKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+BatchKernel default_batch_kernel() {
+    static BatchKernel const kernel = is_supported(BatchKernel::AVX2)     ? BatchKernel::AVX2
+                                      : is_supported(BatchKernel::SSE4_1) ? BatchKernel::SSE4_1
+                                                                          : BatchKernel::SCALAR;
+    return kernel;
+}
+
+void exposure_update_batch(health_t* health,
+                           health_t const* human,
+                           health_t const* cat,
+                           std::size_t count,
+                           BatchKernel kernel) {
+    switch (kernel) {
+#if SUPERSPREADER_X86_KERNELS
+        case BatchKernel::AVX2:
+            return exposure_avx2(health, human, cat, count);
+        case BatchKernel::SSE4_1:
+            return exposure_sse41(health, human, cat, count);
+#endif
+        default:
+            return exposure_scalar(health, human, cat, 0, count);
+    }
+}
+
+void exposure_update_batch(health_t* health,
+                           ExposureEvent const* exposures,
+                           std::size_t count,
+                           BatchKernel kernel) {
+    switch (kernel) {
+#if SUPERSPREADER_X86_KERNELS
+        case BatchKernel::AVX2:
+            return exposure_avx2(health, exposures, count);
+        case BatchKernel::SSE4_1:
+            return exposure_sse41(health, exposures, count);
+#endif
+        default:
+            return exposure_scalar(health, exposures, 0, count);
+    }
+}
+
+void treament_update_batch(health_t* health, std::size_t count, BatchKernel kernel) {
+    switch (kernel) {
+#if SUPERSPREADER_X86_KERNELS
+        case BatchKernel::AVX2:
+            return treatment_avx2(health, count);
+        case BatchKernel::SSE4_1:
+            return treatment_sse41(health, count);
+#endif
+        default:
+            return treatment_scalar(health, 0, count);
+    }
+}
+
+void treament_update_batch(health_t* health,
+                           std::uint8_t const* treated,
+                           std::size_t count,
+                           BatchKernel kernel) {
+    switch (kernel) {
+#if SUPERSPREADER_X86_KERNELS
+        case BatchKernel::AVX2:
+            return treatment_avx2(health, treated, count);
+        case BatchKernel::SSE4_1:
+            return treatment_sse41(health, treated, count);
+#endif
+        default:
+            return treatment_scalar(health, treated, 0, count);
+    }
+}
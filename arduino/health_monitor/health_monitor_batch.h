@@ -0,0 +1,137 @@
+// Batch versions of the player engine health updates for large populations
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+
+// Superspreader
+#include "game_rules.h"
+#include "health_monitor_core.h"
+
+/** @file **/
+
+/**
+ * @brief Instruction set used by the batch kernels
+ * @note Every kernel produces results bit-identical to @c exposure_update and
+ *       @c treament_update for every input, including out of range health values
+ */
+enum struct BatchKernel {
+    SCALAR = 0, /**< Portable branchless loop, used on the ESP32 */
+    SSE4_1 = 1, /**< 4 players per instruction on x86 */
+    AVX2   = 2, /**< 8 players per instruction on x86 */
+};
+
+/** @returns true if @p kernel can run on this CPU */
+bool is_supported(BatchKernel kernel);
+
+/** @returns the widest kernel supported by this CPU */
+BatchKernel default_batch_kernel();
+
+/**
+ * @brief Branchless equivalent of @c exposure_update on a raw health value
+ * @param health Current health
+ * @param human Number of infected human exposures
+ * @param cat Number of cat exposures
+ * @returns the new health affected by exposure
+ */
+constexpr health_t exposure_update_branchless(health_t health, health_t human, health_t cat) {
+    // Unsigned range checks: lo <= health < hi  <=>  health - lo < hi - lo
+    bool const immune        = health <= DefaultRules::immune;
+    bool const super_healthy = health - DefaultRules::super_healthy <
+                               DefaultRules::healthy - DefaultRules::super_healthy;
+    bool const healthy = health - DefaultRules::healthy <
+                         DefaultRules::infected_asym - DefaultRules::healthy;
+    bool const infected = health - DefaultRules::infected_asym <
+                          DefaultRules::zombie - DefaultRules::infected_asym;
+
+    // Super healthy players climb towards HEALTHY without passing it
+    health_t const super_healthy_next =
+        health + DefaultRules::super_healthy_rate < DefaultRules::healthy
+            ? health + DefaultRules::super_healthy_rate
+            : DefaultRules::healthy;
+
+    // Healthy players decay towards HEALTHY, infected players progress to ZOMBIE
+    bool const decays = healthy && health - DefaultRules::healthy_rate > DefaultRules::healthy;
+    health_t const other_next = health + infected * DefaultRules::infected_rate -
+                                decays * DefaultRules::healthy_rate;
+
+    health_t const susceptible = super_healthy || healthy;
+    health_t const next =
+        (super_healthy ? super_healthy_next : other_next) +
+        susceptible * (human * DefaultRules::human_rate + cat * DefaultRules::cat_rate);
+
+    health_t const clamped = next < DefaultRules::zombie ? next : DefaultRules::zombie;
+    return immune ? DefaultRules::immune : clamped;
+}
+
+/**
+ * @brief Branchless equivalent of @c treament_update on a raw health value
+ * @param health Current health
+ * @returns new health given treatment
+ */
+constexpr health_t treament_update_branchless(health_t health) {
+    bool const late = health - DefaultRules::infected_sym_late <
+                      DefaultRules::zombie - DefaultRules::infected_sym_late;
+    bool const sym = health - DefaultRules::infected_sym <
+                     DefaultRules::infected_sym_late - DefaultRules::infected_sym;
+    bool const asym = health - DefaultRules::infected_asym <
+                      DefaultRules::infected_sym - DefaultRules::infected_asym;
+    bool const healthy = health - DefaultRules::healthy <
+                         DefaultRules::infected_asym - DefaultRules::healthy;
+
+    return late      ? DefaultRules::immune
+           : sym     ? DefaultRules::healthy
+           : asym    ? health - DefaultRules::asym_treatment
+           : healthy ? DefaultRules::super_healthy
+                     : health;
+}
+
+/**
+ * @brief Applies @c exposure_update to every player in a struct-of-arrays population
+ * @param health Health of each player, updated in place
+ * @param human Infected human exposures of each player
+ * @param cat Cat exposures of each player
+ * @param count Number of players
+ * @param kernel Instruction set to use, must satisfy @c is_supported
+ */
+void exposure_update_batch(health_t* health,
+                           health_t const* human,
+                           health_t const* cat,
+                           std::size_t count,
+                           BatchKernel kernel = default_batch_kernel());
+
+/**
+ * @brief Applies @c exposure_update to every player, reading interleaved exposure events
+ * @param health Health of each player, updated in place
+ * @param exposures Exposure event of each player
+ * @param count Number of players
+ * @param kernel Instruction set to use, must satisfy @c is_supported
+ */
+void exposure_update_batch(health_t* health,
+                           ExposureEvent const* exposures,
+                           std::size_t count,
+                           BatchKernel kernel = default_batch_kernel());
+
+/**
+ * @brief Applies @c treament_update to every player
+ * @param health Health of each player, updated in place
+ * @param count Number of players
+ * @param kernel Instruction set to use, must satisfy @c is_supported
+ */
+void treament_update_batch(health_t* health,
+                           std::size_t count,
+                           BatchKernel kernel = default_batch_kernel());
+
+/**
+ * @brief Applies @c treament_update to the players that received a treatment
+ * @param health Health of each player, updated in place
+ * @param treated Non-zero for each player that received a treatment
+ * @param count Number of players
+ * @param kernel Instruction set to use, must satisfy @c is_supported
+ */
+void treament_update_batch(health_t* health,
+                           std::uint8_t const* treated,
+                           std::size_t count,
+                           BatchKernel kernel = default_batch_kernel());
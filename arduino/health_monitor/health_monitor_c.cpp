@@ -0,0 +1,107 @@
+// C++ Standard Library
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+// Superspreader
+#include "game_rules.h"
+#include "health_monitor_batch.h"
+#include "health_monitor_c.h"
+#include "health_monitor_core.h"
+
+// The batch calls pass caller arrays straight to the C++ kernels, so the C types
+// must have exactly the layout of the C++ ones
+static_assert(sizeof(ss_health_t) == sizeof(health_t) && std::is_unsigned<health_t>::value,
+              "health is passed without conversion");
+static_assert(sizeof(ss_exposure) == sizeof(ExposureEvent) &&
+                  offsetof(ss_exposure, human) == offsetof(ExposureEvent, human) &&
+                  offsetof(ss_exposure, cat) == offsetof(ExposureEvent, cat),
+              "exposures are passed without conversion");
+
+namespace {
+
+/** @returns @p health as the C++ type, which may be a distinct 32-bit type on the ESP32 */
+inline health_t* as_health(ss_health_t* health) { return reinterpret_cast<health_t*>(health); }
+inline health_t const* as_health(ss_health_t const* health) {
+    return reinterpret_cast<health_t const*>(health);
+}
+
+constexpr PlayerEngine<CatResistantRules> kCatResistantEngine{};
+
+/** @returns @p health after one cat resistant exposure, updating @p cat_resistant */
+inline health_t cat_resistant_exposure(health_t health,
+                                       std::uint8_t& cat_resistant,
+                                       ExposureEvent const exposure) {
+    auto const next = kCatResistantEngine.exposure_update(
+        ResistantHealthState{health, cat_resistant != 0}, exposure);
+    cat_resistant = next.cat_resistant;
+    return next.health;
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t ss_abi_version(void) { return SS_ABI_VERSION; }
+
+ss_health_t ss_zombie_health(void) { return to_health(StateBounds::ZOMBIE); }
+
+ss_health_t ss_exposure_update(ss_health_t health, ss_health_t human, ss_health_t cat) {
+    return exposure_update(HealthState{health}, ExposureEvent{human, cat}).health;
+}
+
+ss_health_t ss_treatment_update(ss_health_t health) {
+    return treament_update(HealthState{health}).health;
+}
+
+ss_health_t ss_idle_update(ss_health_t health, uint64_t ticks) {
+    // unsigned long is 32 bits on the ESP32; every health settles long before that many ticks
+    constexpr auto max_ticks = std::numeric_limits<unsigned long>::max();
+    auto const clamped       = ticks < max_ticks ? static_cast<unsigned long>(ticks) : max_ticks;
+    return idle_update(HealthState{health}, clamped).health;
+}
+
+void ss_exposure_update_batch(ss_health_t* health,
+                              ss_health_t const* human,
+                              ss_health_t const* cat,
+                              size_t count) {
+    exposure_update_batch(as_health(health), as_health(human), as_health(cat), count);
+}
+
+void ss_exposure_update_events_batch(ss_health_t* health,
+                                     ss_exposure const* exposures,
+                                     size_t count) {
+    exposure_update_batch(
+        as_health(health), reinterpret_cast<ExposureEvent const*>(exposures), count);
+}
+
+void ss_treatment_update_batch(ss_health_t* health, uint8_t const* treated, size_t count) {
+    if (treated == nullptr) {
+        treament_update_batch(as_health(health), count);
+    } else {
+        treament_update_batch(as_health(health), treated, count);
+    }
+}
+
+ss_health_t ss_cat_resistant_exposure_update(ss_health_t health,
+                                             uint8_t* cat_resistant,
+                                             ss_health_t human,
+                                             ss_health_t cat) {
+    if (cat_resistant == nullptr) {
+        return health;
+    }
+    return cat_resistant_exposure(health, *cat_resistant, ExposureEvent{human, cat});
+}
+
+void ss_cat_resistant_exposure_update_batch(ss_health_t* health,
+                                            uint8_t* cat_resistant,
+                                            ss_health_t const* human,
+                                            ss_health_t const* cat,
+                                            size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        health[i] = cat_resistant_exposure(
+            health[i], cat_resistant[i], ExposureEvent{human[i], cat[i]});
+    }
+}
+
+}  // extern "C"
@@ -0,0 +1,118 @@
+/* Stable C ABI of the player engine, for simulators written in other languages */
+
+#pragma once
+
+/* C Standard Library */
+#include <stddef.h>
+#include <stdint.h>
+
+/** @file **/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of this interface, raised whenever a signature or layout changes
+ * @note Callers should check @c ss_abi_version against the version they were built for
+ */
+#define SS_ABI_VERSION 1
+
+/** @brief Numerical health of a player, as @c health_t */
+typedef uint32_t ss_health_t;
+
+/** @brief Exposures of one player on one tick, laid out as @c ExposureEvent */
+typedef struct ss_exposure {
+    ss_health_t human; /**< Infected humans close by */
+    ss_health_t cat;   /**< Cats close by */
+} ss_exposure;
+
+/** @returns @c SS_ABI_VERSION of the library that was linked */
+uint32_t ss_abi_version(void);
+
+/** @returns health at or above which a player is a zombie */
+ss_health_t ss_zombie_health(void);
+
+/**
+ * @name Shipping rules, one player
+ * The same functions the firmware runs, see @c exposure_update, @c treament_update
+ * and @c idle_update.
+ * @{
+ */
+ss_health_t ss_exposure_update(ss_health_t health, ss_health_t human, ss_health_t cat);
+ss_health_t ss_treatment_update(ss_health_t health);
+ss_health_t ss_idle_update(ss_health_t health, uint64_t ticks);
+/** @} */
+
+/**
+ * @name Shipping rules, many players
+ * Update caller-owned arrays in place, using the widest batch kernel the CPU
+ * supports. Nothing is allocated or copied. Results match the single player
+ * functions for every input.
+ * @{
+ */
+
+/**
+ * @brief Applies @c ss_exposure_update to @p count players
+ * @param health health of each player, updated in place
+ * @param human infected human exposures of each player
+ * @param cat cat exposures of each player
+ * @param count number of players
+ */
+void ss_exposure_update_batch(ss_health_t* health,
+                              ss_health_t const* human,
+                              ss_health_t const* cat,
+                              size_t count);
+
+/**
+ * @brief Applies @c ss_exposure_update to @p count players, reading interleaved exposures
+ * @param health health of each player, updated in place
+ * @param exposures exposures of each player
+ * @param count number of players
+ */
+void ss_exposure_update_events_batch(ss_health_t* health,
+                                     ss_exposure const* exposures,
+                                     size_t count);
+
+/**
+ * @brief Applies @c ss_treatment_update to @p count players
+ * @param health health of each player, updated in place
+ * @param treated non-zero for each player that is treated, or NULL to treat every player
+ * @param count number of players
+ */
+void ss_treatment_update_batch(ss_health_t* health, uint8_t const* treated, size_t count);
+
+/** @} */
+
+/**
+ * @name Cat resistant rules
+ * @c kCatResistantRuleSet, where a player also carries a cat resistance flag.
+ * Cats infect at half the rate, and not at all once the player has been infected.
+ * Treatment is the same as under the shipping rules.
+ * @{
+ */
+
+/**
+ * @param health current health
+ * @param cat_resistant flag of the player, set once it has been infected
+ * @param human infected human exposures
+ * @param cat cat exposures
+ * @returns the new health, or @p health unchanged if @p cat_resistant is NULL
+ */
+ss_health_t ss_cat_resistant_exposure_update(ss_health_t health,
+                                             uint8_t* cat_resistant,
+                                             ss_health_t human,
+                                             ss_health_t cat);
+
+/** @brief Applies @c ss_cat_resistant_exposure_update to @p count players in place */
+void ss_cat_resistant_exposure_update_batch(ss_health_t* health,
+                                            uint8_t* cat_resistant,
+                                            ss_health_t const* human,
+                                            ss_health_t const* cat,
+                                            size_t count);
+
+/** @} */
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
@@ -2,73 +2,68 @@
 
 // Game
 #include "health_monitor_core.h"
+#include "game_rules.h"
 
 namespace {
 
-/** @returns amount to increase @p health_state value by, given @p exposures */
-health_t exposure_increase(HealthState const health_state, ExposureEvent const exposures) {
-    if (is_immune(health_state.health) || is_infected(health_state.health)) return 0;
+/** @brief Rules shipping on the firmware, every constant folded at compile time */
+constexpr PlayerEngine<DefaultRules> kEngine{};
 
-    return exposures.human * to_health(InfectionRate::HUMAN) +
-           exposures.cat * to_health(InfectionRate::CAT);
-}
-
-/** @returns amount to increase @p health by, given current progression */
-health_t time_increase(health_t health) {
-    if (is_super_healthy(health)) {
-        auto const sum       = health + to_health(ProgressRate::SUPER_HEALTHY);
-        auto const remainder = sum % to_health(StateBounds::HEALTHY);
-        auto const quotient  = std::floor(sum / to_health(StateBounds::HEALTHY));
-        return to_health(ProgressRate::SUPER_HEALTHY) - remainder * quotient;
+/** @returns true if one idle tick of @c idle_update matches @c exposure_update for every health */
+constexpr bool idle_update_matches_one_tick() {
+    for (health_t health = 0; health < kNumHealthValues; ++health) {
+        HealthState const state{health};
+        if (kEngine.idle_update(state, 1).health !=
+            kEngine.exposure_update(state, ExposureEvent{}).health) {
+            return false;
+        }
     }
-    if (is_infected(health)) return to_health(ProgressRate::INFECTED);
-    return 0;
+    return true;
 }
 
-/** @returns amount to decrease @p health by, given current progression */
-health_t time_decrease(health_t health) {
-    if (is_healthy(health)) {
-        // Preview the result
-        auto const sum = health - to_health(ProgressRate::HEALTHY);
-        // If the result is too healthy, do nothing
-        return sum > to_health(StateBounds::HEALTHY) ? to_health(ProgressRate::HEALTHY) : 0;
+/** @returns tables built by evaluating the rules on every health value */
+constexpr TransitionTables make_transition_tables() {
+    TransitionTables tables{};
+    for (health_t health = 0; health < kNumHealthValues; ++health) {
+        HealthState const state{health};
+        auto const idle  = kEngine.exposure_update(state, ExposureEvent{}).health;
+        auto const probe = kEngine.exposure_update(state, ExposureEvent{1, 0}).health;
+        auto const treated = kEngine.treatment_update(state).health;
+        tables.treatment[health]   = static_cast<std::uint8_t>(treated);
+        tables.progression[health] = static_cast<std::uint8_t>(idle);
+        // Exposure adds linearly on top of progression, so one probe gives the slope
+        tables.susceptibility[health] =
+            static_cast<std::uint8_t>((probe - idle) / to_health(InfectionRate::HUMAN));
     }
-    return 0;
+    return tables;
 }
 
 }  // namespace
 
+// Declared extern in the header, so this has external linkage and lives in flash on the ESP32
+constexpr TransitionTables kTransitionTables = make_transition_tables();
+
+static_assert(kTransitionTables.progression[to_health(StateBounds::ZOMBIE)] ==
+                  to_health(StateBounds::ZOMBIE),
+              "zombies stay zombies");
+static_assert(kTransitionTables.treatment[to_health(StateBounds::INFECTED_SYM_LATE)] ==
+                  to_health(StateBounds::IMMUNE),
+              "late infections are cured");
+static_assert(kTransitionTables.susceptibility[to_health(StateBounds::HEALTHY)] == 1 &&
+                  kTransitionTables.susceptibility[to_health(StateBounds::INFECTED_ASYM)] == 0,
+              "only uninfected players are susceptible");
+static_assert(idle_update_matches_one_tick(), "idle fast-forward follows the per-tick rules");
+
 HealthState exposure_update(HealthState health_state, ExposureEvent const exposures) {
-    if (is_zombie(health_state.health)) {
-        health_state.health = to_health(StateBounds::ZOMBIE);
-        return health_state;
-    }
-    if (is_immune(health_state.health)) {
-        health_state.health = to_health(StateBounds::IMMUNE);
-        return health_state;
-    }
-    health_state.health = health_state.health + time_increase(health_state.health) -
-                          time_decrease(health_state.health) +
-                          exposure_increase(health_state, exposures);
-    if (is_zombie(health_state.health)) {
-        health_state.health = to_health(StateBounds::ZOMBIE);
-        return health_state;
-    }
-    return health_state;
+    return kEngine.exposure_update(health_state, exposures);
 }
 
 HealthState treament_update(HealthState health_state) {
-    if (is_infected_sym_late(health_state.health)) {
-        health_state.health = to_health(StateBounds::IMMUNE);
-    } else if (is_infected_sym(health_state.health)) {
-        health_state.health = to_health(StateBounds::HEALTHY);
-    } else if (is_infected_asym(health_state.health)) {
-        health_state.health -= 35;  // sometimes you go healthy, other times super
-    } else if (is_healthy(health_state.health)) {
-        health_state.health = to_health(StateBounds::SUPER_HEALTHY);
-    }
+    return kEngine.treatment_update(health_state);
+}
 
-    return health_state;
+HealthState idle_update(HealthState health_state, unsigned long ticks) {
+    return kEngine.idle_update(health_state, ticks);
 }
 
 PlayerState new_player_state() {
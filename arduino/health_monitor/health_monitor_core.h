@@ -4,9 +4,15 @@
 
 // C++ Standard Library
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 #include <utility>
 
+// Superspreader
+#include "game_trace.h"
+
 /** @file **/
 
 /**< health is tracked with an unsigned int */
@@ -183,27 +189,145 @@ HealthState exposure_update(HealthState health_state, ExposureEvent const exposu
  */
 HealthState treament_update(HealthState health_state);
 
+/** @brief Number of distinct health values, @c StateBounds::ZOMBIE is the largest */
+constexpr health_t kNumHealthValues = to_health(StateBounds::ZOMBIE) + 1;
+
+/**
+ * @brief Player engine rules evaluated at compile time for every health value
+ * @note Generated from the same rule functions as @c exposure_update and
+ *       @c treament_update, so both paths always agree
+ */
+struct TransitionTables {
+    std::uint8_t treatment[kNumHealthValues];      /**< Health after @c treament_update */
+    std::uint8_t progression[kNumHealthValues];    /**< Health after a tick with no exposure */
+    std::uint8_t susceptibility[kNumHealthValues]; /**< 1 if exposures add to health, else 0 */
+};
+
+/** @brief Constant tables for the current rules, stored in flash on the device */
+extern TransitionTables const kTransitionTables;
+
+/**
+ * @brief Table driven equivalent of @c exposure_update
+ * @param health_state Current health
+ * @param exposures Possible sources of infection
+ * @returns the new health affected by exposure
+ */
+inline HealthState exposure_update_lut(HealthState health_state, ExposureEvent const exposures) {
+    auto const index = health_state.health < kNumHealthValues ? health_state.health
+                                                              : kNumHealthValues - 1;
+    auto const load  = exposures.human * to_health(InfectionRate::HUMAN) +
+                      exposures.cat * to_health(InfectionRate::CAT);
+    auto const next = kTransitionTables.progression[index] +
+                      kTransitionTables.susceptibility[index] * load;
+    health_state.health = next < to_health(StateBounds::ZOMBIE) ? next
+                                                                 : to_health(StateBounds::ZOMBIE);
+    return health_state;
+}
+
+/**
+ * @brief Table driven equivalent of @c treament_update
+ * @param health_state Current health
+ * @returns new health given treatment
+ */
+inline HealthState treament_update_lut(HealthState health_state) {
+    if (health_state.health < kNumHealthValues) {
+        health_state.health = kTransitionTables.treatment[health_state.health];
+    }
+    return health_state;
+}
+
+/**
+ * @brief Computes health after @p ticks ticks with no exposure, in constant time
+ * @param health_state Current health
+ * @param ticks Number of idle ticks, 0 leaves @p health_state unchanged
+ * @returns the same health as @p ticks calls to @c exposure_update with an empty @c ExposureEvent
+ */
+HealthState idle_update(HealthState health_state, unsigned long ticks);
+
+/**
+ * @brief Advances @p player by @p ticks ticks with no events, in constant time
+ * @param player to change health and tick
+ * @param ticks Number of idle ticks, such as wakes missed while asleep
+ * @note The tick saturates at @c INT_MAX rather than overflowing, so it stays storable
+ */
+inline void advance_idle_ticks(PlayerState& player, unsigned long ticks) {
+    player.health = idle_update(player.health, ticks);
+
+    constexpr int max_tick = std::numeric_limits<int>::max();
+    auto const elapsed     = player.tick > 0 ? player.tick : 0;
+    auto const headroom    = static_cast<unsigned long>(max_tick - elapsed);
+    player.tick = ticks < headroom ? player.tick + static_cast<int>(ticks) : max_tick;
+}
+
 /** @brief Factory for building a new player */
 PlayerState new_player_state();
 
 /**
- * @brief Updates player health while also polling for new events
+ * @brief true if @p GetNextEventT polls for events and @p TraceSinkT is a trace sink
+ * @note Keeps the traced @c game_update out of overload resolution for batch calls,
+ *       which also take five arguments
+ */
+template <typename GetNextEventT, typename TraceSinkT, typename = void>
+struct is_traced_poll : std::false_type {};
+template <typename GetNextEventT, typename TraceSinkT>
+struct is_traced_poll<
+    GetNextEventT,
+    TraceSinkT,
+    std::enable_if_t<
+        std::is_convertible<decltype(std::declval<GetNextEventT&>()()), Event>::value &&
+            std::is_convertible<decltype(std::declval<TraceSinkT&>().cycles()),
+                                std::uint32_t>::value,
+        decltype(std::declval<TraceSinkT&>().record(std::declval<GameTraceRecord const&>()))>>
+    : std::true_type {};
+
+/**
+ * @brief Updates player health while also polling for new events, reporting to a trace sink
+ *
+ * @p trace is told about every event polled, including treatments the latching
+ * flag drops, and about the tick as a whole. @p TraceSinkT provides:
+ * @code
+ *      std::uint32_t cycles();                      // cycle counter, or any monotonic clock
+ *      void record(GameTraceRecord const& record);  // called as each event is applied
+ * @endcode
+ * Event records time only the rule, not @p get_next_event nor the callbacks; the
+ * tick record times the whole update. With @c NullTraceSink, the default, every
+ * trace call is empty and the update compiles to the same code as without tracing.
+ *
  * @param player to change health
  * @param get_next_event Closure that polls for new events to process
  * @param on_exposure Context specific function to call after exposure update
  * @param on_treatment Context specific function to call after treatment update
+ * @param trace sink for the trace records, such as a @c GameTraceBuffer
  */
-template <typename GetNextEventT, typename OnExposureT, typename OnTreatmentT>
-void game_update(PlayerState& player,
-                 GetNextEventT get_next_event,
-                 OnExposureT on_exposure,
-                 OnTreatmentT on_treatment) {
+template <typename GetNextEventT, typename OnExposureT, typename OnTreatmentT, typename TraceSinkT>
+std::enable_if_t<is_traced_poll<GetNextEventT, TraceSinkT>::value> game_update(
+    PlayerState& player,
+    GetNextEventT get_next_event,
+    OnExposureT on_exposure,
+    OnTreatmentT on_treatment,
+    TraceSinkT& trace) {
+    auto const tick_cycles = trace.cycles();
+    auto const tick_health = player.health.health;
+
     // Tick time alive
     ++player.tick;
 
     // Latching treatment flag
     bool treatment_previously_received = false;
 
+    // Number of events polled so far, saturating as the trace stores a byte
+    std::uint8_t events = 0;
+    auto const record   = [&trace, &player, &events](GameTraceType type,
+                                                   health_t health_before,
+                                                   std::uint32_t cycles) {
+        trace.record(GameTraceRecord{static_cast<std::uint32_t>(player.tick),
+                                     cycles,
+                                     type,
+                                     to_trace_health(health_before),
+                                     to_trace_health(player.health.health),
+                                     events});
+    };
+
     // Handle all events
     while (true) {
         // Get next enqueue event
@@ -211,28 +335,38 @@ void game_update(PlayerState& player,
 
         // If there are no more events, stop processing
         if (!event.is_valid()) {
+            record(GameTraceType::TICK, tick_health, trace.cycles() - tick_cycles);
             return;
         }
 
         // Run core game event logic
         visit(
             event,
-            [&on_exposure, &player](ExposureEvent const& exposure) {
+            [&on_exposure, &player, &trace, &record](ExposureEvent const& exposure) {
+                auto const health_before = player.health.health;
+                auto const cycles        = trace.cycles();
+
                 // Do normal player health update
                 player.health = exposure_update(player.health, exposure);
+                record(GameTraceType::EXPOSURE, health_before, trace.cycles() - cycles);
 
                 // Call any context-specific callbacks
                 on_exposure(exposure);
             },
-            [&on_treatment, &player, &treatment_previously_received](
+            [&on_treatment, &player, &treatment_previously_received, &trace, &record](
                 TreatmentEvent const& treatment) {
+                auto const health_before = player.health.health;
+
                 // Skip if player has already been treated on this tick
                 if (treatment_previously_received) {
+                    record(GameTraceType::TREATMENT_LATCHED, health_before, 0);
                     return;
                 }
 
                 // Apply treatment modifier to player health
-                player.health = treament_update(player.health);
+                auto const cycles = trace.cycles();
+                player.health     = treament_update(player.health);
+                record(GameTraceType::TREATMENT, health_before, trace.cycles() - cycles);
 
                 // Set latching flag to indicate treatment already happened on this tick
                 treatment_previously_received = true;
@@ -240,5 +374,126 @@ void game_update(PlayerState& player,
                 // Call any context-specific callbacks
                 on_treatment(treatment);
             });
+
+        if (events < 255) {
+            ++events;
+        }
+    }
+}
+
+/**
+ * @brief Updates player health while also polling for new events
+ * @param player to change health
+ * @param get_next_event Closure that polls for new events to process
+ * @param on_exposure Context specific function to call after exposure update
+ * @param on_treatment Context specific function to call after treatment update
+ */
+template <typename GetNextEventT, typename OnExposureT, typename OnTreatmentT>
+void game_update(PlayerState& player,
+                 GetNextEventT get_next_event,
+                 OnExposureT on_exposure,
+                 OnTreatmentT on_treatment) {
+    NullTraceSink trace;
+    game_update(player,
+                std::move(get_next_event),
+                std::move(on_exposure),
+                std::move(on_treatment),
+                trace);
+}
+
+/**
+ * @brief Applies the exposure events in [@p begin, @p end) to @p health, skipping treatments
+ *
+ * Exposures the player ignores are coalesced: once the player is not susceptible
+ * every remaining exposure only progresses health, and while susceptible so does
+ * every empty exposure, so each such run costs one @c idle_update.
+ */
+template <typename OnExposureT>
+void apply_exposures(HealthState& health,
+                     Event const* begin,
+                     Event const* end,
+                     OnExposureT& on_exposure) {
+    while (begin != end) {
+        if (begin->type != Event::Type::EXPOSURE) {
+            ++begin;
+            continue;
+        }
+
+        auto const index = health.health < kNumHealthValues ? health.health : kNumHealthValues - 1;
+        bool const susceptible = kTransitionTables.susceptibility[index] != 0;
+        auto const empty       = [](Event const& event) {
+            return event.data.exposure.human == 0 && event.data.exposure.cat == 0;
+        };
+        if (susceptible && !empty(*begin)) {
+            health = exposure_update_lut(health, begin->data.exposure);
+            on_exposure(begin->data.exposure);
+            ++begin;
+            continue;
+        }
+
+        // Find the run of exposures that only progress health
+        auto run_end       = begin;
+        unsigned long idle = 0;
+        for (; run_end != end; ++run_end) {
+            if (run_end->type != Event::Type::EXPOSURE) {
+                continue;
+            }
+            if (susceptible && !empty(*run_end)) {
+                break;
+            }
+            ++idle;
+        }
+        health = idle_update(health, idle);
+        for (; begin != run_end; ++begin) {
+            if (begin->type == Event::Type::EXPOSURE) {
+                on_exposure(begin->data.exposure);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Batch equivalent of the polling @c game_update over a contiguous array of events
+ *
+ * Events are coalesced before they are applied. Treatments after the first are
+ * dropped, as the latching flag ignores them, and runs of exposures that only
+ * progress health are applied as one @c idle_update (see @c apply_exposures).
+ * Player health and tick always match the polling version on the same events,
+ * and callbacks fire for the same events in the same order. Within a coalesced
+ * run, callbacks see the health at the end of the run.
+ *
+ * @param player to change health
+ * @param events events of this tick, in queue order; processing stops at the first invalid one
+ * @param count number of entries in @p events
+ * @param on_exposure Context specific function to call after exposure update
+ * @param on_treatment Context specific function to call after treatment update
+ */
+template <typename OnExposureT, typename OnTreatmentT>
+void game_update(PlayerState& player,
+                 Event const* events,
+                 std::size_t count,
+                 OnExposureT on_exposure,
+                 OnTreatmentT on_treatment) {
+    // Tick time alive
+    ++player.tick;
+
+    // The polling version stops at the first invalid event
+    auto const* end = events;
+    while (end != events + count && end->is_valid()) {
+        ++end;
+    }
+
+    // Only the first treatment in a tick has any effect
+    auto const* treatment = events;
+    while (treatment != end && treatment->type != Event::Type::TREATMENT) {
+        ++treatment;
+    }
+
+    apply_exposures(player.health, events, treatment, on_exposure);
+    if (treatment == end) {
+        return;
     }
+    player.health = treament_update(player.health);
+    on_treatment(treatment->data.treatment);
+    apply_exposures(player.health, treatment + 1, end, on_exposure);
 }
@@ -0,0 +1,116 @@
+// C++ Standard Library
+#include <cstring>
+
+// Superspreader
+#include "persistent_state.h"
+
+namespace {
+
+// CRC-32 of each nibble value, reflected polynomial 0xEDB88320
+constexpr std::uint32_t kCrcNibbles[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/** @returns CRC of every byte of @p state before its @c crc field */
+template <typename StateT>
+std::uint32_t checksum(StateT const& state) {
+    return crc32(&state, offsetof(StateT, crc));
+}
+
+/** @returns true if @p player fits the narrow stored fields */
+bool is_storable(PlayerState const& player) {
+    return player.tick >= 0 && player.health.health < kNumHealthValues;
+}
+
+}  // namespace
+
+char const* load_result_message(LoadResult result) {
+    switch (result) {
+        case LoadResult::RESTORED:
+            return "Player state restored";
+        case LoadResult::MIGRATED:
+            return "Player state migrated from an older version";
+        case LoadResult::EMPTY:
+            return "No player state, starting a new player";
+        case LoadResult::CORRUPT:
+            return "Player state corrupt, starting a new player";
+        case LoadResult::UNKNOWN_VERSION:
+            return "Player state from newer firmware, starting a new player";
+    }
+    return "";
+}
+
+std::uint32_t crc32(void const* data, std::size_t size) {
+    auto const* bytes = static_cast<std::uint8_t const*>(data);
+    std::uint32_t crc = 0xFFFFFFFF;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ kCrcNibbles[crc & 0x0F];
+        crc = (crc >> 4) ^ kCrcNibbles[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+void reset_persistent_state(PlayerState const& player, PersistentState& stored) {
+    std::memset(&stored, 0, sizeof(stored));
+    stored.magic   = kPersistentStateMagic;
+    stored.version = kPersistentStateVersion;
+    stored.health  = static_cast<std::uint8_t>(player.health.health);
+    stored.tick    = static_cast<std::uint32_t>(player.tick);
+    stored.crc     = checksum(stored);
+}
+
+LoadResult load_player_state(PersistentState& stored, PlayerState& player) {
+    auto result = LoadResult::CORRUPT;
+    if (stored.magic != kPersistentStateMagic) {
+        // Power on leaves RTC memory zeroed
+        PersistentState const empty{};
+        result = std::memcmp(&stored, &empty, sizeof(stored)) == 0 ? LoadResult::EMPTY
+                                                                   : LoadResult::CORRUPT;
+    } else if (stored.version == kPersistentStateVersion) {
+        bool const valid = stored.crc == checksum(stored) && stored.health < kNumHealthValues &&
+                           stored.tick <= static_cast<std::uint32_t>(INT32_MAX) &&
+                           stored.history_next < kWakeHistorySize &&
+                           stored.history_size <= kWakeHistorySize && stored.reserved == 0;
+        if (valid) {
+            player.tick          = static_cast<int>(stored.tick);
+            player.health.health = stored.health;
+            return LoadResult::RESTORED;
+        }
+    } else if (stored.version == 1) {
+        PersistentStateV1 v1;
+        std::memcpy(&v1, &stored, sizeof(v1));
+        if (v1.crc == checksum(v1) && v1.health < kNumHealthValues &&
+            v1.tick <= static_cast<std::uint32_t>(INT32_MAX)) {
+            player.tick          = static_cast<int>(v1.tick);
+            player.health.health = v1.health;
+            result               = LoadResult::MIGRATED;
+        }
+    } else if (stored.version > kPersistentStateVersion) {
+        result = LoadResult::UNKNOWN_VERSION;
+    }
+
+    // Whatever was there is rewritten in the current layout
+    reset_persistent_state(player, stored);
+    return result;
+}
+
+void save_player_state(PlayerState const& player, WakeRecord wake, PersistentState& stored) {
+    if (!is_storable(player)) {
+        return;
+    }
+    stored.health                       = static_cast<std::uint8_t>(player.health.health);
+    stored.tick                         = static_cast<std::uint32_t>(player.tick);
+    stored.history[stored.history_next] = wake;
+    stored.history_next = static_cast<std::uint8_t>((stored.history_next + 1) % kWakeHistorySize);
+    if (stored.history_size < kWakeHistorySize) {
+        ++stored.history_size;
+    }
+    stored.crc = checksum(stored);
+}
+
+WakeRecord wake_history(PersistentState const& stored, std::size_t age) {
+    auto const slot = (stored.history_next + kWakeHistorySize - 1 - age) % kWakeHistorySize;
+    return stored.history[slot];
+}
@@ -0,0 +1,153 @@
+// Player state kept in RTC memory across deep sleep, versioned and checksummed
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+/** @file **/
+
+/** @brief Bytes of RTC memory reserved for @c PersistentState */
+constexpr std::size_t kPersistentStateBudget = 64;
+
+/** @brief Marks RTC memory written by @c save_player_state, "SS" */
+constexpr std::uint16_t kPersistentStateMagic = 0x5353;
+
+/**
+ * @brief Layout version written by this firmware
+ * @note Version 1 held only health and tick. Version 2 added the wake history.
+ */
+constexpr std::uint8_t kPersistentStateVersion = 2;
+
+/** @brief Wakes kept in the history ring */
+constexpr std::size_t kWakeHistorySize = 12;
+
+/**
+ * @brief One wake in the history ring, packed into 4 bytes
+ *
+ * Exposure counts saturate: humans at 15 and cats at 7.
+ */
+struct WakeRecord {
+    std::uint16_t tick;  /**< Low 16 bits of the tick the wake ran */
+    std::uint8_t health; /**< Health at the end of the wake */
+    std::uint8_t events; /**< Humans in bits 0-3, cats in bits 4-6, treated in bit 7 */
+
+    /** @returns infected humans counted by the scan */
+    constexpr health_t humans() const { return events & 0x0F; }
+
+    /** @returns cats counted by the scan */
+    constexpr health_t cats() const { return (events >> 4) & 0x07; }
+
+    /** @returns true if a treatment was applied */
+    constexpr bool treated() const { return (events & 0x80) != 0; }
+};
+
+/**
+ * @brief Packs one wake into a @c WakeRecord
+ * @param player state at the end of the wake
+ * @param exposure exposure counted by the scan
+ * @param treated true if a treatment was applied
+ */
+constexpr WakeRecord make_wake_record(PlayerState const& player,
+                                      ExposureEvent const& exposure,
+                                      bool treated) {
+    return WakeRecord{
+        static_cast<std::uint16_t>(player.tick),
+        static_cast<std::uint8_t>(player.health.health),
+        static_cast<std::uint8_t>((exposure.human < 15 ? exposure.human : 15) |
+                                  (exposure.cat < 7 ? exposure.cat : 7) << 4 |
+                                  (treated ? 0x80 : 0))};
+}
+
+/**
+ * @brief Player state as stored in RTC memory
+ *
+ * Every field is fixed width and the layout has no padding, so the bytes are
+ * the same on every build. The CRC covers every byte before it, so a brownout
+ * during a write, or memory left by other firmware, is detected instead of
+ * resumed from. All zeros is an empty state, as after power on.
+ */
+struct PersistentState {
+    std::uint16_t magic;                  /**< @c kPersistentStateMagic */
+    std::uint8_t version;                 /**< @c kPersistentStateVersion */
+    std::uint8_t health;                  /**< @c HealthState::health */
+    std::uint32_t tick;                   /**< @c PlayerState::tick */
+    std::uint8_t history_next;            /**< Slot the next wake is written to */
+    std::uint8_t history_size;            /**< Wakes in @c history */
+    std::uint16_t reserved;               /**< Zero */
+    WakeRecord history[kWakeHistorySize]; /**< Most recent wakes, a ring */
+    std::uint32_t crc;                    /**< CRC-32 of every byte above */
+};
+
+static_assert(std::is_trivial<PersistentState>::value, "zero initialized in RTC memory");
+static_assert(sizeof(WakeRecord) == 4, "wake records are packed");
+static_assert(sizeof(PersistentState) <= kPersistentStateBudget, "exceeds the RTC budget");
+static_assert(offsetof(PersistentState, crc) + sizeof(std::uint32_t) == sizeof(PersistentState),
+              "no padding before or after the CRC");
+
+/** @brief Layout of version 1, only read to migrate it */
+struct PersistentStateV1 {
+    std::uint16_t magic;  /**< @c kPersistentStateMagic */
+    std::uint8_t version; /**< 1 */
+    std::uint8_t health;  /**< @c HealthState::health */
+    std::uint32_t tick;   /**< @c PlayerState::tick */
+    std::uint32_t crc;    /**< CRC-32 of every byte above */
+};
+
+static_assert(sizeof(PersistentStateV1) <= sizeof(PersistentState), "older layouts fit");
+
+/** @brief Outcome of @c load_player_state */
+enum struct LoadResult {
+    RESTORED        = 0, /**< Current version, checksum valid */
+    MIGRATED        = 1, /**< Older version, converted to the current one */
+    EMPTY           = 2, /**< Never written, as after power on */
+    CORRUPT         = 3, /**< Checksum or field check failed */
+    UNKNOWN_VERSION = 4, /**< Written by newer firmware */
+};
+
+/** @returns short description of @p result for the serial log */
+char const* load_result_message(LoadResult result);
+
+/**
+ * @returns CRC-32 (IEEE 802.3) of @p size bytes at @p data
+ * @note Nibble-table implementation, small enough for flash
+ */
+std::uint32_t crc32(void const* data, std::size_t size);
+
+/**
+ * @brief Writes @p player with an empty history as the current version
+ * @param player state to store
+ * @param stored RTC memory to overwrite
+ */
+void reset_persistent_state(PlayerState const& player, PersistentState& stored);
+
+/**
+ * @brief Reads the player back from RTC memory
+ *
+ * Older versions are migrated in place. Anything that cannot be restored is
+ * replaced by @p player as passed in, so @p stored is always valid afterwards.
+ *
+ * @param stored RTC memory
+ * @param player set to the stored state, or left unchanged if it cannot be restored
+ * @returns how @p player was obtained
+ */
+LoadResult load_player_state(PersistentState& stored, PlayerState& player);
+
+/**
+ * @brief Stores @p player and appends @p wake to the history
+ * @param player state at the end of the wake
+ * @param wake record of the wake, see @c make_wake_record
+ * @param stored RTC memory previously passed to @c load_player_state
+ */
+void save_player_state(PlayerState const& player, WakeRecord wake, PersistentState& stored);
+
+/**
+ * @returns wake @p age wakes before the most recent one
+ * @pre @p age < @c PersistentState::history_size
+ */
+WakeRecord wake_history(PersistentState const& stored, std::size_t age);
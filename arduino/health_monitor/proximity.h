@@ -0,0 +1,11 @@
+// Bluetooth proximity rules shared by the firmware and host simulation
+
+#pragma once
+
+/** @file **/
+
+/** @brief Scan results with an RSSI (dBm) below this are ignored */
+constexpr int RSSI_LOWER_BOUND = -77;
+
+/** @returns true if a device received at @p rssi dBm counts as a close contact */
+constexpr bool is_close(int rssi) { return rssi >= RSSI_LOWER_BOUND; }
@@ -0,0 +1,75 @@
+// C++ Standard Library
+#include <cctype>
+#include <cstdlib>
+
+// Superspreader
+#include "scan_trace.h"
+
+namespace {
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+void ScanTrace::add(ble_address_t address,
+                    int rssi,
+                    std::uint8_t const* payload,
+                    std::size_t length) {
+    addresses_.push_back(address);
+    rssi_.push_back(rssi);
+    offsets_.push_back(bytes_.size());
+    bytes_.insert(bytes_.end(), payload, payload + length);
+}
+
+bool ScanTrace::add_line(char const* line) {
+    while (std::isspace(static_cast<unsigned char>(*line))) {
+        ++line;
+    }
+    if (*line == '\0' || *line == '#') {
+        return true;
+    }
+
+    // Six hex bytes separated by colons
+    std::uint8_t address[6];
+    for (std::size_t i = 0; i < 6; ++i) {
+        auto const high = hex_value(line[0]);
+        auto const low  = high < 0 ? -1 : hex_value(line[1]);
+        if (low < 0 || line[2] != (i < 5 ? ':' : ' ')) {
+            return false;
+        }
+        address[i] = static_cast<std::uint8_t>(high << 4 | low);
+        line += 3;
+    }
+
+    char* cursor    = nullptr;
+    auto const rssi = std::strtol(line, &cursor, 10);
+    if (cursor == line || !std::isspace(static_cast<unsigned char>(*cursor))) {
+        return false;
+    }
+    while (std::isspace(static_cast<unsigned char>(*cursor))) {
+        ++cursor;
+    }
+
+    // Decode into the tail of bytes_, dropping it again if the line is malformed
+    auto const begin = bytes_.size();
+    while (*cursor != '\0' && !std::isspace(static_cast<unsigned char>(*cursor))) {
+        auto const high = hex_value(cursor[0]);
+        auto const low  = high < 0 ? -1 : hex_value(cursor[1]);
+        if (low < 0) {
+            bytes_.resize(begin);
+            return false;
+        }
+        bytes_.push_back(static_cast<std::uint8_t>(high << 4 | low));
+        cursor += 2;
+    }
+
+    addresses_.push_back(to_ble_address(address));
+    rssi_.push_back(static_cast<int>(rssi));
+    offsets_.push_back(begin);
+    return true;
+}
@@ -0,0 +1,70 @@
+// Recorded BLE advertisements, replayed as a scan source
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Superspreader
+#include "contact_set.h"
+
+/** @file **/
+
+/**
+ * @brief Advertisements in the order a scan received them
+ *
+ * Stands in for the radio wherever @c scan_exposure needs an advertisement
+ * source, so scan handling can be tested and benchmarked off-device.
+ * Traces are stored as text, one advertisement per line:
+ * @code
+ *      # comment
+ *      <address> <rssi> <payload as hex>
+ *      24:0a:c4:12:34:56 -61 02010606ffffff5a1428
+ * @endcode
+ */
+class ScanTrace {
+   public:
+    /** @brief Appends an advertisement */
+    void add(ble_address_t address, int rssi, std::uint8_t const* payload, std::size_t length);
+
+    /**
+     * @brief Appends the advertisement on one line of a text trace
+     * @param line null terminated text line
+     * @returns false if @p line is neither blank, a comment nor an advertisement
+     */
+    bool add_line(char const* line);
+
+    /** @returns number of advertisements */
+    std::size_t size() const { return offsets_.size(); }
+
+    /** @returns number of advertisements delivered by the last @c scan */
+    std::size_t delivered() const { return delivered_; }
+
+    /**
+     * @brief Replays every advertisement until @p on_device returns false
+     * @param seconds ignored, a trace is one complete scan window
+     * @param on_device called with (address, rssi, payload, length) of each advertisement
+     */
+    template <typename OnDeviceT>
+    void scan(int seconds, OnDeviceT on_device) {
+        (void)seconds;
+        delivered_ = 0;
+        for (std::size_t i = 0; i < offsets_.size(); ++i) {
+            ++delivered_;
+            auto const begin = offsets_[i];
+            auto const end   = i + 1 < offsets_.size() ? offsets_[i + 1] : bytes_.size();
+            if (!on_device(addresses_[i], rssi_[i], bytes_.data() + begin, end - begin)) {
+                return;
+            }
+        }
+    }
+
+   private:
+    std::vector<ble_address_t> addresses_;
+    std::vector<int> rssi_;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::uint8_t> bytes_;
+    std::size_t delivered_ = 0;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// ISRs on the ESP32 must run from IRAM, so the producer path is forced inline
+// into the (IRAM_ATTR) caller instead of being emitted as a flash function
+#if defined(__GNUC__)
+#define SPSC_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define SPSC_ALWAYS_INLINE inline
+#endif
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ * One context (an ISR, or a thread on host) may call @p try_emplace_back while
+ * another calls @p front / @p pop_front / @p try_pop_front. The producer only
+ * writes @c tail_ and the consumer only writes @c head_; each publishes its
+ * index with a release store that the other side reads with an acquire load, so
+ * a slot is never read before it is constructed or reused before it is consumed.
+ *
+ * One extra slot is kept empty to tell a full buffer from an empty one, which
+ * works for any @p N without wrapping counters.
+ *
+ * The default constructor is @c constexpr, so a buffer with static storage is
+ * constant-initialized. On the ESP32 this lets it live in @c RTC_DATA_ATTR
+ * memory without being reset on every wake.
+ */
+template <typename ValueT, std::size_t N>
+class spsc_ring_buffer {
+    static_assert(N > 0, "effective size of ring buffer must be > 0");
+#if __cplusplus >= 201703L
+    static_assert(std::atomic<std::size_t>::is_always_lock_free,
+                  "indices must be lock-free to be used from an ISR");
+#endif
+
+    static constexpr std::size_t kSlots = N + 1;
+
+    // Keep producer and consumer indices on separate cache lines on host, but
+    // do not spend scarce RTC memory on padding on the device
+#if defined(ARDUINO)
+    static constexpr std::size_t kIndexAlign = alignof(std::atomic<std::size_t>);
+#else
+    static constexpr std::size_t kIndexAlign = 64;
+#endif
+
+   public:
+    constexpr spsc_ring_buffer() : head_{0}, tail_{0}, buffer_{} {}
+
+    ~spsc_ring_buffer() {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    spsc_ring_buffer(spsc_ring_buffer const&)            = delete;
+    spsc_ring_buffer& operator=(spsc_ring_buffer const&) = delete;
+
+    static constexpr std::size_t capacity() { return N; }
+
+    /** @note Exact only when called from the producer or consumer while the other is idle */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    /** @note Exact only when called from the producer or consumer while the other is idle */
+    std::size_t size() const {
+        auto const head = head_.load(std::memory_order_acquire);
+        auto const tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : tail + kSlots - head;
+    }
+
+    /**
+     * @brief Constructs a value at the back of the buffer. Producer only.
+     * @returns false, without constructing, if the buffer is full
+     */
+    template <typename... Args>
+    SPSC_ALWAYS_INLINE bool try_emplace_back(Args&&... args) {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        auto const next = increment(tail);
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        new (slot(tail)) ValueT{std::forward<Args>(args)...};
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Oldest value in the buffer. Consumer only.
+     * @note The buffer must not be empty
+     */
+    ValueT& front() { return *slot(head_.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief Destroys the oldest value in the buffer. Consumer only.
+     * @note The buffer must not be empty
+     */
+    void pop_front() {
+        auto const head = head_.load(std::memory_order_relaxed);
+        slot(head)->~ValueT();
+        head_.store(increment(head), std::memory_order_release);
+    }
+
+    /**
+     * @brief Moves the oldest value into @p value and removes it. Consumer only.
+     * @returns false, leaving @p value untouched, if the buffer is empty
+     */
+    bool try_pop_front(ValueT& value) {
+        auto const head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        auto* const p = slot(head);
+        value         = std::move(*p);
+        p->~ValueT();
+        head_.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+   private:
+    SPSC_ALWAYS_INLINE static constexpr std::size_t increment(std::size_t index) {
+        return index + 1 == kSlots ? 0 : index + 1;
+    }
+
+    SPSC_ALWAYS_INLINE ValueT* slot(std::size_t index) { return reinterpret_cast<ValueT*>(buffer_) + index; }
+
+    alignas(kIndexAlign) std::atomic<std::size_t> head_;
+    alignas(kIndexAlign) std::atomic<std::size_t> tail_;
+    alignas(kIndexAlign) alignas(ValueT) std::uint8_t buffer_[kSlots * sizeof(ValueT)];
+};
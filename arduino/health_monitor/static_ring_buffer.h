@@ -1,63 +1,382 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
-template <typename ValueT, std::size_t N, bool SafeMode = true>
-class static_ring_buffer {
+/**
+ * @defgroup ring_buffer_policies static_ring_buffer error policies
+ * @brief What a @c static_ring_buffer does when an operation would overflow or underflow
+ *
+ * The checked operations (@c emplace_back, @c pop_front, @c push_n and
+ * @c consume) return the policy's @c status, built with @c ok() or
+ * @c fail(what). When @c kChecked is false the checks are compiled out and
+ * calling out of bounds is undefined behavior.
+ * @{
+ */
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+/** @brief Throws @c std::range_error */
+struct ring_buffer_throws {
+    using status                   = void;
+    static constexpr bool kChecked = true;
+    static constexpr void ok() {}
+    [[noreturn]] static void fail(char const* what) { throw std::range_error{what}; }
+};
+#endif
+
+/** @brief Returns false and leaves the buffer unchanged */
+struct ring_buffer_returns_status {
+    using status                   = bool;
+    static constexpr bool kChecked = true;
+    static constexpr bool ok() { return true; }
+    static constexpr bool fail(char const* /*what*/) { return false; }
+};
+
+/** @brief Stops at an @c assert, and checks nothing when @c NDEBUG is defined */
+struct ring_buffer_asserts {
+    using status = void;
+#if defined(NDEBUG)
+    static constexpr bool kChecked = false;
+#else
+    static constexpr bool kChecked = true;
+#endif
+    static constexpr void ok() {}
+    static void fail(char const* /*what*/) { assert(!"static_ring_buffer used out of bounds"); }
+};
+
+/** @brief Checks nothing, for callers that already keep every call in bounds */
+struct ring_buffer_unchecked {
+    using status                   = void;
+    static constexpr bool kChecked = false;
+    static constexpr void ok() {}
+    static constexpr void fail(char const* /*what*/) {}
+};
+
+/** @brief Policy when none is given: throw if exceptions are enabled, otherwise assert */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+using ring_buffer_default_policy = ring_buffer_throws;
+#else
+using ring_buffer_default_policy = ring_buffer_asserts;
+#endif
+
+/** @} */
+
+namespace static_ring_buffer_detail {
+
+/** @returns @p index wrapped into @p N slots, for any @p index < 2 * @p N */
+template <std::size_t N>
+constexpr std::size_t wrap(std::size_t index) {
+    // Wrapping uses a mask instead of a compare when the capacity allows it
+    if /*constexpr*/ ((N & (N - 1)) == 0) {
+        return index & (N - 1);
+    }
+    return index >= N ? index - N : index;
+}
+
+/** @brief How a buffer holds its values */
+enum struct Storage {
+    ARRAY,   /**< Trivial types, in a plain array that constant expressions can use */
+    TRIVIAL, /**< Trivially destructible types, in raw bytes, never destroyed */
+    GENERAL, /**< Anything else, in raw bytes, destroyed when removed */
+};
+
+template <typename ValueT>
+constexpr Storage storage_for() {
+    return std::is_trivial<ValueT>::value && std::is_move_assignable<ValueT>::value
+               ? Storage::ARRAY
+               : std::is_trivially_destructible<ValueT>::value ? Storage::TRIVIAL
+                                                               : Storage::GENERAL;
+}
+
+/**
+ * @brief Slots and indices of a @c static_ring_buffer
+ *
+ * Only the @c GENERAL storage has a destructor, so a buffer of trivially
+ * destructible values is trivially destructible itself.
+ */
+template <typename ValueT, std::size_t N, Storage = storage_for<ValueT>()>
+class storage;
+
+template <typename ValueT, std::size_t N>
+class storage<ValueT, N, Storage::ARRAY> {
+   protected:
+    constexpr storage() : rd_{0}, values_{}, size_{0} {}
+
+    constexpr ValueT* data() { return values_; }
+    constexpr ValueT const* data() const { return values_; }
+
+    template <typename... Args>
+    constexpr void construct(std::size_t index, Args&&... args) {
+        values_[index] = ValueT{std::forward<Args>(args)...};
+    }
+
+    constexpr void destroy(std::size_t /*index*/) {}
+
+    std::size_t rd_;
+    ValueT values_[N];
+    std::size_t size_;
+};
+
+template <typename ValueT, std::size_t N>
+class storage<ValueT, N, Storage::TRIVIAL> {
+   protected:
+    constexpr storage() : rd_{0}, buffer_{}, size_{0} {}
+
+    ValueT* data() { return reinterpret_cast<ValueT*>(buffer_); }
+    ValueT const* data() const { return reinterpret_cast<ValueT const*>(buffer_); }
+
+    template <typename... Args>
+    void construct(std::size_t index, Args&&... args) {
+        new (data() + index) ValueT{std::forward<Args>(args)...};
+    }
+
+    void destroy(std::size_t /*index*/) {}
+
+    std::size_t rd_;
+    alignas(ValueT) std::uint8_t buffer_[N * sizeof(ValueT)];
+    std::size_t size_;
+};
+
+template <typename ValueT, std::size_t N>
+class storage<ValueT, N, Storage::GENERAL> : public storage<ValueT, N, Storage::TRIVIAL> {
+   protected:
+    constexpr storage() = default;
+
+    ~storage() {
+        for (std::size_t i = 0; i < this->size_; ++i) {
+            destroy(wrap<N>(this->rd_ + i));
+        }
+    }
+
+    void destroy(std::size_t index) { this->data()[index].~ValueT(); }
+};
+
+}  // namespace static_ring_buffer_detail
+
+/**
+ * @brief Fixed-capacity FIFO queue with inline storage
+ *
+ * Trivial values such as @c EventLogRecord are kept in a plain array, so every
+ * operation can run in a constant expression. Trivially destructible values
+ * such as @c Event are never destroyed, which makes @c consume and the
+ * destructor free. Other values are destroyed as they are removed.
+ *
+ * @tparam ErrorPolicy one of the @ref ring_buffer_policies
+ */
+template <typename ValueT, std::size_t N, typename ErrorPolicy = ring_buffer_default_policy>
+class static_ring_buffer : private static_ring_buffer_detail::storage<ValueT, N> {
     static_assert(N > 0, "effective size of ring buffer must be > 0");
 
+    using storage_type = static_ring_buffer_detail::storage<ValueT, N>;
+    using storage_type::construct;
+    using storage_type::data;
+    using storage_type::destroy;
+    using storage_type::rd_;
+    using storage_type::size_;
+
    public:
-    static_ring_buffer()
-        : wr_p_{reinterpret_cast<ValueT*>(buffer_)},
-          rd_p_{reinterpret_cast<ValueT*>(buffer_)},
-          size_{0} {}
+    using value_type   = ValueT;
+    using size_type    = std::size_t;
+    using error_policy = ErrorPolicy;
+    using status       = typename ErrorPolicy::status;
+
+    /** @brief Contiguous run of stored values */
+    template <typename PointerT>
+    struct basic_segment {
+        PointerT data;
+        std::size_t size;
 
-    ~static_ring_buffer() {
-        while (!empty()) {
-            pop_front();
+        constexpr PointerT begin() const { return data; }
+        constexpr PointerT end() const { return data + size; }
+        constexpr bool empty() const { return size == 0; }
+    };
+
+    using segment       = basic_segment<ValueT*>;
+    using const_segment = basic_segment<ValueT const*>;
+
+    /**
+     * @brief Readable region, oldest values first
+     * @note @c second is empty unless the stored values wrap around the end of the buffer
+     */
+    template <typename SegmentT>
+    struct basic_segments {
+        SegmentT first;
+        SegmentT second;
+    };
+
+    using segments       = basic_segments<segment>;
+    using const_segments = basic_segments<const_segment>;
+
+    /** @brief Iterates stored values from oldest to newest */
+    class const_iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = ValueT;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = ValueT const*;
+        using reference         = ValueT const&;
+
+        constexpr const_iterator() : buffer_{nullptr}, offset_{0} {}
+
+        constexpr reference operator*() const { return buffer_->at_offset(offset_); }
+        constexpr pointer operator->() const { return &buffer_->at_offset(offset_); }
+
+        constexpr const_iterator& operator++() {
+            ++offset_;
+            return *this;
         }
-    }
+
+        constexpr const_iterator operator++(int) {
+            auto const previous = *this;
+            ++offset_;
+            return previous;
+        }
+
+        constexpr bool operator==(const_iterator const& other) const {
+            return buffer_ == other.buffer_ && offset_ == other.offset_;
+        }
+        constexpr bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+       private:
+        friend class static_ring_buffer;
+
+        constexpr const_iterator(static_ring_buffer const* buffer, std::size_t offset)
+            : buffer_{buffer}, offset_{offset} {}
+
+        static_ring_buffer const* buffer_;
+        std::size_t offset_;
+    };
+
+    // Constant-initialized with static storage, so a buffer can live in RTC memory
+    constexpr static_ring_buffer() = default;
+
+    static constexpr std::size_t capacity() { return N; }
 
     constexpr bool empty() const { return size_ == 0; }
 
+    constexpr bool full() const { return size_ == N; }
+
     constexpr std::size_t size() const { return size_; }
 
     template <typename... Args>
-    void emplace_back(Args&&... args) {
-        if /*constexpr*/ (SafeMode) {
-            if (size_ == N) {
-                throw std::range_error{"adding value would exceed max container capacity"};
-            }
+    constexpr status emplace_back(Args&&... args) {
+        if (ErrorPolicy::kChecked && size_ == N) {
+            return ErrorPolicy::fail("adding value would exceed max container capacity");
         }
-        new (wr_p_) ValueT{std::forward<Args>(args)...};
-        ++wr_p_;
+        construct(wrap(rd_ + size_), std::forward<Args>(args)...);
         ++size_;
-        if (wr_p_ == (reinterpret_cast<ValueT*>(buffer_) + N)) {
-            wr_p_ = reinterpret_cast<ValueT*>(buffer_);
-        }
+        return ErrorPolicy::ok();
     }
 
-    constexpr ValueT& front() { return *rd_p_; }
+    constexpr ValueT& front() { return data()[rd_]; }
 
-    void pop_front() {
-        if /*constexpr*/ (SafeMode) {
-            if (size_ == 0) {
-                throw std::range_error{"container is already empty"};
-            }
+    constexpr ValueT const& front() const { return data()[rd_]; }
+
+    constexpr status pop_front() {
+        if (ErrorPolicy::kChecked && size_ == 0) {
+            return ErrorPolicy::fail("container is already empty");
         }
-        rd_p_->~ValueT();
-        ++rd_p_;
+        destroy(rd_);
+        rd_ = wrap(rd_ + 1);
         --size_;
-        if (rd_p_ == (reinterpret_cast<ValueT*>(buffer_) + N)) {
-            rd_p_ = reinterpret_cast<ValueT*>(buffer_);
+        return ErrorPolicy::ok();
+    }
+
+    /**
+     * @brief Copies @p count values to the back of the buffer
+     * @param first Iterator to the first value to copy
+     * @param count Number of values to copy
+     */
+    template <typename InputIt>
+    constexpr status push_n(InputIt first, std::size_t count) {
+        if (ErrorPolicy::kChecked && count > N - size_) {
+            return ErrorPolicy::fail("adding values would exceed max container capacity");
+        }
+        // Fill up to the end of the storage, then continue from the start
+        auto const wr   = wrap(rd_ + size_);
+        auto const head = count < N - wr ? count : N - wr;
+        for (std::size_t i = 0; i < head; ++i, ++first) {
+            construct(wr + i, *first);
+        }
+        for (std::size_t i = 0; i < count - head; ++i, ++first) {
+            construct(i, *first);
+        }
+        size_ += count;
+        return ErrorPolicy::ok();
+    }
+
+    /**
+     * @brief Moves up to @p max_count values, oldest first, to @p out and removes them
+     * @param out Output iterator to write values to
+     * @param max_count Maximum number of values to move
+     * @returns @p out advanced past the last value written
+     */
+    template <typename OutputIt>
+    constexpr OutputIt drain_into(OutputIt out, std::size_t max_count = N) {
+        auto const count = size_ < max_count ? size_ : max_count;
+        auto const head  = count < N - rd_ ? count : N - rd_;
+        for (std::size_t i = 0; i < head; ++i, ++out) {
+            *out = std::move(data()[rd_ + i]);
+            destroy(rd_ + i);
+        }
+        for (std::size_t i = 0; i < count - head; ++i, ++out) {
+            *out = std::move(data()[i]);
+            destroy(i);
+        }
+        rd_ = wrap(rd_ + count);
+        size_ -= count;
+        return out;
+    }
+
+    /**
+     * @brief Removes the @p count oldest values, for use after processing @c readable() in place
+     * @param count Number of values to remove
+     */
+    constexpr status consume(std::size_t count) {
+        if (ErrorPolicy::kChecked && count > size_) {
+            return ErrorPolicy::fail("container holds fewer values than requested");
+        }
+        if (!std::is_trivially_destructible<ValueT>::value) {
+            for (std::size_t i = 0; i < count; ++i) {
+                destroy(wrap(rd_ + i));
+            }
         }
+        rd_ = wrap(rd_ + count);
+        size_ -= count;
+        return ErrorPolicy::ok();
+    }
+
+    /** @returns the stored values as at most two contiguous segments, oldest first */
+    constexpr segments readable() {
+        auto const head = size_ < N - rd_ ? size_ : N - rd_;
+        return segments{segment{data() + rd_, head}, segment{data(), size_ - head}};
     }
 
+    /** @returns the stored values as at most two contiguous segments, oldest first */
+    constexpr const_segments readable() const {
+        auto const head = size_ < N - rd_ ? size_ : N - rd_;
+        return const_segments{const_segment{data() + rd_, head},
+                              const_segment{data(), size_ - head}};
+    }
+
+    constexpr const_iterator begin() const { return const_iterator{this, 0}; }
+    constexpr const_iterator end() const { return const_iterator{this, size_}; }
+    constexpr const_iterator cbegin() const { return begin(); }
+    constexpr const_iterator cend() const { return end(); }
+
    private:
-    ValueT* wr_p_;
-    ValueT* rd_p_;
-    alignas(ValueT) std::uint8_t buffer_[N * sizeof(ValueT)];
-    std::size_t size_;
+    /** @returns @p index wrapped into the storage, for any @p index < 2 * N */
+    static constexpr std::size_t wrap(std::size_t index) {
+        return static_ring_buffer_detail::wrap<N>(index);
+    }
+
+    constexpr ValueT const& at_offset(std::size_t offset) const {
+        return data()[wrap(rd_ + offset)];
+    }
 };
@@ -0,0 +1,227 @@
+// Wake cycle of a health monitor, independent of the hardware it runs on
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+
+// Superspreader
+#include "advertisement.h"
+#include "event_log.h"
+#include "exposure_scan.h"
+#include "health_monitor_core.h"
+#include "persistent_state.h"
+#include "spsc_ring_buffer.h"
+#include "static_ring_buffer.h"
+#include "wake_profile.h"
+
+/** @file **/
+
+constexpr std::uint64_t uS_TO_S_FACTOR = 1000000; /**< Microseconds per second */
+constexpr long TIME_TO_SLEEP           = 5;       /**< Sleep is up to this many seconds */
+constexpr int SCAN_SECONDS             = 3;       /**< Length of the BLE scan on each wake */
+
+/** @brief Why the device woke up */
+enum struct WakeCause {
+    OTHER     = 0, /**< Power on, reset, or a source the game does not use */
+    TIMER     = 1, /**< Sleep timer expired */
+    TREATMENT = 2, /**< Treatment pin went high while asleep */
+};
+
+/** @brief Status LEDs on the health monitor */
+enum struct Led {
+    BLUE  = 0, /**< On while awake */
+    GREEN = 1, /**< Immune, and treatment animation */
+    RED   = 2, /**< Zombie, or blinking while symptomatic */
+};
+
+/** @brief Events raised by ISRs, kept in RTC memory across deep sleep */
+using InterruptEventQueue = spsc_ring_buffer<Event, 2>;
+
+/** @returns period in microseconds at which the red LED blinks for an infected @p health */
+constexpr std::uint64_t get_blink_period(health_t health) {
+    return is_infected_sym(health)        ? 1500000
+           : is_infected_sym_late(health) ? 100000
+                                          : 1000000000;
+}
+
+/**
+ * @brief Runs one wake of the health monitor: show state, advertise, scan, update, sleep
+ *
+ * @p HalT provides the hardware, with these members:
+ * @code
+ *      PersistentState& persistent_state();    // RTC memory, kept across deep sleep
+ *      InterruptEventQueue& interrupt_queue(); // RTC memory, filled by the treatment ISR
+ *      void begin();                           // pins, treatment interrupt, serial
+ *      WakeCause wakeup_cause();
+ *      void set_led(Led led, bool on);
+ *      void blink_led(Led led, std::uint64_t period_us);
+ *      void advertise(char const* display_name, std::uint8_t const* data, std::size_t length);
+ *      template <typename F> void scan(int seconds, F on_device);
+ *          // calls bool on_device(ble_address_t address, int rssi,
+ *          //                      std::uint8_t const* payload, std::size_t length)
+ *          // as advertisements arrive, duplicates included, stopping once it returns false
+ *      void delay_ms(std::uint32_t ms);
+ *      long random(long low, long high);       // in [low, high)
+ *      void log(char const* message);
+ *      void log(char const* label, long value);
+ *      void deep_sleep(std::uint64_t timer_us);  // also wakes on treatment
+ *      std::uint64_t micros();                 // monotonic time in microseconds
+ *      WakeProfile& wake_profile();            // RTC memory, see @c kWakeProfiling
+ *      EventLog& event_log();                  // RTC memory
+ *      void write_event_log(EventLogRecord const* records, std::size_t count);
+ *          // takes records out of RTC memory, such as to the serial log
+ * @endcode
+ * The ESP32 build passes the real hardware, the host build a virtual device.
+ *
+ * The player is loaded from @c persistent_state at the start of the wake and
+ * saved, with a record of the wake, just before sleeping. State that fails its
+ * checks is logged and replaced by a new player.
+ *
+ * Every event @c game_update polls is recorded in @c event_log along with the
+ * health before and after. Once the log is full it is handed to
+ * @c write_event_log and cleared.
+ *
+ * Each phase of the wake is charged to @c wake_profile, and the profile is logged
+ * before sleeping. Building with @c SUPERSPREADER_WAKE_PROFILING set to 0 removes
+ * the clock reads and the log line.
+ *
+ * @p trace receives the trace of @c game_update, which documents the sink
+ * interface. The overload without it traces nothing.
+ */
+template <typename HalT, typename TraceSinkT>
+void run_wake_cycle(HalT& hal, TraceSinkT& trace) {
+    auto& stored      = hal.persistent_state();
+    auto player       = new_player_state();
+    auto const loaded = load_player_state(stored, player);
+
+    // Optimized out along with the clock reads when profiling is disabled
+    WakeProfiler profiler{hal.wake_profile(), kWakeProfiling ? hal.micros() : 0};
+    auto const enter_phase = [&hal, &profiler](WakePhase phase) {
+        if (kWakeProfiling) {
+            profiler.enter(phase, hal.micros());
+        }
+    };
+
+    // Show our state
+    hal.begin();
+    hal.set_led(Led::BLUE, true);
+    if (is_immune(player.health.health)) {
+        hal.set_led(Led::GREEN, true);
+    } else if (is_zombie(player.health.health)) {
+        hal.set_led(Led::RED, true);
+    } else if (is_infected(player.health.health)) {
+        hal.blink_led(Led::RED, get_blink_period(player.health.health));
+    }
+    if (loaded != LoadResult::RESTORED) {
+        hal.log(load_result_message(loaded));
+    }
+    hal.log("Start Health: ", static_cast<long>(player.health.health));
+
+    // Advertise our state to other devices
+    enter_phase(WakePhase::ADVERTISE);
+    auto const advertised = to_advertised_state(player.health.health);
+    std::uint8_t manufacturer_data[kManufacturerDataSize];
+    encode_manufacturer_data(advertised, player.health.health, manufacturer_data);
+    hal.log(to_display_name(advertised));
+    hal.advertise(to_display_name(advertised), manufacturer_data, kManufacturerDataSize);
+
+    // Event queue will hold semi-dynamic events to process on this tick. Every
+    // push below is bounded, so the firmware needs no exception handling for it.
+    static_ring_buffer<Event, 4, ring_buffer_asserts> event_queue;
+
+    // Get any events caused by device wakeup events
+    if (hal.wakeup_cause() == WakeCause::TREATMENT) {
+        event_queue.emplace_back(TreatmentEvent{});
+    }
+
+    // Scan for nearby devices and count infected. A treatment wake is handled
+    // before the exposure, so the scan only needs to matter for the treated health.
+    enter_phase(WakePhase::SCAN);
+    auto const exposed_health = event_queue.empty() ? player.health
+                                                    : treament_update(player.health);
+    auto const exposure       = scan_exposure(hal, SCAN_SECONDS, exposed_health);
+    hal.log("Infected human exposure: ", static_cast<long>(exposure.human));
+    hal.log("Infected cat exposure: ", static_cast<long>(exposure.cat));
+    event_queue.emplace_back(exposure);
+
+    // Run game update for all enqueued events
+    enter_phase(WakePhase::GAME_UPDATE);
+    auto& interrupt_queue = hal.interrupt_queue();
+    bool treated          = false;
+    auto logged           = begin_event_log_record(player);
+    game_update(
+        player,
+        // get next event
+        [&event_queue, &interrupt_queue, &logged]() -> Event {
+            Event next_event;  // null state
+
+            // Events from ISRs join the back of the queue, as if they were polled now.
+            // Presses that do not fit yet stay in the ISR queue for the next poll.
+            while (!interrupt_queue.empty() && !event_queue.full()) {
+                event_queue.emplace_back(interrupt_queue.front());
+                interrupt_queue.pop_front();
+            }
+
+            if (!event_queue.empty()) {
+                next_event = event_queue.front();
+                event_queue.pop_front();
+                log_event(logged, next_event);
+            }
+
+            return next_event;
+        },
+        // on exposure
+        [&hal](ExposureEvent const&) { hal.log("Player exposed to virus"); },
+        // on treatment
+        [&hal, &enter_phase, &treated](TreatmentEvent const&) {
+            hal.log("Player administered treatment");
+            treated = true;
+            enter_phase(WakePhase::TREATMENT);
+
+            // Two slow blinks, then eight fast blinks
+            for (int n = 0; n < 2; ++n) {
+                hal.set_led(Led::GREEN, true);
+                hal.delay_ms(1000);
+                hal.set_led(Led::GREEN, false);
+                hal.delay_ms(1000);
+            }
+            for (int n = 0; n < 8; ++n) {
+                hal.set_led(Led::GREEN, true);
+                hal.delay_ms(100);
+                hal.set_led(Led::GREEN, false);
+                hal.delay_ms(100);
+            }
+            enter_phase(WakePhase::GAME_UPDATE);
+        },
+        trace);
+
+    hal.log("End Health: ", static_cast<long>(player.health.health));
+    save_player_state(player, make_wake_record(player, exposure, treated), stored);
+    end_event_log_record(logged, player);
+    auto& event_log = hal.event_log();
+    if (append_event_log(event_log, logged)) {
+        auto const records = event_log.readable();
+        hal.write_event_log(records.first.data, records.first.size);
+        hal.write_event_log(records.second.data, records.second.size);
+        event_log.consume(event_log.size());
+    }
+
+    // Wake up again in some amount of time, or when treated
+    auto const sleep_us = static_cast<std::uint64_t>(hal.random(1, TIME_TO_SLEEP)) * uS_TO_S_FACTOR;
+    if (kWakeProfiling) {
+        profiler.finish(hal.micros(), sleep_us);
+        char line[kWakeProfileLineSize];
+        format_wake_profile(hal.wake_profile(), line, sizeof(line));
+        hal.log(line);
+    }
+    hal.deep_sleep(sleep_us);
+}
+
+/** @brief Runs one wake of the health monitor without tracing, see above */
+template <typename HalT>
+void run_wake_cycle(HalT& hal) {
+    NullTraceSink trace;
+    run_wake_cycle(hal, trace);
+}
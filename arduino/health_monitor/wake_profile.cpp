@@ -0,0 +1,85 @@
+// C++ Standard Library
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Superspreader
+#include "wake_profile.h"
+
+namespace {
+
+constexpr char kRecordTag[]      = "wake_profile,";
+constexpr unsigned kRecordFormat = 1;
+
+// Indexed by WakePhase
+constexpr char const* kPhaseNames[kNumWakePhases] = {
+    "setup",
+    "advertise",
+    "scan",
+    "game_update",
+    "treatment",
+    "deep_sleep",
+};
+
+/** @brief Reads an unsigned field followed by a comma or the end of the line */
+bool parse_field(char const*& cursor, std::uint64_t& value) {
+    char* end = nullptr;
+    value     = std::strtoull(cursor, &end, 10);
+    if (end == cursor || (*end != ',' && *end != '\0' && *end != '\n' && *end != '\r')) {
+        return false;
+    }
+    cursor = *end == ',' ? end + 1 : end;
+    return true;
+}
+
+}  // namespace
+
+char const* wake_phase_name(WakePhase phase) {
+    auto const index = static_cast<std::size_t>(phase);
+    return index < kNumWakePhases ? kPhaseNames[index] : "";
+}
+
+std::size_t format_wake_profile(WakeProfile const& profile, char* out, std::size_t size) {
+    auto written = std::snprintf(out, size, "%s%u,%" PRIu32, kRecordTag, kRecordFormat,
+                                 profile.wakes);
+    for (std::size_t i = 0; i < kNumWakePhases; ++i) {
+        if (written <= 0 || static_cast<std::size_t>(written) >= size) {
+            return 0;
+        }
+        written += std::snprintf(out + written,
+                                 size - written,
+                                 ",%" PRIu64 ",%" PRIu64,
+                                 profile.duration_us[i],
+                                 profile.energy_nj[i]);
+    }
+    // A truncated line would not parse, so nothing is written
+    return written > 0 && static_cast<std::size_t>(written) < size
+               ? static_cast<std::size_t>(written)
+               : 0;
+}
+
+bool parse_wake_profile(char const* line, WakeProfile& profile) {
+    auto const* cursor = std::strstr(line, kRecordTag);
+    if (cursor == nullptr) {
+        return false;
+    }
+    cursor += sizeof(kRecordTag) - 1;
+
+    std::uint64_t format = 0;
+    std::uint64_t wakes  = 0;
+    if (!parse_field(cursor, format) || format != kRecordFormat || !parse_field(cursor, wakes)) {
+        return false;
+    }
+
+    WakeProfile parsed{};
+    parsed.wakes = static_cast<std::uint32_t>(wakes);
+    for (std::size_t i = 0; i < kNumWakePhases; ++i) {
+        if (!parse_field(cursor, parsed.duration_us[i]) ||
+            !parse_field(cursor, parsed.energy_nj[i])) {
+            return false;
+        }
+    }
+    profile = parsed;
+    return true;
+}
@@ -0,0 +1,129 @@
+// Per-phase time and energy accounting for the wake cycle, kept across deep sleep
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+
+/** @file **/
+
+// Define as 1 to profile each wake, logged to serial before sleeping; the host tools enable it
+#ifndef SUPERSPREADER_WAKE_PROFILING
+#define SUPERSPREADER_WAKE_PROFILING 0
+#endif
+
+/** @brief true if @c run_wake_cycle records a @c WakeProfile */
+constexpr bool kWakeProfiling = SUPERSPREADER_WAKE_PROFILING != 0;
+
+/** @brief Consecutive phases of a wake, plus the sleep that follows */
+enum struct WakePhase : std::uint8_t {
+    SETUP       = 0, /**< Pins, serial and status LEDs */
+    ADVERTISE   = 1, /**< BLE init and start of advertising */
+    SCAN        = 2, /**< BLE scan for nearby devices */
+    GAME_UPDATE = 3, /**< Event processing */
+    TREATMENT   = 4, /**< Treatment animation */
+    DEEP_SLEEP  = 5, /**< Requested sleep until the next timer wake */
+};
+
+/** @brief Number of @c WakePhase values */
+constexpr std::size_t kNumWakePhases = 6;
+
+/**
+ * @brief Estimated average power draw of the ESP32 in each phase, in microwatts
+ * @note From datasheet currents at 3.3 V: CPU only ~40 mA, CPU with BLE radio
+ *       ~100 mA, plus ~5 mA for the LED during treatment, deep sleep ~10 uA.
+ *       Advertising stays on from @c ADVERTISE until sleep.
+ */
+constexpr std::uint32_t kPhasePowerUw[kNumWakePhases] = {
+    132000,  // SETUP
+    330000,  // ADVERTISE
+    330000,  // SCAN
+    330000,  // GAME_UPDATE
+    346500,  // TREATMENT
+    33,      // DEEP_SLEEP
+};
+
+/**
+ * @brief Time and estimated energy accumulated over every wake since power on
+ * @note Plain data, so it can live in RTC memory
+ */
+struct WakeProfile {
+    std::uint32_t wakes;                          /**< Completed wakes */
+    std::uint64_t duration_us[kNumWakePhases];    /**< Time spent in each phase */
+    std::uint64_t energy_nj[kNumWakePhases];      /**< Estimated energy used in each phase */
+};
+
+/** @returns short lower case name of @p phase, such as "scan" */
+char const* wake_phase_name(WakePhase phase);
+
+/**
+ * @brief Charges time to the current phase of one wake
+ *
+ * Each @c enter charges the time since the previous mark to the phase being
+ * left, so the phases of a wake cover it without gaps.
+ */
+class WakeProfiler {
+   public:
+    /**
+     * @param profile accumulated profile to add this wake to
+     * @param now_us current time in microseconds
+     */
+    WakeProfiler(WakeProfile& profile, std::uint64_t now_us)
+        : profile_{profile}, phase_{WakePhase::SETUP}, since_us_{now_us} {}
+
+    /** @brief Ends the current phase and starts @p phase at @p now_us */
+    void enter(WakePhase phase, std::uint64_t now_us) {
+        charge(phase_, now_us - since_us_);
+        phase_    = phase;
+        since_us_ = now_us;
+    }
+
+    /** @returns phase currently being charged */
+    WakePhase phase() const { return phase_; }
+
+    /**
+     * @brief Ends the wake before going to sleep
+     * @param now_us current time in microseconds
+     * @param sleep_us requested sleep, charged to @c WakePhase::DEEP_SLEEP
+     */
+    void finish(std::uint64_t now_us, std::uint64_t sleep_us) {
+        charge(phase_, now_us - since_us_);
+        charge(WakePhase::DEEP_SLEEP, sleep_us);
+        ++profile_.wakes;
+    }
+
+   private:
+    void charge(WakePhase phase, std::uint64_t duration_us) {
+        auto const index = static_cast<std::size_t>(phase);
+        profile_.duration_us[index] += duration_us;
+        profile_.energy_nj[index] += duration_us * kPhasePowerUw[index] / 1000;
+    }
+
+    WakeProfile& profile_;
+    WakePhase phase_;
+    std::uint64_t since_us_;
+};
+
+/** @brief Longest line written by @c format_wake_profile, including the terminator */
+constexpr std::size_t kWakeProfileLineSize = 32 + kNumWakePhases * 2 * 21;
+
+/**
+ * @brief Writes @p profile as one text line for the serial log
+ * @code
+ *      wake_profile,1,<wakes>,<duration_us>,<energy_nj>,... one pair per phase
+ * @endcode
+ * @param profile profile to write
+ * @param out buffer of at least @c kWakeProfileLineSize characters
+ * @param size size of @p out
+ * @returns number of characters written, excluding the terminator, or 0 if @p out is too small
+ */
+std::size_t format_wake_profile(WakeProfile const& profile, char* out, std::size_t size);
+
+/**
+ * @brief Reads a line written by @c format_wake_profile
+ * @param line null terminated text, possibly with other text before the record
+ * @param profile set from @p line on success
+ * @returns false, leaving @p profile untouched, if @p line holds no valid record
+ */
+bool parse_wake_profile(char const* line, WakeProfile& profile);
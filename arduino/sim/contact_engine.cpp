@@ -0,0 +1,351 @@
+// C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Superspreader
+#include "contact_engine.h"
+
+namespace {
+
+// Marks devices that advertise nothing the firmware counts
+constexpr auto kNoCell = std::numeric_limits<std::uint32_t>::max();
+
+}  // namespace
+
+double RssiModel::rssi_at(double distance) const {
+    return tx_power - 10.0 * path_loss_exponent * std::log10(distance);
+}
+
+double RssiModel::range() const {
+    return std::pow(10.0, (tx_power - RSSI_LOWER_BOUND) / (10.0 * path_loss_exponent));
+}
+
+ContactEngine::ContactEngine(float width, float height, RssiModel const& rssi, thread_pool& pool)
+    : range_{static_cast<float>(rssi.range())},
+      range_squared_{range_ * range_},
+      // Cells are at least one range wide, so every close beacon is in a neighbouring cell
+      columns_{std::max<std::size_t>(1, static_cast<std::size_t>(width / range_))},
+      rows_{std::max<std::size_t>(1, static_cast<std::size_t>(height / range_))},
+      inverse_cell_width_{static_cast<float>(columns_) / width},
+      inverse_cell_height_{static_cast<float>(rows_) / height},
+      pool_{pool},
+      cell_start_(columns_ * rows_ + 1, 0),
+      worker_offsets_(pool.size() * columns_ * rows_, 0) {}
+
+std::size_t ContactEngine::cell_of(float x, float y) const {
+    // Clamp so devices on (or slightly past) the far walls land in the last cell
+    auto const column =
+        std::min(static_cast<std::size_t>(std::max(0.0f, x * inverse_cell_width_)), columns_ - 1);
+    auto const row =
+        std::min(static_cast<std::size_t>(std::max(0.0f, y * inverse_cell_height_)), rows_ - 1);
+    return row * columns_ + column;
+}
+
+void ContactEngine::build(float const* x,
+                          float const* y,
+                          Beacon const* beacons,
+                          std::size_t count,
+                          std::uint32_t const* ids) {
+    auto const cells = columns_ * rows_;
+    device_cell_.resize(count);
+    std::fill(worker_offsets_.begin(), worker_offsets_.end(), 0);
+
+    // Histogram counted beacons per cell, one histogram per worker
+    pool_.parallel_for(count, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        auto* const histogram = worker_offsets_.data() + worker * cells;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (beacons[i] == Beacon::NONE) {
+                device_cell_[i] = kNoCell;
+                continue;
+            }
+            auto const cell = static_cast<std::uint32_t>(cell_of(x[i], y[i]));
+            device_cell_[i] = cell;
+            ++histogram[cell];
+        }
+    });
+
+    // Turn histograms into write offsets. Workers own consecutive device ranges, so
+    // stacking them in worker order keeps each cell sorted by device id.
+    std::uint32_t total = 0;
+    for (std::size_t cell = 0; cell < cells; ++cell) {
+        cell_start_[cell] = total;
+        for (std::size_t worker = 0; worker < pool_.size(); ++worker) {
+            auto& offset       = worker_offsets_[worker * cells + cell];
+            auto const in_cell = offset;
+            offset             = total;
+            total += in_cell;
+        }
+    }
+    cell_start_[cells] = total;
+
+    sorted_x_.resize(total);
+    sorted_y_.resize(total);
+    sorted_beacon_.resize(total);
+    sorted_id_.resize(total);
+
+    pool_.parallel_for(count, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        auto* const offsets = worker_offsets_.data() + worker * cells;
+        for (std::size_t i = begin; i < end; ++i) {
+            auto const cell = device_cell_[i];
+            if (cell == kNoCell) {
+                continue;
+            }
+            auto const slot      = offsets[cell]++;
+            sorted_x_[slot]      = x[i];
+            sorted_y_[slot]      = y[i];
+            sorted_beacon_[slot] = beacons[i];
+            sorted_id_[slot]     = ids != nullptr ? ids[i] : static_cast<std::uint32_t>(i);
+        }
+    });
+}
+
+void ContactEngine::count_exposures(float const* x,
+                                    float const* y,
+                                    std::size_t receivers,
+                                    std::uint8_t const* listening,
+                                    health_t* human,
+                                    health_t* cat) const {
+    pool_.parallel_for(receivers, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (listening != nullptr && !listening[i]) {
+                human[i] = 0;
+                cat[i]   = 0;
+                continue;
+            }
+            count_close(x[i], y[i], i, human[i], cat[i]);
+        }
+    });
+}
+
+void ContactEngine::count_exposures_of(float const* x,
+                                       float const* y,
+                                       std::uint32_t const* players,
+                                       std::size_t count,
+                                       health_t* human,
+                                       health_t* cat) const {
+    pool_.parallel_for(count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t k = begin; k < end; ++k) {
+            auto const i = players[k];
+            count_close(x[i], y[i], i, human[i], cat[i]);
+        }
+    });
+}
+
+void ContactEngine::count_close(float px,
+                                float py,
+                                std::size_t self,
+                                health_t& human,
+                                health_t& cat) const {
+    auto const cell   = cell_of(px, py);
+    auto const column = cell % columns_;
+    auto const row    = cell / columns_;
+
+    auto const first_column = column > 0 ? column - 1 : 0;
+    auto const last_column  = std::min(column + 1, columns_ - 1);
+    auto const first_row    = row > 0 ? row - 1 : 0;
+    auto const last_row     = std::min(row + 1, rows_ - 1);
+
+    health_t human_count = 0;
+    health_t cat_count   = 0;
+    for (auto r = first_row; r <= last_row; ++r) {
+        auto const run_begin = cell_start_[r * columns_ + first_column];
+        auto const run_end   = cell_start_[r * columns_ + last_column + 1];
+        for (auto k = run_begin; k < run_end; ++k) {
+            auto const dx = sorted_x_[k] - px;
+            auto const dy = sorted_y_[k] - py;
+            if (dx * dx + dy * dy > range_squared_ || sorted_id_[k] == self) {
+                continue;
+            }
+            if (sorted_beacon_[k] == Beacon::CAT) {
+                ++cat_count;
+            } else {
+                ++human_count;
+            }
+        }
+    }
+    human = human_count;
+    cat   = cat_count;
+}
+
+IncrementalContactEngine::IncrementalContactEngine(float width,
+                                                   float height,
+                                                   RssiModel const& rssi,
+                                                   thread_pool& pool)
+    : pool_{pool},
+      all_{width, height, rssi, pool},
+      before_{width, height, rssi, pool},
+      after_{width, height, rssi, pool},
+      worker_changes_(pool.size()),
+      worker_recounts_(pool.size()),
+      worker_overflow_(pool.size(), false) {}
+
+void IncrementalContactEngine::update(float const* x,
+                                      float const* y,
+                                      Beacon const* beacons,
+                                      std::size_t count,
+                                      std::size_t receivers,
+                                      std::uint8_t const* listening) {
+    if (x_.size() != count || human_.size() != receivers) {
+        // Nothing to compare against yet: take the crowd as it is
+        x_.assign(x, x + count);
+        y_.assign(y, y + count);
+        beacons_.assign(beacons, beacons + count);
+        human_.resize(receivers);
+        cat_.resize(receivers);
+        counted_.resize(receivers);
+        patched_.resize(receivers);
+        human_before_.resize(receivers);
+        cat_before_.resize(receivers);
+        human_after_.resize(receivers);
+        cat_after_.resize(receivers);
+        changes_.clear();
+        recount(x, y, beacons, count, receivers, listening);
+        return;
+    }
+
+    if (!find_changes(x, y, beacons, count, receivers, listening)) {
+        recount(x, y, beacons, count, receivers, listening);
+        return;
+    }
+    recounted_ = false;
+    apply_changes(x, y, beacons, count, receivers);
+}
+
+bool IncrementalContactEngine::find_changes(float const* x,
+                                            float const* y,
+                                            Beacon const* beacons,
+                                            std::size_t count,
+                                            std::size_t receivers,
+                                            std::uint8_t const* listening) {
+    pool_.parallel_for(count, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        auto& changes  = worker_changes_[worker];
+        auto& recounts = worker_recounts_[worker];
+        changes.clear();
+        recounts.clear();
+        worker_overflow_[worker] = false;
+
+        auto const limit = (end - begin) / kRecountDivisor;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (changes.size() + recounts.size() > limit) {
+                // Too much changed to patch, only keep the snapshot for the next update
+                std::copy(x + i, x + end, x_.begin() + static_cast<std::ptrdiff_t>(i));
+                std::copy(y + i, y + end, y_.begin() + static_cast<std::ptrdiff_t>(i));
+                std::copy(beacons + i,
+                          beacons + end,
+                          beacons_.begin() + static_cast<std::ptrdiff_t>(i));
+                worker_overflow_[worker] = true;
+                break;
+            }
+
+            auto const moved = x[i] != x_[i] || y[i] != y_[i];
+            if (i < receivers) {
+                // A player whose count was zeroed, or who hears a different crowd, starts over
+                auto const listens = listening == nullptr || listening[i];
+                patched_[i]        = listens && counted_[i] && !moved;
+                if (!listens) {
+                    human_[i] = 0;
+                    cat_[i]   = 0;
+                } else if (!patched_[i]) {
+                    recounts.push_back(static_cast<std::uint32_t>(i));
+                }
+                counted_[i] = listens;
+            }
+            if (!moved && beacons[i] == beacons_[i]) {
+                continue;
+            }
+            changes.push_back(Change{static_cast<std::uint32_t>(i), x_[i], y_[i], beacons_[i]});
+            x_[i]       = x[i];
+            y_[i]       = y[i];
+            beacons_[i] = beacons[i];
+        }
+    });
+
+    // Workers own consecutive device ranges, so this keeps both lists in device order
+    changes_.clear();
+    recounts_.clear();
+    for (std::size_t worker = 0; worker < pool_.size(); ++worker) {
+        if (worker_overflow_[worker]) {
+            return false;
+        }
+        changes_.insert(
+            changes_.end(), worker_changes_[worker].begin(), worker_changes_[worker].end());
+        recounts_.insert(
+            recounts_.end(), worker_recounts_[worker].begin(), worker_recounts_[worker].end());
+    }
+    return (changes_.size() + recounts_.size()) * kRecountDivisor <= count;
+}
+
+void IncrementalContactEngine::apply_changes(float const* x,
+                                             float const* y,
+                                             Beacon const* beacons,
+                                             std::size_t count,
+                                             std::size_t receivers) {
+    if (!recounts_.empty()) {
+        all_.build(x, y, beacons, count);
+        all_.count_exposures_of(
+            x, y, recounts_.data(), recounts_.size(), human_.data(), cat_.data());
+    }
+
+    before_beacons_.clear();
+    after_beacons_.clear();
+    for (auto const& change : changes_) {
+        before_beacons_.add(change.id, change.x, change.y, change.beacon);
+        after_beacons_.add(change.id, x[change.id], y[change.id], beacons[change.id]);
+    }
+    if (before_beacons_.ids.empty() && after_beacons_.ids.empty()) {
+        return;
+    }
+
+    // Patched players only hear a difference from the beacons that changed
+    before_beacons_.build(before_);
+    after_beacons_.build(after_);
+    before_.count_exposures(
+        x, y, receivers, patched_.data(), human_before_.data(), cat_before_.data());
+    after_.count_exposures(
+        x, y, receivers, patched_.data(), human_after_.data(), cat_after_.data());
+    pool_.parallel_for(receivers, [this](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            human_[i] = static_cast<health_t>(human_[i] + human_after_[i] - human_before_[i]);
+            cat_[i]   = static_cast<health_t>(cat_[i] + cat_after_[i] - cat_before_[i]);
+        }
+    });
+}
+
+void IncrementalContactEngine::recount(float const* x,
+                                       float const* y,
+                                       Beacon const* beacons,
+                                       std::size_t count,
+                                       std::size_t receivers,
+                                       std::uint8_t const* listening) {
+    recounted_ = true;
+    all_.build(x, y, beacons, count);
+    all_.count_exposures(x, y, receivers, listening, human_.data(), cat_.data());
+    for (std::size_t i = 0; i < receivers; ++i) {
+        counted_[i] = listening == nullptr || listening[i];
+    }
+}
+
+void IncrementalContactEngine::ChangedBeacons::clear() {
+    x.clear();
+    y.clear();
+    beacons.clear();
+    ids.clear();
+}
+
+void IncrementalContactEngine::ChangedBeacons::add(std::uint32_t id,
+                                                   float at_x,
+                                                   float at_y,
+                                                   Beacon beacon) {
+    if (beacon == Beacon::NONE) {
+        return;
+    }
+    ids.push_back(id);
+    x.push_back(at_x);
+    y.push_back(at_y);
+    beacons.push_back(beacon);
+}
+
+void IncrementalContactEngine::ChangedBeacons::build(ContactEngine& engine) const {
+    engine.build(x.data(), y.data(), beacons.data(), ids.size(), ids.data());
+}
@@ -0,0 +1,271 @@
+// Spatial-hash contact engine turning player positions into exposure events
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_core.h"
+#include "proximity.h"
+#include "thread_pool.h"
+
+/** @file **/
+
+/**
+ * @brief Log-distance path loss model for the received signal strength of a monitor
+ *
+ * RSSI(d) = @c tx_power - 10 * @c path_loss_exponent * log10(d / 1 m)
+ */
+struct RssiModel {
+    double tx_power           = -59.0; /**< RSSI at 1 m in dBm */
+    double path_loss_exponent = 2.0;   /**< 2 in free space, higher indoors and in crowds */
+
+    /** @returns expected RSSI in dBm of a device @p distance meters away */
+    double rssi_at(double distance) const;
+
+    /** @returns largest distance in meters at which @c is_close holds */
+    double range() const;
+};
+
+/** @brief What a device advertises, as far as a scanning monitor is concerned */
+enum struct Beacon : std::uint8_t {
+    NONE           = 0, /**< Not counted by the firmware (healthy or immune monitor) */
+    INFECTED_HUMAN = 1, /**< Counted in @c ExposureEvent::human */
+    CAT            = 2, /**< Counted in @c ExposureEvent::cat */
+};
+
+/**
+ * @brief Counts close contacts for every player of a crowd in O(N)
+ *
+ * Beacons are bucketed into a uniform grid of cells at least @c RssiModel::range
+ * wide, stored cell by cell with a counting sort. A player then only tests the
+ * beacons in its own and the 8 surrounding cells, so the cost grows with the
+ * number of players times the local density instead of the square of the crowd.
+ * Because cells are stored row-major, the 3 cells of each row are one contiguous
+ * run.
+ *
+ * Both the build and the query are split across a @c thread_pool. Results do not
+ * depend on the number of workers.
+ */
+class ContactEngine {
+   public:
+    /**
+     * @brief Creates an engine for a rectangular venue
+     * @param width venue extent along x in meters
+     * @param height venue extent along y in meters
+     * @param rssi signal model deciding which devices are close
+     * @param pool workers to split the crowd across
+     */
+    ContactEngine(float width, float height, RssiModel const& rssi, thread_pool& pool);
+
+    /** @returns distance in meters within which a beacon is counted */
+    float range() const { return range_; }
+
+    /**
+     * @brief Buckets every device that advertises a counted beacon
+     * @param x position of each device along x, in [0, width]
+     * @param y position of each device along y, in [0, height]
+     * @param beacons what each device advertises
+     * @param count number of devices
+     * @param ids player id of each device, used to skip a player's own beacon, or nullptr if
+     *        devices are players [0, count)
+     */
+    void build(float const* x,
+               float const* y,
+               Beacon const* beacons,
+               std::size_t count,
+               std::uint32_t const* ids = nullptr);
+
+    /**
+     * @brief Counts the beacons close to each receiving player, excluding itself
+     * @param x position of each player along x
+     * @param y position of each player along y
+     * @param receivers number of players, taken to be devices [0, receivers) of @c build
+     * @param listening non-zero for each player whose contacts matter, or nullptr for all.
+     *        Other players are skipped and get zero contacts.
+     * @param human infected human contacts of each player, written
+     * @param cat cat contacts of each player, written
+     */
+    void count_exposures(float const* x,
+                         float const* y,
+                         std::size_t receivers,
+                         std::uint8_t const* listening,
+                         health_t* human,
+                         health_t* cat) const;
+
+    /**
+     * @brief Counts the beacons close to the listed players only, excluding themselves
+     * @param x position of each player along x, indexed by player id
+     * @param y position of each player along y, indexed by player id
+     * @param players ids of the players to count for
+     * @param count number of listed players
+     * @param human infected human contacts, written for the listed players only
+     * @param cat cat contacts, written for the listed players only
+     */
+    void count_exposures_of(float const* x,
+                            float const* y,
+                            std::uint32_t const* players,
+                            std::size_t count,
+                            health_t* human,
+                            health_t* cat) const;
+
+   private:
+    std::size_t cell_of(float x, float y) const;
+    void count_close(float x, float y, std::size_t self, health_t& human, health_t& cat) const;
+
+    float range_;
+    float range_squared_;
+    std::size_t columns_;
+    std::size_t rows_;
+    float inverse_cell_width_;
+    float inverse_cell_height_;
+    thread_pool& pool_;
+
+    // Counted beacons sorted by cell; beacons of cell c are [cell_start_[c], cell_start_[c + 1])
+    std::vector<std::uint32_t> cell_start_;
+    std::vector<float> sorted_x_;
+    std::vector<float> sorted_y_;
+    std::vector<Beacon> sorted_beacon_;
+    std::vector<std::uint32_t> sorted_id_;
+
+    // Build scratch: cell of each device and per-worker cell histograms, then write offsets
+    std::vector<std::uint32_t> device_cell_;
+    std::vector<std::uint32_t> worker_offsets_;
+};
+
+/**
+ * @brief Keeps every player's close-contact counts up to date from what changed since last tick
+ *
+ * Between ticks most players keep their display class, so most beacons do not
+ * change, and in a slow crowd most devices stay put. @c update compares every
+ * device's position and beacon with the previous call. A player that stayed put
+ * only needs the devices that changed: two small @c ContactEngine grids hold the
+ * changed beacons as they were and as they are, and the player adds the close
+ * ones of the second and takes away those of the first. A player that moved, or
+ * starts listening, is recounted against every beacon. When more than
+ * 1 / @c kRecountDivisor of the devices need either, every player is recounted.
+ *
+ * Counts are those @c ContactEngine::count_exposures gives for the same crowd,
+ * including the zeros of players not listening, for any number of workers.
+ */
+class IncrementalContactEngine {
+   public:
+    /** @brief Share of changed devices, as a divisor, above which every player is recounted */
+    static constexpr std::size_t kRecountDivisor = 8;
+
+    /**
+     * @brief Creates an engine for a rectangular venue
+     * @param width venue extent along x in meters
+     * @param height venue extent along y in meters
+     * @param rssi signal model deciding which devices are close
+     * @param pool workers to split the crowd across
+     */
+    IncrementalContactEngine(float width, float height, RssiModel const& rssi, thread_pool& pool);
+
+    /**
+     * @brief Brings the counts up to date with the crowd as it is now
+     * @param x position of each device along x, in [0, width]
+     * @param y position of each device along y, in [0, height]
+     * @param beacons what each device advertises
+     * @param count number of devices, the same on every call
+     * @param receivers number of players, taken to be devices [0, receivers)
+     * @param listening non-zero for each player whose contacts matter, or nullptr for all.
+     *        Other players get zero contacts.
+     */
+    void update(float const* x,
+                float const* y,
+                Beacon const* beacons,
+                std::size_t count,
+                std::size_t receivers,
+                std::uint8_t const* listening);
+
+    /** @returns infected human contacts of each player, as of the last @c update */
+    health_t const* human() const { return human_.data(); }
+
+    /** @returns cat contacts of each player, as of the last @c update */
+    health_t const* cat() const { return cat_.data(); }
+
+    /** @returns true if the last @c update recounted every player */
+    bool recounted() const { return recounted_; }
+
+   private:
+    /** @brief A device that changed, as it was before the change */
+    struct Change {
+        std::uint32_t id;
+        float x;
+        float y;
+        Beacon beacon;
+    };
+
+    /** @brief Counted beacons of some changed devices, laid out for @c ContactEngine::build */
+    struct ChangedBeacons {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<Beacon> beacons;
+        std::vector<std::uint32_t> ids;
+
+        void clear();
+        void add(std::uint32_t id, float at_x, float at_y, Beacon beacon);
+        void build(ContactEngine& engine) const;
+    };
+
+    /** @returns false if so much changed that every player should be recounted */
+    bool find_changes(float const* x,
+                      float const* y,
+                      Beacon const* beacons,
+                      std::size_t count,
+                      std::size_t receivers,
+                      std::uint8_t const* listening);
+
+    void apply_changes(float const* x,
+                       float const* y,
+                       Beacon const* beacons,
+                       std::size_t count,
+                       std::size_t receivers);
+    void recount(float const* x,
+                 float const* y,
+                 Beacon const* beacons,
+                 std::size_t count,
+                 std::size_t receivers,
+                 std::uint8_t const* listening);
+
+    thread_pool& pool_;
+    ContactEngine all_;
+    ContactEngine before_;
+    ContactEngine after_;
+    bool recounted_ = false;
+
+    // Counts of every player, and whether they were counted or zeroed for not listening
+    std::vector<health_t> human_;
+    std::vector<health_t> cat_;
+    std::vector<std::uint8_t> counted_;
+
+    // Every device as of the last update
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<Beacon> beacons_;
+
+    // Non-zero for each player whose count is patched from the changes this update
+    std::vector<std::uint8_t> patched_;
+
+    // Changes and players to recount found this update, in device order, and per-worker
+    // scratch for finding them
+    std::vector<Change> changes_;
+    std::vector<std::uint32_t> recounts_;
+    std::vector<std::vector<Change>> worker_changes_;
+    std::vector<std::vector<std::uint32_t>> worker_recounts_;
+    std::vector<std::uint8_t> worker_overflow_;
+
+    // Counted beacons among the changed devices, before and after
+    ChangedBeacons before_beacons_;
+    ChangedBeacons after_beacons_;
+
+    // Close beacons among the changed devices, per patched player
+    std::vector<health_t> human_before_;
+    std::vector<health_t> cat_before_;
+    std::vector<health_t> human_after_;
+    std::vector<health_t> cat_after_;
+};
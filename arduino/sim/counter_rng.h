@@ -0,0 +1,46 @@
+// Stateless random number helpers for reproducible parallel simulation
+
+#pragma once
+
+// C++ Standard Library
+#include <cstdint>
+
+/** @file **/
+
+/**
+ * @brief SplitMix64 finalizer, used to turn a counter into a random word
+ * @param x value to mix
+ * @returns well-distributed 64 bit hash of @p x
+ */
+constexpr std::uint64_t mix64(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Small random stream keyed by (seed, tick, id)
+ *
+ * Every player draws from its own stream on every tick, so results do not
+ * depend on how players are split between threads or in which order they run.
+ */
+class counter_rng {
+   public:
+    constexpr counter_rng(std::uint64_t seed, std::uint64_t tick, std::uint64_t id)
+        : state_{mix64(seed ^ mix64(tick * 0x9e3779b97f4a7c15ULL ^ mix64(id)))} {}
+
+    /** @returns next 64 random bits */
+    std::uint64_t next() {
+        state_ += 0x9e3779b97f4a7c15ULL;
+        return mix64(state_);
+    }
+
+    /** @returns uniform value in [0, bound) for bound <= 2^32, using multiply-shift reduction */
+    std::uint64_t below(std::uint64_t bound) { return ((next() >> 32) * bound) >> 32; }
+
+    /** @returns uniform value in [0, 1) */
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+   private:
+    std::uint64_t state_;
+};
@@ -0,0 +1,185 @@
+// Extracts, verifies and replays health monitor event logs
+//
+// Devices write their event log to serial as event_log lines. extract turns a
+// serial capture into a binary dump file; verify and replay memory-map dump
+// files and split the records across every core.
+//
+// Example:
+//   superspreader_event_log extract --device 7 device7.sslog < serial.log
+//   superspreader_event_log verify logs/*.sslog
+//   superspreader_event_log replay --rules cat-resistant logs/*.sslog > outcomes.csv
+
+// C++ Standard Library
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "event_log_replay.h"
+#include "game_rules.h"
+#include "thread_pool.h"
+
+namespace {
+
+struct Options {
+    std::string command;
+    std::uint32_t device = 0;
+    std::size_t threads  = 0;
+    std::string rules    = "default";
+    std::vector<std::string> files;
+};
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s extract [--device N] OUT < serial.log\n"
+                 "       %s verify [options] FILE...\n"
+                 "       %s replay [options] FILE...\n"
+                 "  --device N        device id stored in the dump file (default 0)\n"
+                 "  --threads N       worker threads, 0 for all cores (default 0)\n"
+                 "  --rules NAME      replay rules: default or cat-resistant (default default)\n",
+                 program,
+                 program,
+                 program);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    if (argc < 2) {
+        return false;
+    }
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            options.files.push_back(arg);
+        } else if (i + 1 >= argc) {
+            return false;
+        } else if (arg == "--device") {
+            options.device = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--threads") {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rules") {
+            options.rules = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (options.command == "extract") {
+        return options.files.size() == 1;
+    }
+    return (options.command == "verify" || options.command == "replay") &&
+           !options.files.empty() &&
+           (options.rules == "default" || options.rules == "cat-resistant");
+}
+
+int extract(Options const& options) {
+    std::vector<EventLogRecord> records;
+    char line[1024];
+    while (std::fgets(line, sizeof(line), stdin) != nullptr) {
+        EventLogRecord record;
+        if (parse_event_log_record(line, record)) {
+            records.push_back(record);
+        }
+    }
+    if (!write_event_log_file(options.files[0], options.device, records.data(), records.size())) {
+        std::fprintf(stderr, "could not write %s\n", options.files[0].c_str());
+        return EXIT_FAILURE;
+    }
+    std::fprintf(stderr, "%zu records written to %s\n", records.size(), options.files[0].c_str());
+    return EXIT_SUCCESS;
+}
+
+void print_rate(std::size_t records, double elapsed, std::size_t threads) {
+    std::fprintf(stderr,
+                 "%zu records on %zu threads in %.3f s (%.1f M records/s)\n",
+                 records,
+                 threads,
+                 elapsed,
+                 static_cast<double>(records) / elapsed / 1e6);
+}
+
+int verify(std::vector<EventLogView> const& logs, thread_pool& pool) {
+    auto const start   = std::chrono::steady_clock::now();
+    auto const summary = verify_event_logs(logs, pool);
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("records,verified,mismatched,truncated,gaps\n");
+    std::printf("%zu,%zu,%zu,%zu,%zu\n",
+                summary.records,
+                summary.verified,
+                summary.mismatched,
+                summary.truncated,
+                summary.gaps);
+    print_rate(summary.records, elapsed, pool.size());
+    return summary.mismatched == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int replay(std::vector<EventLogView> const& logs, std::string const& rules, thread_pool& pool) {
+    auto const start    = std::chrono::steady_clock::now();
+    auto const outcomes = rules == "cat-resistant"
+                              ? replay_games<ResistantHealthState>(
+                                    logs, PlayerEngine<CatResistantRules>{}, pool)
+                              : replay_games<HealthState>(logs, PlayerEngine<DefaultRules>{}, pool);
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t records          = 0;
+    std::size_t logged_zombies   = 0;
+    std::size_t replayed_zombies = 0;
+    std::size_t changed          = 0;
+    std::printf("device,logged_health,replayed_health,logged_zombie_tick,replayed_zombie_tick\n");
+    for (std::size_t i = 0; i < outcomes.size(); ++i) {
+        auto const& outcome = outcomes[i];
+        std::printf("%u,%u,%u,%u,%u\n",
+                    static_cast<unsigned>(outcome.device),
+                    static_cast<unsigned>(outcome.logged_health),
+                    static_cast<unsigned>(outcome.replayed_health),
+                    static_cast<unsigned>(outcome.logged_zombie_tick),
+                    static_cast<unsigned>(outcome.replayed_zombie_tick));
+        records += logs[i].size;
+        logged_zombies += outcome.logged_zombie_tick != 0;
+        replayed_zombies += outcome.replayed_zombie_tick != 0;
+        changed += outcome.logged_health != outcome.replayed_health;
+    }
+    std::fprintf(stderr,
+                 "%zu games under %s rules: %zu zombies logged, %zu replayed, "
+                 "%zu end in a different health\n",
+                 outcomes.size(),
+                 rules.c_str(),
+                 logged_zombies,
+                 replayed_zombies,
+                 changed);
+    print_rate(records, elapsed, pool.size());
+    return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (options.command == "extract") {
+        return extract(options);
+    }
+
+    std::vector<MappedEventLog> files(options.files.size());
+    std::vector<EventLogView> logs;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        std::string error;
+        if (!files[i].open(options.files[i], error)) {
+            std::fprintf(stderr, "%s: %s\n", options.files[i].c_str(), error.c_str());
+            return EXIT_FAILURE;
+        }
+        logs.push_back(files[i].view());
+    }
+
+    thread_pool pool{options.threads};
+    return options.command == "verify" ? verify(logs, pool) : replay(logs, options.rules, pool);
+}
@@ -0,0 +1,168 @@
+// C++ Standard Library
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Superspreader
+#include "event_log_replay.h"
+
+namespace {
+
+constexpr char kFileMagic[4] = {'S', 'S', 'E', 'L'};
+
+/** @returns true if @p record does not follow on from @p previous */
+bool is_gap(EventLogRecord const& previous, EventLogRecord const& record) {
+    return record.tick != previous.tick + 1 || record.start_health != previous.end_health;
+}
+
+}  // namespace
+
+bool write_event_log_file(std::string const& path,
+                          std::uint32_t device,
+                          EventLogRecord const* records,
+                          std::size_t count) {
+    auto* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    EventLogFileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version     = kEventLogFileVersion;
+    header.record_size = sizeof(EventLogRecord);
+    header.device      = device;
+
+    auto ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok      = ok && std::fwrite(records, sizeof(EventLogRecord), count, file) == count;
+    return std::fclose(file) == 0 && ok;
+}
+
+MappedEventLog::~MappedEventLog() { close(); }
+
+MappedEventLog::MappedEventLog(MappedEventLog&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, bytes_{std::exchange(other.bytes_, 0)} {}
+
+MappedEventLog& MappedEventLog::operator=(MappedEventLog&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_  = std::exchange(other.data_, nullptr);
+        bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+}
+
+bool MappedEventLog::open(std::string const& path, std::string& error) {
+    close();
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        error = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    auto const bytes = static_cast<std::size_t>(info.st_size);
+    if (bytes < sizeof(EventLogFileHeader)) {
+        error = "too short for an event log";
+        ::close(fd);
+        return false;
+    }
+
+    auto* data = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        error = std::strerror(errno);
+        return false;
+    }
+    // Replay reads each file once from start to end
+    ::madvise(data, bytes, MADV_SEQUENTIAL);
+
+    auto const* header = static_cast<EventLogFileHeader const*>(data);
+    if (std::memcmp(header->magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+        error = "not an event log";
+    } else if (header->version != kEventLogFileVersion ||
+               header->record_size != sizeof(EventLogRecord)) {
+        error = "unsupported event log version";
+    } else if ((bytes - sizeof(EventLogFileHeader)) % sizeof(EventLogRecord) != 0) {
+        error = "event log ends part way through a record";
+    } else {
+        data_  = data;
+        bytes_ = bytes;
+        return true;
+    }
+    ::munmap(data, bytes);
+    return false;
+}
+
+EventLogView MappedEventLog::view() const {
+    if (data_ == nullptr) {
+        return EventLogView{0, nullptr, 0};
+    }
+    auto const* bytes  = static_cast<std::uint8_t const*>(data_);
+    auto const* header = reinterpret_cast<EventLogFileHeader const*>(bytes);
+    return EventLogView{header->device,
+                        reinterpret_cast<EventLogRecord const*>(bytes + sizeof(*header)),
+                        (bytes_ - sizeof(*header)) / sizeof(EventLogRecord)};
+}
+
+void MappedEventLog::close() {
+    if (data_ != nullptr) {
+        ::munmap(data_, bytes_);
+        data_  = nullptr;
+        bytes_ = 0;
+    }
+}
+
+VerifySummary verify_event_logs(std::vector<EventLogView> const& logs, thread_pool& pool) {
+    // Index of the first record of each log among all records
+    std::vector<std::size_t> starts(logs.size() + 1, 0);
+    for (std::size_t i = 0; i < logs.size(); ++i) {
+        starts[i + 1] = starts[i] + logs[i].size;
+    }
+
+    std::vector<VerifySummary> partial(pool.size());
+    pool.parallel_for(starts.back(), [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        auto summary = VerifySummary{};
+        auto log     = static_cast<std::size_t>(
+            std::upper_bound(starts.begin(), starts.end(), begin) - starts.begin() - 1);
+        for (auto index = begin; index < end; ++log) {
+            auto const& view = logs[log];
+            auto const last  = std::min(end, starts[log + 1]);
+            for (auto i = index - starts[log]; index < last; ++index, ++i) {
+                auto const& record = view.records[i];
+                if ((record.flags & kEventLogTruncated) != 0) {
+                    ++summary.truncated;
+                } else if (verify_event_log_record(record)) {
+                    ++summary.verified;
+                } else {
+                    ++summary.mismatched;
+                }
+                if (i > 0 && is_gap(view.records[i - 1], record)) {
+                    ++summary.gaps;
+                }
+            }
+        }
+        summary.records = end - begin;
+        partial[worker] = summary;
+    });
+
+    VerifySummary total;
+    for (auto const& summary : partial) {
+        total.records += summary.records;
+        total.verified += summary.verified;
+        total.mismatched += summary.mismatched;
+        total.truncated += summary.truncated;
+        total.gaps += summary.gaps;
+    }
+    return total;
+}
@@ -0,0 +1,203 @@
+// Event log dump files, and replay of the games they record
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "event_log.h"
+#include "game_rules.h"
+#include "thread_pool.h"
+
+/** @file **/
+
+/**
+ * @brief Start of an event log dump file, followed by its @c EventLogRecord entries
+ * @note Native byte order, little-endian on both the ESP32 and the host
+ */
+struct EventLogFileHeader {
+    char magic[4];             /**< "SSEL" */
+    std::uint16_t version;     /**< @c kEventLogFileVersion */
+    std::uint16_t record_size; /**< sizeof(EventLogRecord) */
+    std::uint32_t device;      /**< Device the records came from */
+    std::uint32_t reserved;    /**< Zero */
+};
+
+static_assert(sizeof(EventLogFileHeader) == 16, "records after the header stay aligned");
+
+/** @brief Dump file layout written by @c write_event_log_file */
+constexpr std::uint16_t kEventLogFileVersion = 1;
+
+/** @brief Records of one device, oldest first */
+struct EventLogView {
+    std::uint32_t device;          /**< Device the records came from */
+    EventLogRecord const* records; /**< First record */
+    std::size_t size;              /**< Number of records */
+};
+
+/**
+ * @brief Writes a dump file
+ * @param path file to create or overwrite
+ * @param device device the records came from
+ * @param records records to write, oldest first
+ * @param count number of records
+ * @returns false if the file could not be written
+ */
+bool write_event_log_file(std::string const& path,
+                          std::uint32_t device,
+                          EventLogRecord const* records,
+                          std::size_t count);
+
+/**
+ * @brief Dump file mapped read-only into memory
+ *
+ * Records are used in place, so opening costs the same for any file size and
+ * pages are only read as replay reaches them.
+ */
+class MappedEventLog {
+   public:
+    MappedEventLog() = default;
+    ~MappedEventLog();
+
+    MappedEventLog(MappedEventLog&& other) noexcept;
+    MappedEventLog& operator=(MappedEventLog&& other) noexcept;
+    MappedEventLog(MappedEventLog const&)            = delete;
+    MappedEventLog& operator=(MappedEventLog const&) = delete;
+
+    /**
+     * @brief Maps @p path, unmapping any file mapped before
+     * @param path dump file written by @c write_event_log_file
+     * @param error set to the reason on failure
+     * @returns false if @p path could not be mapped or is not a dump file
+     */
+    bool open(std::string const& path, std::string& error);
+
+    /** @returns the mapped records, empty if nothing is mapped */
+    EventLogView view() const;
+
+   private:
+    void close();
+
+    void* data_        = nullptr;
+    std::size_t bytes_ = 0;
+};
+
+/** @brief Counts from @c verify_event_logs */
+struct VerifySummary {
+    std::size_t records    = 0; /**< Records read */
+    std::size_t verified   = 0; /**< Replays that reproduced the logged health and tick */
+    std::size_t mismatched = 0; /**< Replays that did not */
+    std::size_t truncated  = 0; /**< Records with events missing, which cannot be replayed */
+    std::size_t gaps       = 0; /**< Records that do not follow on from the previous one */
+};
+
+/**
+ * @brief Replays every record with the firmware's @c game_update
+ *
+ * Records are independent, so they are split evenly across @p pool no matter
+ * how they are spread over files.
+ *
+ * @param logs records of each device
+ * @param pool workers to split records across
+ */
+VerifySummary verify_event_logs(std::vector<EventLogView> const& logs, thread_pool& pool);
+
+/** @brief Logged and replayed outcome of one device's game */
+struct GameOutcome {
+    std::uint32_t device;               /**< Device the game was logged on */
+    health_t logged_health;             /**< Health after the last logged wake */
+    health_t replayed_health;           /**< Health after the last replayed wake */
+    std::uint32_t logged_zombie_tick;   /**< Tick the device turned zombie, 0 if it did not */
+    std::uint32_t replayed_zombie_tick; /**< Tick the replay turned zombie, 0 if it did not */
+};
+
+/**
+ * @returns true if @p record starts a new game rather than following @p previous:
+ *          its tick does not move forward, as after the device lost its player
+ *          state and restarted from tick 1, or it is the next tick but does not
+ *          start from the health @p previous ended on
+ */
+inline bool starts_new_game(EventLogRecord const& previous, EventLogRecord const& record) {
+    return record.tick <= previous.tick ||
+           (record.tick == previous.tick + 1 && record.start_health != previous.end_health);
+}
+
+/**
+ * @brief Replays a whole game under other rules, following the logged events
+ *
+ * Starts from the first record's start health and applies each wake's events
+ * as @c game_update does: every exposure, and the first treatment. Ticks missing
+ * from the log are replayed as idle ticks. Exposures are what the device
+ * actually saw, so they do not react to the replayed health of other players.
+ * Where the log restarts (see @c starts_new_game), the replay restarts from the
+ * new record's start health and the outcome describes the last game only.
+ *
+ * @tparam StateT @c HealthState, or @c ResistantHealthState for rules with cat resistance
+ * @param log records of one device
+ * @param engine rules to replay under
+ */
+template <typename StateT, typename RulesT>
+GameOutcome replay_game(EventLogView const& log, PlayerEngine<RulesT> const& engine) {
+    auto const zombie = to_health(StateBounds::ZOMBIE);
+    GameOutcome outcome{log.device, 0, 0, 0, 0};
+    if (log.size == 0) {
+        return outcome;
+    }
+
+    StateT state;
+    for (std::size_t i = 0; i < log.size; ++i) {
+        auto const& record = log.records[i];
+        if (i == 0 || starts_new_game(log.records[i - 1], record)) {
+            state                        = StateT{};
+            state.health                 = record.start_health;
+            outcome.logged_zombie_tick   = 0;
+            outcome.replayed_zombie_tick = 0;
+        } else if (record.tick - log.records[i - 1].tick > 1) {
+            state = engine.idle_update(state, record.tick - log.records[i - 1].tick - 1);
+        }
+
+        bool treated     = false;
+        auto const count = record.event_count < kLoggedEventsPerWake ? record.event_count
+                                                                     : kLoggedEventsPerWake;
+        for (std::size_t e = 0; e < count; ++e) {
+            auto const event = unpack_event(record.events[e]);
+            if (event.type == Event::Type::EXPOSURE) {
+                state = engine.exposure_update(state, event.data.exposure);
+            } else if (event.type == Event::Type::TREATMENT && !treated) {
+                state   = engine.treatment_update(state);
+                treated = true;
+            }
+        }
+
+        if (outcome.logged_zombie_tick == 0 && record.end_health >= zombie) {
+            outcome.logged_zombie_tick = record.tick;
+        }
+        if (outcome.replayed_zombie_tick == 0 && state.health >= zombie) {
+            outcome.replayed_zombie_tick = record.tick;
+        }
+    }
+    outcome.logged_health   = log.records[log.size - 1].end_health;
+    outcome.replayed_health = state.health;
+    return outcome;
+}
+
+/**
+ * @brief Replays every game in @p logs, split across @p pool one device at a time
+ * @returns one outcome per entry of @p logs, in the same order
+ */
+template <typename StateT, typename RulesT>
+std::vector<GameOutcome> replay_games(std::vector<EventLogView> const& logs,
+                                      PlayerEngine<RulesT> const& engine,
+                                      thread_pool& pool) {
+    std::vector<GameOutcome> outcomes(logs.size());
+    pool.parallel_for(logs.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            outcomes[i] = replay_game<StateT>(logs[i], engine);
+        }
+    });
+    return outcomes;
+}
@@ -0,0 +1,340 @@
+// C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Superspreader
+#include "counter_rng.h"
+#include "event_simulator.h"
+
+namespace {
+
+// Tick used to key the random streams that place devices and their first wake
+constexpr auto kPlacementTick = std::numeric_limits<std::uint64_t>::max();
+
+// Random streams keyed by press index and device id, reserved for treatment presses
+constexpr std::uint64_t kTreatmentStream = 0x7472656174ULL;
+
+// End of a window that is still open
+constexpr auto kOpen = std::numeric_limits<std::uint32_t>::max();
+
+// No press pending
+constexpr auto kNever = std::numeric_limits<std::uint64_t>::max();
+
+constexpr std::uint64_t kScanMs = SCAN_SECONDS * 1000ULL;
+
+constexpr std::uint64_t to_payload(std::size_t id, EventSimulator::EventType type) {
+    return static_cast<std::uint64_t>(id) << 8 | static_cast<std::uint64_t>(type);
+}
+
+/** @returns what other monitors count @p health as */
+constexpr Beacon to_beacon(health_t health) {
+    return is_contagious(health) ? Beacon::INFECTED_HUMAN : Beacon::NONE;
+}
+
+}  // namespace
+
+EventSimulator::EventSimulator(EventSimConfig const& config, thread_pool& pool)
+    : config_{config},
+      pool_{pool},
+      mean_press_interval_ms_{config.treatments_per_hour > 0.0
+                                  ? 3600.0 * 1000.0 / config.treatments_per_hour
+                                  : 0.0},
+      devices_(config.devices),
+      windows_(config.devices),
+      published_(config.devices),
+      cats_in_range_(config.devices, 0) {
+    // Place devices, then cats
+    auto const total = config_.devices + config_.cats;
+    std::vector<float> x(total);
+    std::vector<float> y(total);
+    for (std::size_t id = 0; id < total; ++id) {
+        counter_rng rng{config_.seed, kPlacementTick, id};
+        x[id] = static_cast<float>(rng.uniform()) * config_.venue_width;
+        y[id] = static_cast<float>(rng.uniform()) * config_.venue_height;
+    }
+
+    // Bucket everything into cells one range wide, so each device checks the 9 around it
+    auto const range   = static_cast<float>(config_.rssi.range());
+    auto const columns =
+        std::max<std::size_t>(1, static_cast<std::size_t>(config_.venue_width / range));
+    auto const rows =
+        std::max<std::size_t>(1, static_cast<std::size_t>(config_.venue_height / range));
+    auto const cell_of = [&](std::size_t id, std::size_t& column, std::size_t& row) {
+        // Clamp so devices on the far walls land in the last cell
+        column = std::min(columns - 1,
+                          static_cast<std::size_t>(std::max(0.0f, x[id] / config_.venue_width) *
+                                                   static_cast<float>(columns)));
+        row    = std::min(rows - 1,
+                       static_cast<std::size_t>(std::max(0.0f, y[id] / config_.venue_height) *
+                                                static_cast<float>(rows)));
+    };
+    std::vector<std::uint32_t> cell_start(columns * rows + 1, 0);
+    std::vector<std::uint32_t> sorted(total);
+    for (std::size_t id = 0; id < total; ++id) {
+        std::size_t column = 0;
+        std::size_t row    = 0;
+        cell_of(id, column, row);
+        ++cell_start[row * columns + column + 1];
+    }
+    for (std::size_t cell = 0; cell < columns * rows; ++cell) {
+        cell_start[cell + 1] += cell_start[cell];
+    }
+    {
+        auto next = cell_start;
+        for (std::size_t id = 0; id < total; ++id) {
+            std::size_t column = 0;
+            std::size_t row    = 0;
+            cell_of(id, column, row);
+            sorted[next[row * columns + column]++] = static_cast<std::uint32_t>(id);
+        }
+    }
+
+    auto const range_squared = range * range;
+    neighbour_start_.reserve(config_.devices + 1);
+    neighbour_start_.push_back(0);
+    for (std::size_t id = 0; id < config_.devices; ++id) {
+        std::size_t column = 0;
+        std::size_t row    = 0;
+        cell_of(id, column, row);
+        for (auto r = row > 0 ? row - 1 : 0; r <= std::min(row + 1, rows - 1); ++r) {
+            for (auto c = column > 0 ? column - 1 : 0; c <= std::min(column + 1, columns - 1);
+                 ++c) {
+                auto const cell = r * columns + c;
+                for (auto k = cell_start[cell]; k < cell_start[cell + 1]; ++k) {
+                    auto const other = sorted[k];
+                    auto const dx    = x[other] - x[id];
+                    auto const dy    = y[other] - y[id];
+                    if (other == id || dx * dx + dy * dy > range_squared) {
+                        continue;
+                    }
+                    if (other >= config_.devices) {
+                        ++cats_in_range_[id];
+                    } else {
+                        neighbours_.push_back(other);
+                    }
+                }
+            }
+        }
+        // Scans read neighbours in id order, so their windows are read in memory order
+        std::sort(neighbours_.begin() + neighbour_start_.back(), neighbours_.end());
+        neighbour_start_.push_back(static_cast<std::uint32_t>(neighbours_.size()));
+    }
+
+    // Seed the outbreak at evenly spaced devices so it is independent of the seed
+    auto const zombies = std::min(config_.initial_zombie, config_.devices);
+    for (std::size_t i = 0; i < zombies; ++i) {
+        devices_[i * config_.devices / zombies].player.health.health =
+            to_health(StateBounds::ZOMBIE);
+    }
+
+    // One partition of consecutive devices per worker
+    auto const workers = pool_.size();
+    partitions_.resize(workers);
+    for (std::size_t p = 0; p < workers; ++p) {
+        partitions_[p].begin = config_.devices * p / workers;
+        partitions_[p].end   = config_.devices * (p + 1) / workers;
+    }
+
+    // Devices were switched on at random over one sleep, so they start out of phase
+    for (auto& partition : partitions_) {
+        for (auto id = partition.begin; id < partition.end; ++id) {
+            devices_[id].next_press = kNever;
+            counter_rng rng{config_.seed ^ kTreatmentStream, kPlacementTick, id};
+            auto const first_wake =
+                static_cast<std::uint64_t>(rng.uniform() * TIME_TO_SLEEP * 1000.0);
+            partition.wheel.schedule(first_wake, to_payload(id, EventType::WAKE));
+            windows_[id].newest = kWindows - 1;
+            for (auto& window : windows_[id].windows) {
+                window = AdvertWindow{kOpen, kOpen, Beacon::NONE};
+            }
+            open_window(partition, id, first_wake + kWakeSetupMs);
+            schedule_press(partition, id);
+        }
+        partition.dirty.clear();
+    }
+    published_ = windows_;
+}
+
+void EventSimulator::run_until(std::uint64_t time_ms) {
+    while (now_ < time_ms) {
+        auto const until = now_ + kWakeSetupMs;
+        pool_.parallel_for(partitions_.size(),
+                           [this, until](std::size_t begin, std::size_t end, std::size_t) {
+                               for (auto p = begin; p < end; ++p) {
+                                   run_epoch(partitions_[p], until);
+                               }
+                           });
+
+        // Every scan of the epoch is done, publish the windows that changed
+        pool_.parallel_for(partitions_.size(),
+                           [this](std::size_t begin, std::size_t end, std::size_t) {
+                               for (auto p = begin; p < end; ++p) {
+                                   for (auto const id : partitions_[p].dirty) {
+                                       published_[id] = windows_[id];
+                                   }
+                                   partitions_[p].dirty.clear();
+                               }
+                           });
+        now_ = until;
+    }
+}
+
+void EventSimulator::run_epoch(Partition& partition, std::uint64_t until) {
+    // Events at the epoch end belong to the next epoch
+    partition.events +=
+        partition.wheel.advance(until - 1, [this, &partition](std::uint64_t now, Payload payload) {
+            handle(partition,
+                   now,
+                   static_cast<std::size_t>(payload >> 8),
+                   static_cast<EventType>(payload & 0xFF));
+        });
+}
+
+void EventSimulator::handle(Partition& partition,
+                            std::uint64_t now,
+                            std::size_t id,
+                            EventType type) {
+    auto& device = devices_[id];
+    switch (type) {
+        case EventType::WAKE:
+            device.awake     = true;
+            device.listening = true;
+            device.woke_at   = now;
+            partition.wheel.schedule(now + kWakeSetupMs, to_payload(id, EventType::ADVERTISE));
+            break;
+
+        case EventType::ADVERTISE:
+            // The window opening now was published when the device went to sleep
+            device.scan_start = now;
+            partition.wheel.schedule(now + kScanMs, to_payload(id, EventType::SCAN_END));
+            break;
+
+        case EventType::SCAN_END: {
+            // Same queue as run_wake_cycle: wakeup treatment, then the scan, then the ISR
+            static_ring_buffer<Event, 4> queue;
+            if (device.treatment_wake) {
+                queue.emplace_back(TreatmentEvent{});
+            }
+            queue.emplace_back(scan(id, now));
+            bool treated = false;
+            game_update(
+                device.player,
+                [&queue, &device]() -> Event {
+                    while (!device.interrupts.empty()) {
+                        queue.emplace_back(device.interrupts.front());
+                        device.interrupts.pop_front();
+                    }
+                    Event next_event;
+                    if (!queue.empty()) {
+                        next_event = queue.front();
+                        queue.pop_front();
+                    }
+                    return next_event;
+                },
+                [](ExposureEvent const&) {},
+                [&treated](TreatmentEvent const&) { treated = true; });
+            partition.wheel.schedule(now + (treated ? kTreatmentAnimationMs : 0),
+                                     to_payload(id, EventType::SLEEP));
+            break;
+        }
+
+        case EventType::SLEEP:
+            sleep(partition, now, id);
+            break;
+
+        case EventType::TREATMENT:
+            // A press that woke the device is handled by the wake itself, and the ISR
+            // detaches after its first press
+            if (device.awake && device.listening && now > device.woke_at) {
+                if (!device.interrupts.full()) {
+                    device.interrupts.emplace_back(TreatmentEvent{});
+                }
+                device.listening = false;
+            }
+            schedule_press(partition, id);
+            break;
+    }
+}
+
+ExposureEvent EventSimulator::scan(std::size_t id, std::uint64_t now) const {
+    auto const scan_start = devices_[id].scan_start;
+    ExposureEvent exposure{0, cats_in_range_[id]};
+    for (auto k = neighbour_start_[id]; k < neighbour_start_[id + 1]; ++k) {
+        auto const& history = published_[neighbours_[k]];
+
+        // A peer counts once, as first heard: its oldest window overlapping the scan
+        for (std::size_t i = 1; i <= kWindows; ++i) {
+            auto const& window = history.windows[(history.newest + i) % kWindows];
+            if (window.start > now || (window.end != kOpen && window.end < scan_start)) {
+                continue;
+            }
+            if (window.beacon == Beacon::INFECTED_HUMAN) {
+                ++exposure.human;
+            }
+            break;
+        }
+    }
+    return exposure;
+}
+
+void EventSimulator::sleep(Partition& partition, std::uint64_t now, std::size_t id) {
+    auto& device     = devices_[id];
+    device.awake     = false;
+    device.listening = false;
+
+    auto& history                       = windows_[id];
+    history.windows[history.newest].end = static_cast<std::uint32_t>(now);
+
+    counter_rng rng{config_.seed, ++device.wakes, id};
+    auto const timer = now + (1 + rng.below(TIME_TO_SLEEP - 1)) * 1000;
+    device.treatment_wake = device.next_press <= timer;
+    auto const wake       = device.treatment_wake ? std::max(device.next_press, now) : timer;
+    partition.wheel.schedule(wake, to_payload(id, EventType::WAKE));
+    open_window(partition, id, wake + kWakeSetupMs);
+}
+
+void EventSimulator::schedule_press(Partition& partition, std::size_t id) {
+    auto& device = devices_[id];
+    if (mean_press_interval_ms_ <= 0.0) {
+        device.next_press = kNever;
+        return;
+    }
+    counter_rng rng{config_.seed ^ kTreatmentStream, ++device.presses, id};
+    auto const from   = device.next_press == kNever ? 0 : device.next_press;
+    auto const wait   = -std::log(1.0 - rng.uniform()) * mean_press_interval_ms_;
+    device.next_press = from + 1 + static_cast<std::uint64_t>(wait);
+    partition.wheel.schedule(device.next_press, to_payload(id, EventType::TREATMENT));
+}
+
+void EventSimulator::open_window(Partition& partition, std::size_t id, std::uint64_t start) {
+    auto& history  = windows_[id];
+    history.newest = (history.newest + 1) % kWindows;
+    history.windows[history.newest] = AdvertWindow{
+        static_cast<std::uint32_t>(start), kOpen, to_beacon(devices_[id].player.health.health)};
+    partition.dirty.push_back(static_cast<std::uint32_t>(id));
+}
+
+std::uint64_t EventSimulator::events() const {
+    std::uint64_t total = 0;
+    for (auto const& partition : partitions_) {
+        total += partition.events;
+    }
+    return total;
+}
+
+std::uint64_t EventSimulator::game_updates() const {
+    std::uint64_t total = 0;
+    for (auto const& device : devices_) {
+        total += static_cast<std::uint64_t>(device.player.tick);
+    }
+    return total;
+}
+
+ClassCounts EventSimulator::class_counts() const {
+    ClassCounts counts{};
+    for (auto const& device : devices_) {
+        ++counts[static_cast<std::size_t>(to_health_class(device.player.health.health))];
+    }
+    return counts;
+}
@@ -0,0 +1,156 @@
+// Discrete-event simulator of health monitors waking on their own timers
+
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Superspreader
+#include "contact_engine.h"
+#include "population_simulator.h"
+#include "static_ring_buffer.h"
+#include "thread_pool.h"
+#include "timing_wheel.h"
+#include "wake_cycle.h"
+
+/** @file **/
+
+/** @brief Time from a wake until the device advertises and starts scanning, in milliseconds */
+constexpr std::uint32_t kWakeSetupMs = 250;
+
+/** @brief Treatment animation of @c run_wake_cycle, two slow then eight fast blinks */
+constexpr std::uint32_t kTreatmentAnimationMs = 2 * 2000 + 8 * 200;
+
+/** @brief Parameters of an event-driven run */
+struct EventSimConfig {
+    std::size_t devices        = 1000;  /**< Number of health monitors */
+    std::size_t cats           = 0;     /**< Cat beacons, always advertising */
+    std::size_t initial_zombie = 10;    /**< Devices that start as zombies */
+    double treatments_per_hour = 1.0;   /**< Average treatment presses per device per hour */
+    float venue_width          = 50.0f; /**< Venue extent along x in meters */
+    float venue_height         = 50.0f; /**< Venue extent along y in meters */
+    std::uint64_t seed         = 1;     /**< Seed for placement and every device */
+    RssiModel rssi;                     /**< Signal model between devices */
+};
+
+/**
+ * @brief Health monitors on their own wake timers, driven by a timing wheel
+ *
+ * Each device runs the firmware's cycle as timed events, in milliseconds:
+ * @c WAKE, then @c ADVERTISE @c kWakeSetupMs later, which starts a scan of
+ * @c SCAN_SECONDS. At @c SCAN_END the device counts the peers in range that
+ * advertised at any point of its scan and calls @c game_update with the same
+ * queue as @c run_wake_cycle: wakeup treatment, scan exposure, then presses
+ * caught by the ISR. @c SLEEP follows, after the treatment animation if
+ * treated, for @c random(1, TIME_TO_SLEEP) seconds or until the next
+ * @c TREATMENT press. Devices are placed at random and do not move, and cats
+ * advertise all the time.
+ *
+ * Devices are split into one partition per worker, each with its own
+ * @c timing_wheel. Partitions advance together in epochs of @c kWakeSetupMs and
+ * see each other only through advertising windows published between epochs. A
+ * window is published when its device goes to sleep, at least @c kWakeSetupMs
+ * before it opens, so no scan can miss a window from the epoch it is running
+ * in. Results are the same for any number of workers.
+ */
+class EventSimulator {
+   public:
+    /** @brief Kinds of scheduled device events */
+    enum struct EventType : std::uint8_t {
+        WAKE      = 0, /**< Timer or treatment wake, ISR attached */
+        ADVERTISE = 1, /**< Advertising starts, and with it the scan */
+        SCAN_END  = 2, /**< Scan window over, game update */
+        SLEEP     = 3, /**< Advertising stops, next wake scheduled */
+        TREATMENT = 4, /**< Treatment pin pressed */
+    };
+
+    /**
+     * @param config run parameters
+     * @param pool workers to split devices across
+     */
+    EventSimulator(EventSimConfig const& config, thread_pool& pool);
+
+    /** @brief Runs every event due before @p time_ms, rounded up to a whole epoch */
+    void run_until(std::uint64_t time_ms);
+
+    /** @returns simulated time in milliseconds */
+    std::uint64_t now_ms() const { return now_; }
+
+    /** @returns events fired so far */
+    std::uint64_t events() const;
+
+    /** @returns game updates run so far over every device */
+    std::uint64_t game_updates() const;
+
+    /** @returns number of devices currently in each display class */
+    ClassCounts class_counts() const;
+
+    /** @returns current health of @p device */
+    health_t health(std::size_t device) const { return devices_[device].player.health.health; }
+
+   private:
+    /** @brief Time a device advertised one state, [start, end] */
+    struct AdvertWindow {
+        std::uint32_t start;
+        std::uint32_t end;
+        Beacon beacon;
+    };
+
+    /** @brief Enough windows for any scan: two it can overlap, and one not yet open */
+    static constexpr std::size_t kWindows = 4;
+
+    /** @brief Windows of one device, the newest at @c (newest) */
+    struct WindowHistory {
+        std::array<AdvertWindow, kWindows> windows;
+        std::uint32_t newest;
+    };
+
+    struct Device {
+        PlayerState player;
+        static_ring_buffer<Event, 2> interrupts;  // presses caught by the ISR while awake
+        std::uint64_t woke_at;
+        std::uint64_t scan_start;
+        std::uint64_t next_press;  // time of the pending TREATMENT event
+        std::uint32_t wakes;
+        std::uint32_t presses;
+        bool awake;
+        bool listening;       // ISR attached
+        bool treatment_wake;  // next wake is a treatment press
+    };
+
+    /** @brief Event payload: device id and @c EventType */
+    using Payload = std::uint64_t;
+
+    struct Partition {
+        std::size_t begin;
+        std::size_t end;
+        timing_wheel<Payload> wheel;
+        std::vector<std::uint32_t> dirty;  // devices whose windows changed this epoch
+        std::uint64_t events = 0;
+    };
+
+    void run_epoch(Partition& partition, std::uint64_t until);
+    void handle(Partition& partition, std::uint64_t now, std::size_t id, EventType type);
+    ExposureEvent scan(std::size_t id, std::uint64_t now) const;
+    void sleep(Partition& partition, std::uint64_t now, std::size_t id);
+    void schedule_press(Partition& partition, std::size_t id);
+    void open_window(Partition& partition, std::size_t id, std::uint64_t start);
+
+    EventSimConfig config_;
+    thread_pool& pool_;
+    std::uint64_t now_ = 0;
+    double mean_press_interval_ms_;
+
+    std::vector<Device> devices_;
+    std::vector<WindowHistory> windows_;    // written by each device's partition
+    std::vector<WindowHistory> published_;  // read by every scan, updated between epochs
+    std::vector<Partition> partitions_;
+
+    // Peers in radio range of each device, [neighbour_start_[i], neighbour_start_[i + 1])
+    std::vector<std::uint32_t> neighbour_start_;
+    std::vector<std::uint32_t> neighbours_;
+    std::vector<health_t> cats_in_range_;
+};
@@ -0,0 +1,124 @@
+// Runs health monitors on their own wake timers as discrete events
+//
+// Example:
+//   superspreader_event_sim --devices 100000 --seconds 3600 --report-every 60 > run.csv
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Superspreader
+#include "event_simulator.h"
+#include "thread_pool.h"
+
+namespace {
+
+struct Options {
+    EventSimConfig config;
+    double seconds      = 600.0;
+    double report_every = 10.0;
+    std::size_t threads = 0;
+};
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --devices N              number of health monitors (default 1000)\n"
+                 "  --cats N                 cat beacons (default 0)\n"
+                 "  --initial-zombie N       devices that start as zombies (default 10)\n"
+                 "  --treatments-per-hour R  average presses per device per hour (default 1)\n"
+                 "  --venue W H              venue size in meters (default 50 50)\n"
+                 "  --seconds S              simulated time (default 600)\n"
+                 "  --report-every S         simulated seconds between rows (default 10)\n"
+                 "  --threads N              worker threads, 0 for all cores (default 0)\n"
+                 "  --seed N                 random seed (default 1)\n",
+                 program);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        char const* value = argv[++i];
+        if (arg == "--devices") {
+            options.config.devices = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--cats") {
+            options.config.cats = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--initial-zombie") {
+            options.config.initial_zombie = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--treatments-per-hour") {
+            options.config.treatments_per_hour = std::strtod(value, nullptr);
+        } else if (arg == "--venue") {
+            if (i + 1 >= argc) {
+                return false;
+            }
+            options.config.venue_width  = std::strtof(value, nullptr);
+            options.config.venue_height = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--seconds") {
+            options.seconds = std::strtod(value, nullptr);
+        } else if (arg == "--report-every") {
+            options.report_every = std::strtod(value, nullptr);
+        } else if (arg == "--threads") {
+            options.threads = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            options.config.seed = std::strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return options.report_every > 0.0;
+}
+
+void print_row(std::uint64_t time_ms, ClassCounts const& counts) {
+    std::printf("%.3f", static_cast<double>(time_ms) / 1000.0);
+    for (auto const count : counts) {
+        std::printf(",%zu", count);
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    thread_pool pool{options.threads};
+    EventSimulator simulator{options.config, pool};
+
+    std::printf("seconds,immune,super_healthy,healthy,infected_asym,infected_sym,"
+                "infected_sym_late,zombie\n");
+    print_row(simulator.now_ms(), simulator.class_counts());
+
+    auto const end_ms   = static_cast<std::uint64_t>(options.seconds * 1000.0);
+    auto const every_ms = static_cast<std::uint64_t>(options.report_every * 1000.0);
+    auto const start    = std::chrono::steady_clock::now();
+    while (simulator.now_ms() < end_ms) {
+        simulator.run_until(std::min(end_ms, simulator.now_ms() + every_ms));
+        print_row(simulator.now_ms(), simulator.class_counts());
+    }
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto const events = static_cast<double>(simulator.events());
+    std::fprintf(stderr,
+                 "%zu devices for %.0f s on %zu threads in %.3f s: %.0f events, "
+                 "%.0f events/s (%.0f ns CPU per event), %llu game updates\n",
+                 options.config.devices,
+                 static_cast<double>(simulator.now_ms()) / 1000.0,
+                 pool.size(),
+                 elapsed,
+                 events,
+                 events / elapsed,
+                 elapsed / events * 1e9 * static_cast<double>(pool.size()),
+                 static_cast<unsigned long long>(simulator.game_updates()));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+// C++ Standard Library
+#include <cinttypes>
+
+// Superspreader
+#include "game_trace_histogram.h"
+
+namespace {
+
+// Indexed by GameTraceType
+constexpr char const* kTypeNames[kNumGameTraceTypes] = {
+    "",
+    "exposure",
+    "treatment",
+    "latched",
+    "tick",
+};
+
+}  // namespace
+
+std::size_t GameTraceHistogram::cycle_bucket(std::uint32_t cycles) {
+    std::size_t bucket = 0;
+    for (; cycles != 0; cycles >>= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+void GameTraceHistogram::record(GameTraceRecord const& record) {
+    auto const type = static_cast<std::size_t>(record.type);
+    if (type >= kNumGameTraceTypes) {
+        return;
+    }
+    ++counts_[type];
+    total_cycles_[type] += record.cycles;
+    ++cycles_[type][cycle_bucket(record.cycles)];
+    if (record.type == GameTraceType::TICK) {
+        ++events_per_tick_[record.events < kEventBuckets ? record.events : kEventBuckets - 1];
+    }
+}
+
+void GameTraceHistogram::merge(GameTraceHistogram const& other) {
+    for (std::size_t type = 0; type < kNumGameTraceTypes; ++type) {
+        counts_[type] += other.counts_[type];
+        total_cycles_[type] += other.total_cycles_[type];
+        for (std::size_t bucket = 0; bucket < kCycleBuckets; ++bucket) {
+            cycles_[type][bucket] += other.cycles_[type][bucket];
+        }
+    }
+    for (std::size_t bucket = 0; bucket < kEventBuckets; ++bucket) {
+        events_per_tick_[bucket] += other.events_per_tick_[bucket];
+    }
+}
+
+std::uint64_t cycle_quantile(GameTraceHistogram const& histogram,
+                             GameTraceType type,
+                             double quantile) {
+    auto const count = histogram.count(type);
+    if (count == 0) {
+        return 0;
+    }
+    auto const& buckets = histogram.cycle_histogram(type);
+    auto const rank     = quantile * static_cast<double>(count);
+    std::uint64_t seen  = 0;
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (static_cast<double>(seen) >= rank && seen > 0) {
+            return bucket == 0 ? 0 : (std::uint64_t{1} << bucket) - 1;
+        }
+    }
+    return (std::uint64_t{1} << (buckets.size() - 1)) - 1;
+}
+
+void print_game_trace(GameTraceHistogram const& histogram, std::FILE* out) {
+    std::fprintf(out, "%-10s %12s %12s %10s %10s\n", "event", "count", "cycles/ea", "p50", "p99");
+    for (std::size_t i = 1; i < kNumGameTraceTypes; ++i) {
+        auto const type  = static_cast<GameTraceType>(i);
+        auto const count = histogram.count(type);
+        std::fprintf(out,
+                     "%-10s %12" PRIu64 " %12.1f %10" PRIu64 " %10" PRIu64 "\n",
+                     kTypeNames[i],
+                     count,
+                     count > 0 ? static_cast<double>(histogram.total_cycles(type)) / count : 0.0,
+                     cycle_quantile(histogram, type, 0.5),
+                     cycle_quantile(histogram, type, 0.99));
+    }
+
+    std::fprintf(out, "events/tick");
+    auto const& events = histogram.events_per_tick();
+    for (std::size_t bucket = 0; bucket < events.size(); ++bucket) {
+        if (events[bucket] > 0) {
+            std::fprintf(out,
+                         " %zu%s:%" PRIu64,
+                         bucket,
+                         bucket + 1 == events.size() ? "+" : "",
+                         events[bucket]);
+        }
+    }
+    std::fprintf(out, "\n");
+}
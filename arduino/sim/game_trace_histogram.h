@@ -0,0 +1,83 @@
+// Host trace sink that aggregates game_update traces into histograms
+
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Superspreader
+#include "game_trace.h"
+
+/** @file **/
+
+/**
+ * @brief Trace sink for @c game_update that keeps counts instead of records
+ *
+ * Cycles fall in power of two buckets: bucket b counts events that took
+ * [2^(b-1), 2^b) cycles, bucket 0 those that took none. One histogram per
+ * thread, combined with @c merge, profiles any number of updates in constant
+ * memory.
+ */
+class GameTraceHistogram {
+   public:
+    /** @brief Buckets of @c events_per_tick, the last counts every longer tick */
+    static constexpr std::size_t kEventBuckets = 17;
+
+    /** @brief Buckets of @c cycle_histogram, enough for any 32-bit count */
+    static constexpr std::size_t kCycleBuckets = 33;
+
+    std::uint32_t cycles() const { return read_cycle_counter(); }
+
+    /** @brief Adds @p record to the histograms */
+    void record(GameTraceRecord const& record);
+
+    /** @brief Adds every count of @p other to this histogram */
+    void merge(GameTraceHistogram const& other);
+
+    /** @returns number of records of @p type */
+    std::uint64_t count(GameTraceType type) const {
+        return counts_[static_cast<std::size_t>(type)];
+    }
+
+    /** @returns number of ticks that polled each number of events */
+    std::array<std::uint64_t, kEventBuckets> const& events_per_tick() const {
+        return events_per_tick_;
+    }
+
+    /** @returns number of records of @p type in each cycle bucket */
+    std::array<std::uint64_t, kCycleBuckets> const& cycle_histogram(GameTraceType type) const {
+        return cycles_[static_cast<std::size_t>(type)];
+    }
+
+    /** @returns total cycles of every record of @p type */
+    std::uint64_t total_cycles(GameTraceType type) const {
+        return total_cycles_[static_cast<std::size_t>(type)];
+    }
+
+    /** @returns the bucket @p cycles falls in */
+    static std::size_t cycle_bucket(std::uint32_t cycles);
+
+   private:
+    std::array<std::uint64_t, kNumGameTraceTypes> counts_{};
+    std::array<std::uint64_t, kNumGameTraceTypes> total_cycles_{};
+    std::array<std::array<std::uint64_t, kCycleBuckets>, kNumGameTraceTypes> cycles_{};
+    std::array<std::uint64_t, kEventBuckets> events_per_tick_{};
+};
+
+/**
+ * @returns upper bound of the cycle bucket holding the @p quantile of records of @p type,
+ *          or 0 if there are none
+ */
+std::uint64_t cycle_quantile(GameTraceHistogram const& histogram,
+                             GameTraceType type,
+                             double quantile);
+
+/**
+ * @brief Prints event counts, events per tick, and cycles per event of each type
+ * @param histogram traces to summarize
+ * @param out stream to print to
+ */
+void print_game_trace(GameTraceHistogram const& histogram, std::FILE* out);
@@ -0,0 +1,279 @@
+// C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+// Superspreader
+#include "outcome_solver.h"
+
+// The AVX2 kernel is compiled with a per-function target attribute and selected
+// at runtime, as the batch kernels are
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SUPERSPREADER_X86_KERNELS 1
+#else
+#define SUPERSPREADER_X86_KERNELS 0
+#endif
+
+namespace {
+
+/** @brief Settings solved together, one per SIMD lane */
+constexpr std::size_t kLanes = 8;
+
+constexpr std::size_t kStates = kNumHealthValues;
+constexpr std::size_t kZombie = to_health(StateBounds::ZOMBIE);
+
+/** @brief Probability below which a tail or the mass still in play is ignored */
+constexpr double kNegligible = 1e-15;
+
+constexpr double kOnes[kLanes] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+
+/**
+ * @brief Health distributions and parameters of up to @c kLanes settings
+ *
+ * Every array is indexed [state][lane], so each step of the chain is a run of
+ * lane-wise multiply-adds that the compiler turns into vector instructions.
+ */
+struct Group {
+    double health[kStates][kLanes];
+    double treated[kStates][kLanes];
+    double load[kStates][kLanes];      // chance of exposure load l, the last entry is >= l
+    double tail[kStates + 1][kLanes];  // chance of exposure load >= l
+    double treatment_prob[kLanes];
+    std::size_t loads[kStates];  // loads below the last entry with a chance in any lane
+    std::size_t num_loads;
+};
+
+/** @brief out += in * weight, lane by lane */
+inline void multiply_add(double* __restrict out,
+                         double const* __restrict in,
+                         double const* __restrict weight) {
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        out[lane] += in[lane] * weight[lane];
+    }
+}
+
+/** @returns true if every lane of @p in is zero */
+inline bool all_zero(double const* in) {
+    bool zero = true;
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        zero = zero && in[lane] == 0.0;
+    }
+    return zero;
+}
+
+/** @returns chance of each exposure load, the total health an exposure adds, capped at zombie */
+std::vector<double> load_distribution(ExposureDistribution const& exposure) {
+    std::vector<double> load(kStates, 0.0);
+    for (std::size_t human = 0; human < exposure.human.size(); ++human) {
+        for (std::size_t cat = 0; cat < exposure.cat.size(); ++cat) {
+            auto const amount = human * to_health(InfectionRate::HUMAN) +
+                                cat * to_health(InfectionRate::CAT);
+            load[std::min<std::size_t>(amount, kStates - 1)] +=
+                exposure.human[human] * exposure.cat[cat];
+        }
+    }
+    auto const total = std::accumulate(load.begin(), load.end(), 0.0);
+    if (total > 0.0) {
+        for (auto& chance : load) {
+            chance /= total;
+        }
+    } else {
+        load[0] = 1.0;
+    }
+    return load;
+}
+
+/** @brief Fills @p group with @p count settings from @p settings, padding unused lanes */
+void load_group(Group& group, OutcomeSetting const* settings, std::size_t count) {
+    std::fill(&group.health[0][0], &group.health[0][0] + kStates * kLanes, 0.0);
+    std::fill(&group.load[0][0], &group.load[0][0] + kStates * kLanes, 0.0);
+
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        if (lane >= count) {
+            group.load[0][lane]        = 1.0;
+            group.treatment_prob[lane] = 0.0;
+            continue;
+        }
+        auto const& setting = settings[lane];
+        auto const initial  = std::min<std::size_t>(setting.initial_health, kStates - 1);
+        group.health[initial][lane] = 1.0;
+        group.treatment_prob[lane]  = setting.treatment_prob;
+
+        auto const load = load_distribution(setting.exposure);
+        for (std::size_t l = 0; l < kStates; ++l) {
+            group.load[l][lane] = load[l];
+        }
+    }
+
+    // Loads are sums of multiples of the infection rates, so most have no chance at all
+    group.num_loads = 0;
+    for (std::size_t l = 0; l + 1 < kStates; ++l) {
+        if (!all_zero(group.load[l])) {
+            group.loads[group.num_loads++] = l;
+        }
+    }
+
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        group.tail[kStates][lane] = 0.0;
+    }
+    for (std::size_t l = kStates; l-- > 0;) {
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            group.tail[l][lane] = group.tail[l + 1][lane] + group.load[l][lane];
+        }
+    }
+}
+
+/** @brief Advances every lane of @p group by one tick: treatment, then exposure */
+inline void step(Group& group) {
+    auto const& tables = kTransitionTables;
+
+    for (std::size_t h = 0; h < kStates; ++h) {
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            group.treated[h][lane] = (1.0 - group.treatment_prob[lane]) * group.health[h][lane];
+        }
+    }
+    for (std::size_t h = 0; h < kStates; ++h) {
+        multiply_add(group.treated[tables.treatment[h]], group.health[h], group.treatment_prob);
+    }
+
+    std::fill(&group.health[0][0], &group.health[0][0] + kStates * kLanes, 0.0);
+    for (std::size_t h = 0; h < kStates; ++h) {
+        auto const base  = tables.progression[h];
+        auto const* from = group.treated[h];
+        if (tables.susceptibility[h] == 0) {
+            multiply_add(group.health[base], from, kOnes);
+            continue;
+        }
+        if (all_zero(from)) {
+            continue;
+        }
+
+        // Loads that keep the player below zombie, in increasing order, then the rest
+        std::size_t i = 0;
+        for (; i < group.num_loads && base + group.loads[i] < kZombie; ++i) {
+            multiply_add(group.health[base + group.loads[i]], from, group.load[group.loads[i]]);
+        }
+        multiply_add(group.health[kZombie], from, group.tail[kZombie - base]);
+    }
+}
+
+/** @returns chance each lane of @p group is immune */
+inline double immune_mass(Group const& group, std::size_t lane) {
+    return group.health[0][lane] + group.health[to_health(StateBounds::IMMUNE)][lane];
+}
+
+/** @brief Runs @p group for @p ticks, writing first-passage chances of the first @p count lanes */
+inline void solve_group(Group& group, std::size_t count, int ticks, OutcomeDistribution* out) {
+    double zombie[kLanes];
+    double immune[kLanes];
+    for (std::size_t lane = 0; lane < count; ++lane) {
+        zombie[lane] = group.health[kZombie][lane];
+        immune[lane] = immune_mass(group, lane);
+    }
+
+    for (int t = 0; t < ticks; ++t) {
+        step(group);
+
+        // Zombie and immune are absorbing, so growth in their mass is first passage
+        bool settled = true;
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            auto const now_zombie = group.health[kZombie][lane];
+            auto const now_immune = immune_mass(group, lane);
+            out[lane].zombie[t]   = now_zombie - zombie[lane];
+            out[lane].immune[t]   = now_immune - immune[lane];
+            zombie[lane]          = now_zombie;
+            immune[lane]          = now_immune;
+            settled = settled && 1.0 - now_zombie - now_immune < kNegligible;
+        }
+        if (settled) {
+            return;
+        }
+    }
+}
+
+void solve_group_portable(Group& group, std::size_t count, int ticks, OutcomeDistribution* out) {
+    solve_group(group, count, ticks, out);
+}
+
+#if SUPERSPREADER_X86_KERNELS
+
+// flatten inlines the lane loops here, where they are vectorized for AVX2
+__attribute__((target("avx2,fma"), flatten)) void solve_group_avx2(Group& group,
+                                                                   std::size_t count,
+                                                                   int ticks,
+                                                                   OutcomeDistribution* out) {
+    solve_group(group, count, ticks, out);
+}
+
+#endif  // SUPERSPREADER_X86_KERNELS
+
+}  // namespace
+
+ExposureDistribution ExposureDistribution::poisson(double human_mean, double cat_mean) {
+    auto const pmf = [](double mean) {
+        std::vector<double> chances{std::exp(-mean)};
+        auto remaining = 1.0 - chances.back();
+        // Beyond a zombie's worth of exposures every count has the same effect
+        while (remaining > kNegligible && chances.size() < kStates) {
+            chances.push_back(chances.back() * mean / static_cast<double>(chances.size()));
+            remaining -= chances.back();
+        }
+        return chances;
+    };
+    return ExposureDistribution{pmf(human_mean), pmf(cat_mean)};
+}
+
+double total_probability(std::vector<double> const& first_passage) {
+    return std::accumulate(first_passage.begin(), first_passage.end(), 0.0);
+}
+
+double mean_ticks(std::vector<double> const& first_passage) {
+    double total    = 0.0;
+    double weighted = 0.0;
+    for (std::size_t t = 0; t < first_passage.size(); ++t) {
+        total += first_passage[t];
+        weighted += first_passage[t] * static_cast<double>(t + 1);
+    }
+    return total > 0.0 ? weighted / total : 0.0;
+}
+
+int ticks_to_probability(std::vector<double> const& first_passage, double quantile) {
+    double cumulative = 0.0;
+    for (std::size_t t = 0; t < first_passage.size(); ++t) {
+        cumulative += first_passage[t];
+        if (cumulative >= quantile) {
+            return static_cast<int>(t + 1);
+        }
+    }
+    return 0;
+}
+
+std::vector<OutcomeDistribution> solve_outcomes(std::vector<OutcomeSetting> const& settings,
+                                                int ticks,
+                                                thread_pool& pool,
+                                                BatchKernel kernel) {
+    auto const horizon = static_cast<std::size_t>(std::max(ticks, 0));
+    std::vector<OutcomeDistribution> outcomes(
+        settings.size(),
+        OutcomeDistribution{std::vector<double>(horizon, 0.0), std::vector<double>(horizon, 0.0)});
+
+    auto const groups = (settings.size() + kLanes - 1) / kLanes;
+    (void)kernel;  // only consulted where the AVX2 kernel exists
+    pool.parallel_for(groups, [&](std::size_t begin, std::size_t end, std::size_t) {
+        auto group = std::make_unique<Group>();
+        for (std::size_t g = begin; g < end; ++g) {
+            auto const first = g * kLanes;
+            auto const count = std::min(kLanes, settings.size() - first);
+            load_group(*group, settings.data() + first, count);
+#if SUPERSPREADER_X86_KERNELS
+            if (kernel == BatchKernel::AVX2 && is_supported(BatchKernel::AVX2)) {
+                solve_group_avx2(*group, count, ticks, outcomes.data() + first);
+                continue;
+            }
+#endif
+            solve_group_portable(*group, count, ticks, outcomes.data() + first);
+        }
+    });
+    return outcomes;
+}
@@ -0,0 +1,76 @@
+// Exact outcome distributions of the player engine, as a Markov chain over health
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_batch.h"
+#include "health_monitor_core.h"
+#include "thread_pool.h"
+
+/** @file **/
+
+/** @brief Chance of each number of close exposures on one tick, independent across ticks */
+struct ExposureDistribution {
+    std::vector<double> human; /**< human[k] is the chance of k close infected humans */
+    std::vector<double> cat;   /**< cat[k] is the chance of k close cats */
+
+    /**
+     * @returns independent Poisson counts with means @p human_mean and @p cat_mean,
+     *          truncated where the remaining tail is negligible
+     */
+    static ExposureDistribution poisson(double human_mean, double cat_mean);
+};
+
+/** @brief One set of game parameters to solve */
+struct OutcomeSetting {
+    ExposureDistribution exposure; /**< Exposures seen on each tick */
+    double treatment_prob   = 0.0; /**< Chance of a treatment wake on each tick */
+    health_t initial_health = 2;   /**< Health on tick 0, as @c new_player_state */
+};
+
+/**
+ * @brief First-passage distributions of one setting over a fixed horizon
+ *
+ * Entry t is the chance the player first reaches the state on tick t + 1.
+ * A player that starts as a zombie or immune never reaches it again.
+ */
+struct OutcomeDistribution {
+    std::vector<double> zombie; /**< Chance of turning zombie on each tick */
+    std::vector<double> immune; /**< Chance of turning immune on each tick */
+};
+
+/** @returns chance that @p first_passage happens within its horizon */
+double total_probability(std::vector<double> const& first_passage);
+
+/** @returns mean tick of @p first_passage given that it happens, or 0 if it never does */
+double mean_ticks(std::vector<double> const& first_passage);
+
+/**
+ * @returns first tick by which @p first_passage has happened with chance @p quantile,
+ *          or 0 if that chance is never reached within the horizon
+ */
+int ticks_to_probability(std::vector<double> const& first_passage, double quantile);
+
+/**
+ * @brief Solves many settings exactly by propagating health distributions tick by tick
+ *
+ * Each tick applies a treatment with @c OutcomeSetting::treatment_prob, then
+ * the exposure, in the order @c game_update sees them on the firmware. Per-health
+ * transitions come from @c kTransitionTables, so they follow the shipping rules.
+ * Settings are solved in groups that share every matrix-vector step across SIMD
+ * lanes, and groups are split across @p pool.
+ *
+ * @param settings parameter settings to solve
+ * @param ticks horizon in ticks
+ * @param pool workers to split settings across
+ * @param kernel @c BatchKernel::AVX2 to use 256-bit lanes, anything else for portable code
+ * @returns one distribution per setting, in the same order
+ */
+std::vector<OutcomeDistribution> solve_outcomes(std::vector<OutcomeSetting> const& settings,
+                                                int ticks,
+                                                thread_pool& pool,
+                                                BatchKernel kernel = default_batch_kernel());
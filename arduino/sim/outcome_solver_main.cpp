@@ -0,0 +1,181 @@
+// Sweeps game parameters and prints exact time-to-zombie and time-to-immune statistics
+//
+// Example:
+//   superspreader_outcomes --human-mean 0 2 41 --cat-mean 0 0.2 5 --treatment-prob 0 0.05 11 > grid.csv
+
+// C++ Standard Library
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "outcome_solver.h"
+#include "thread_pool.h"
+
+namespace {
+
+/** @brief Evenly spaced values from @c min to @c max, inclusive */
+struct Sweep {
+    double min        = 0.0;
+    double max        = 0.0;
+    std::size_t steps = 1;
+
+    double at(std::size_t i) const {
+        return steps > 1 ? min + (max - min) * static_cast<double>(i) / (steps - 1) : min;
+    }
+};
+
+struct Options {
+    Sweep human_mean{1.0, 1.0, 1};
+    Sweep cat_mean{0.0, 0.0, 1};
+    Sweep treatment_prob{0.01, 0.01, 1};
+    std::vector<double> human_pmf;
+    std::vector<double> cat_pmf;
+    health_t initial_health = 2;
+    int ticks               = 1000;
+    std::size_t threads     = 0;
+};
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --human-mean MIN MAX N      Poisson mean of close infected humans per tick\n"
+                 "                              swept over N values (default 1 1 1)\n"
+                 "  --cat-mean MIN MAX N        Poisson mean of close cats per tick (default 0 0 1)\n"
+                 "  --treatment-prob MIN MAX N  chance of treatment per tick (default 0.01 0.01 1)\n"
+                 "  --human-pmf P0,P1,...       measured chance of each human count, instead of\n"
+                 "                              --human-mean\n"
+                 "  --cat-pmf P0,P1,...         measured chance of each cat count, instead of\n"
+                 "                              --cat-mean\n"
+                 "  --initial-health N          health on tick 0 (default 2)\n"
+                 "  --ticks N                   horizon in ticks (default 1000)\n"
+                 "  --threads N                 worker threads, 0 for all cores (default 0)\n",
+                 program);
+}
+
+std::vector<double> parse_list(char const* text) {
+    std::vector<double> values;
+    std::stringstream stream{text};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::strtod(item.c_str(), nullptr));
+    }
+    return values;
+}
+
+bool parse_sweep(int argc, char** argv, int& i, Sweep& sweep) {
+    if (i + 3 >= argc) {
+        return false;
+    }
+    sweep.min   = std::strtod(argv[++i], nullptr);
+    sweep.max   = std::strtod(argv[++i], nullptr);
+    sweep.steps = std::max<std::size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    return true;
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--human-mean") {
+            if (!parse_sweep(argc, argv, i, options.human_mean)) {
+                return false;
+            }
+        } else if (arg == "--cat-mean") {
+            if (!parse_sweep(argc, argv, i, options.cat_mean)) {
+                return false;
+            }
+        } else if (arg == "--treatment-prob") {
+            if (!parse_sweep(argc, argv, i, options.treatment_prob)) {
+                return false;
+            }
+        } else if (i + 1 >= argc) {
+            return false;
+        } else if (arg == "--human-pmf") {
+            options.human_pmf = parse_list(argv[++i]);
+        } else if (arg == "--cat-pmf") {
+            options.cat_pmf = parse_list(argv[++i]);
+        } else if (arg == "--initial-health") {
+            options.initial_health = static_cast<health_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--ticks") {
+            options.ticks = std::atoi(argv[++i]);
+        } else if (arg == "--threads") {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // A measured distribution replaces its sweep
+    auto const human_steps = options.human_pmf.empty() ? options.human_mean.steps : 1;
+    auto const cat_steps   = options.cat_pmf.empty() ? options.cat_mean.steps : 1;
+
+    std::vector<OutcomeSetting> settings;
+    for (std::size_t h = 0; h < human_steps; ++h) {
+        for (std::size_t c = 0; c < cat_steps; ++c) {
+            for (std::size_t t = 0; t < options.treatment_prob.steps; ++t) {
+                OutcomeSetting setting;
+                setting.exposure =
+                    ExposureDistribution::poisson(options.human_mean.at(h), options.cat_mean.at(c));
+                if (!options.human_pmf.empty()) {
+                    setting.exposure.human = options.human_pmf;
+                }
+                if (!options.cat_pmf.empty()) {
+                    setting.exposure.cat = options.cat_pmf;
+                }
+                setting.treatment_prob = options.treatment_prob.at(t);
+                setting.initial_health = options.initial_health;
+                settings.push_back(setting);
+            }
+        }
+    }
+
+    thread_pool pool{options.threads};
+    auto const start    = std::chrono::steady_clock::now();
+    auto const outcomes = solve_outcomes(settings, options.ticks, pool);
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("human_mean,cat_mean,treatment_prob,zombie_prob,mean_ticks_to_zombie,"
+                "median_ticks_to_zombie,immune_prob,mean_ticks_to_immune,median_ticks_to_immune\n");
+    std::size_t i = 0;
+    for (std::size_t h = 0; h < human_steps; ++h) {
+        for (std::size_t c = 0; c < cat_steps; ++c) {
+            for (std::size_t t = 0; t < options.treatment_prob.steps; ++t, ++i) {
+                auto const& outcome = outcomes[i];
+                std::printf("%g,%g,%g,%.9f,%.3f,%d,%.9f,%.3f,%d\n",
+                            options.human_pmf.empty() ? options.human_mean.at(h) : -1.0,
+                            options.cat_pmf.empty() ? options.cat_mean.at(c) : -1.0,
+                            options.treatment_prob.at(t),
+                            total_probability(outcome.zombie),
+                            mean_ticks(outcome.zombie),
+                            ticks_to_probability(outcome.zombie, 0.5),
+                            total_probability(outcome.immune),
+                            mean_ticks(outcome.immune),
+                            ticks_to_probability(outcome.immune, 0.5));
+            }
+        }
+    }
+
+    std::fprintf(stderr,
+                 "%zu settings x %d ticks on %zu threads in %.3f s (%.0f settings/s)\n",
+                 settings.size(),
+                 options.ticks,
+                 pool.size(),
+                 elapsed,
+                 static_cast<double>(settings.size()) / elapsed);
+    return EXIT_SUCCESS;
+}
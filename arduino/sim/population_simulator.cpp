@@ -0,0 +1,159 @@
+// C++ Standard Library
+#include <algorithm>
+#include <limits>
+
+// Superspreader
+#include "counter_rng.h"
+#include "health_monitor_batch.h"
+#include "population_simulator.h"
+
+namespace {
+
+// Tick used to key the random streams that place devices before the first tick
+constexpr auto kPlacementTick = std::numeric_limits<std::uint64_t>::max();
+
+/** @returns @p position reflected back into [0, extent] off the walls */
+float reflect(float position, float extent) {
+    if (position < 0.0f) {
+        position = -position;
+    } else if (position > extent) {
+        position = 2.0f * extent - position;
+    }
+    return std::min(std::max(position, 0.0f), extent);
+}
+
+}  // namespace
+
+PopulationSimulator::PopulationSimulator(SimulationConfig const& config, thread_pool& pool)
+    : config_{config},
+      pool_{pool},
+      health_(config.players, new_player_state().health.health),
+      human_exposure_(config.players, 0),
+      cat_exposure_(config.players, 0),
+      treated_(config.players, 0),
+      worker_counts_(pool.size()) {
+    // Seed the outbreak at evenly spaced players so it is independent of the seed
+    auto const zombies = std::min(config_.initial_zombie, config_.players);
+    for (std::size_t i = 0; i < zombies; ++i) {
+        health_[i * config_.players / zombies] = to_health(StateBounds::ZOMBIE);
+    }
+
+    if (config_.venue_width > 0.0f && config_.venue_height > 0.0f) {
+        contact_engine_.emplace(config_.venue_width, config_.venue_height, config_.rssi, pool_);
+
+        auto const devices = config_.players + config_.cats;
+        x_.resize(devices);
+        y_.resize(devices);
+        beacons_.resize(devices);
+        listening_.resize(config_.players);
+        for (std::size_t id = 0; id < devices; ++id) {
+            counter_rng rng{config_.seed, kPlacementTick, id};
+            x_[id] = static_cast<float>(rng.uniform()) * config_.venue_width;
+            y_[id] = static_cast<float>(rng.uniform()) * config_.venue_height;
+        }
+    }
+}
+
+void PopulationSimulator::step() {
+    if (contact_engine_) {
+        pool_.parallel_for(x_.size(), [this](std::size_t begin, std::size_t end, std::size_t) {
+            move_devices(begin, end);
+        });
+        contact_engine_->update(x_.data(),
+                                y_.data(),
+                                beacons_.data(),
+                                x_.size(),
+                                config_.players,
+                                listening_.data());
+    } else {
+        pool_.parallel_for(config_.players,
+                           [this](std::size_t begin, std::size_t end, std::size_t) {
+                               sample_events(begin, end);
+                           });
+    }
+    pool_.parallel_for(config_.players,
+                       [this](std::size_t begin, std::size_t end, std::size_t) {
+                           apply_events(begin, end);
+                       });
+    ++tick_;
+}
+
+void PopulationSimulator::sample_events(std::size_t begin, std::size_t end) {
+    auto const population = config_.players + config_.cats;
+    for (std::size_t player = begin; player < end; ++player) {
+        counter_rng rng{config_.seed, static_cast<std::uint64_t>(tick_), player};
+
+        health_t human = 0;
+        health_t cat   = 0;
+        for (std::size_t c = 0; c < config_.contacts; ++c) {
+            auto const other = rng.below(population);
+            if (other >= config_.players) {
+                ++cat;
+            } else if (other != player && is_contagious(health_[other])) {
+                ++human;
+            }
+        }
+
+        human_exposure_[player] = human;
+        cat_exposure_[player]   = cat;
+        treated_[player]        = rng.uniform() < config_.treatment_prob;
+    }
+}
+
+void PopulationSimulator::move_devices(std::size_t begin, std::size_t end) {
+    for (std::size_t id = begin; id < end; ++id) {
+        counter_rng rng{config_.seed, static_cast<std::uint64_t>(tick_), id};
+
+        auto const dx = static_cast<float>(2.0 * rng.uniform() - 1.0) * config_.walk_speed;
+        auto const dy = static_cast<float>(2.0 * rng.uniform() - 1.0) * config_.walk_speed;
+
+        if (id < config_.players) {
+            beacons_[id] = is_contagious(health_[id]) ? Beacon::INFECTED_HUMAN : Beacon::NONE;
+            treated_[id] = rng.uniform() < config_.treatment_prob;
+
+            // Only players susceptible after this tick's treatment need their contacts
+            // counted, as the firmware scans against the treated health
+            auto const exposed_health =
+                treated_[id] ? treament_update_branchless(health_[id]) : health_[id];
+            listening_[id] = is_susceptible(exposed_health);
+        } else {
+            beacons_[id] = Beacon::CAT;
+        }
+
+        // Drawn last, so a crowd where everyone moves keeps the same random streams
+        if (config_.move_prob >= 1.0 || rng.uniform() < config_.move_prob) {
+            x_[id] = reflect(x_[id] + dx, config_.venue_width);
+            y_[id] = reflect(y_[id] + dy, config_.venue_height);
+        }
+    }
+}
+
+void PopulationSimulator::apply_events(std::size_t begin, std::size_t end) {
+    // Same order as game_update sees them on the firmware: wakeup treatment, then scan exposure
+    auto const count  = end - begin;
+    auto const* human = contact_engine_ ? contact_engine_->human() : human_exposure_.data();
+    auto const* cat   = contact_engine_ ? contact_engine_->cat() : cat_exposure_.data();
+    treament_update_batch(health_.data() + begin, treated_.data() + begin, count);
+    exposure_update_batch(health_.data() + begin, human + begin, cat + begin, count);
+}
+
+ClassCounts PopulationSimulator::class_counts() const {
+    std::fill(worker_counts_.begin(), worker_counts_.end(), ClassCounts{});
+    pool_.parallel_for(config_.players,
+                       [this](std::size_t begin, std::size_t end, std::size_t worker) {
+                           ClassCounts counts{};
+                           for (std::size_t player = begin; player < end; ++player) {
+                               ++counts[static_cast<std::size_t>(
+                                   to_health_class(health_[player]))];
+                           }
+                           worker_counts_[worker] = counts;
+                       });
+
+    ClassCounts total{};
+    for (auto const& counts : worker_counts_) {
+        for (std::size_t c = 0; c < kNumHealthClasses; ++c) {
+            total[c] += counts[c];
+        }
+    }
+    return total;
+}
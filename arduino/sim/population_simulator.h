@@ -0,0 +1,158 @@
+// Host-side population simulator driving the shipping player engine
+
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Superspreader
+#include "contact_engine.h"
+#include "health_monitor_core.h"
+#include "thread_pool.h"
+
+/** @file **/
+
+/**
+ * @brief Display classes a player can be observed in, matching @c to_display_state
+ */
+enum struct HealthClass : std::uint8_t {
+    IMMUNE            = 0,
+    SUPER_HEALTHY     = 1,
+    HEALTHY           = 2,
+    INFECTED_ASYM     = 3,
+    INFECTED_SYM      = 4,
+    INFECTED_SYM_LATE = 5,
+    ZOMBIE            = 6,
+};
+
+/** @brief Number of distinct @c HealthClass values */
+constexpr std::size_t kNumHealthClasses = 7;
+
+/** @returns display class of @p health */
+constexpr HealthClass to_health_class(health_t health) {
+    if (is_immune(health)) {
+        return HealthClass::IMMUNE;
+    } else if (is_super_healthy(health)) {
+        return HealthClass::SUPER_HEALTHY;
+    } else if (is_healthy(health)) {
+        return HealthClass::HEALTHY;
+    } else if (is_infected_asym(health)) {
+        return HealthClass::INFECTED_ASYM;
+    } else if (is_infected_sym(health)) {
+        return HealthClass::INFECTED_SYM;
+    } else if (is_infected_sym_late(health)) {
+        return HealthClass::INFECTED_SYM_LATE;
+    }
+    return HealthClass::ZOMBIE;
+}
+
+/** @returns true if other devices count @p health as an infected human */
+constexpr bool is_contagious(health_t health) {
+    return health >= to_health(StateBounds::INFECTED_ASYM);
+}
+
+/** @returns true if exposures change @p health, so a player cares who is close */
+constexpr bool is_susceptible(health_t health) {
+    return is_super_healthy(health) || is_healthy(health);
+}
+
+/** @brief Number of players in each @c HealthClass */
+using ClassCounts = std::array<std::size_t, kNumHealthClasses>;
+
+/**
+ * @brief Parameters of a population run
+ *
+ * With a zero @c venue_width or @c venue_height players mix at random and meet
+ * @c contacts others per tick. Otherwise players and cats random-walk in the venue
+ * and meet whoever is within range of the @c rssi model.
+ */
+struct SimulationConfig {
+    std::size_t players        = 100000; /**< Number of health monitors */
+    std::size_t cats           = 10;     /**< Number of cat beacons mixed into the crowd */
+    std::size_t initial_zombie = 10;     /**< Players that start as zombies */
+    std::size_t contacts       = 4;      /**< Close contacts sampled per player per tick */
+    double treatment_prob      = 0.01;   /**< Chance a player is treated on a tick */
+    std::uint64_t seed         = 1;      /**< Seed for every random stream */
+    float venue_width          = 0.0f;   /**< Venue extent along x in meters */
+    float venue_height         = 0.0f;   /**< Venue extent along y in meters */
+    float walk_speed           = 1.0f;   /**< Largest step per tick along each axis in meters */
+    double move_prob           = 1.0;    /**< Chance a device takes its step on a tick */
+    RssiModel rssi;                      /**< Signal model deciding who is close in a venue */
+};
+
+/**
+ * @brief Struct-of-arrays population advanced in lockstep ticks
+ *
+ * Each tick runs in two parallel phases. First every player finds its close
+ * contacts from the previous tick's health and builds an @c ExposureEvent, plus
+ * a @c TreatmentEvent with probability @c SimulationConfig::treatment_prob.
+ * Contacts are either sampled uniformly from the crowd or, in a venue, counted
+ * by an @c IncrementalContactEngine after devices take their random-walk steps,
+ * which only recounts around devices that moved or changed beacon. A venue only
+ * counts contacts for players still susceptible after this tick's treatment.
+ * Then the events are applied with the batch kernels from @c health_monitor_batch.h,
+ * which match @c game_update on the same events in the order the firmware enqueues
+ * them (wakeup treatment first, then the scan exposure).
+ */
+class PopulationSimulator {
+   public:
+    /**
+     * @brief Creates the population
+     * @param config population parameters
+     * @param pool workers to split players across
+     */
+    PopulationSimulator(SimulationConfig const& config, thread_pool& pool);
+
+    /** @brief Advances every player by one game tick */
+    void step();
+
+    /** @returns ticks simulated so far */
+    int tick() const { return tick_; }
+
+    /** @returns health of every player, indexed by player id */
+    std::vector<health_t> const& health() const { return health_; }
+
+    /** @returns number of players currently in each display class */
+    ClassCounts class_counts() const;
+
+    /** @returns whether each player was treated on the last tick, indexed by player id */
+    std::vector<std::uint8_t> const& treated() const { return treated_; }
+
+    /** @returns venue position along x of every player, then every cat; empty without a venue */
+    std::vector<float> const& x() const { return x_; }
+
+    /** @returns venue position along y of every player, then every cat; empty without a venue */
+    std::vector<float> const& y() const { return y_; }
+
+   private:
+    void sample_events(std::size_t begin, std::size_t end);
+    void move_devices(std::size_t begin, std::size_t end);
+    void apply_events(std::size_t begin, std::size_t end);
+
+    SimulationConfig config_;
+    thread_pool& pool_;
+    int tick_ = 0;
+
+    // Player state, one entry per player
+    std::vector<health_t> health_;
+
+    // Events generated for the current tick, one entry per player. In a venue the
+    // contact engine keeps the exposures instead.
+    std::vector<health_t> human_exposure_;
+    std::vector<health_t> cat_exposure_;
+    std::vector<std::uint8_t> treated_;
+
+    // Venue state, one entry per player followed by one per cat
+    std::optional<IncrementalContactEngine> contact_engine_;
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<Beacon> beacons_;
+    std::vector<std::uint8_t> listening_;
+
+    // Per-worker scratch for class counting
+    mutable std::vector<ClassCounts> worker_counts_;
+};
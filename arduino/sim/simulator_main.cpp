@@ -0,0 +1,164 @@
+// Command line front end for the population simulator
+//
+// Example:
+//   superspreader_simulator --players 1000000 --ticks 2000 --threads 8 > run.csv
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Superspreader
+#include "population_simulator.h"
+#include "thread_pool.h"
+#include "trajectory.h"
+
+namespace {
+
+struct Options {
+    SimulationConfig config;
+    int ticks           = 1000;
+    int report_every    = 1;
+    std::size_t threads = 0;
+    std::string trajectory;
+    TrajectoryOptions trajectory_options;
+};
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --players N          number of health monitors (default 100000)\n"
+                 "  --cats N             number of cat beacons (default 10)\n"
+                 "  --initial-zombie N   players that start as zombies (default 10)\n"
+                 "  --contacts N         close contacts per player per tick (default 4)\n"
+                 "  --treatment-prob P   chance of treatment per player per tick (default 0.01)\n"
+                 "  --venue W H          walk around a W x H meter venue instead of mixing\n"
+                 "  --walk-speed M       largest step per tick in meters (default 1)\n"
+                 "  --move-prob P        chance a device steps on a tick (default 1)\n"
+                 "  --path-loss N        path loss exponent of the RSSI model (default 2)\n"
+                 "  --ticks N            ticks to simulate (default 1000)\n"
+                 "  --report-every N     ticks between CSV rows (default 1)\n"
+                 "  --threads N          worker threads, 0 for all cores (default 0)\n"
+                 "  --seed N             random seed (default 1)\n"
+                 "  --trajectory FILE    write every player's health at every tick to FILE\n"
+                 "  --raw-trajectory     store the trajectory without run-length encoding\n",
+                 program);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--raw-trajectory") {
+            options.trajectory_options.compress = false;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        char const* value = argv[++i];
+        if (arg == "--players") {
+            options.config.players = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--cats") {
+            options.config.cats = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--initial-zombie") {
+            options.config.initial_zombie = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--contacts") {
+            options.config.contacts = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--treatment-prob") {
+            options.config.treatment_prob = std::strtod(value, nullptr);
+        } else if (arg == "--venue") {
+            if (i + 1 >= argc) {
+                return false;
+            }
+            options.config.venue_width  = std::strtof(value, nullptr);
+            options.config.venue_height = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--walk-speed") {
+            options.config.walk_speed = std::strtof(value, nullptr);
+        } else if (arg == "--move-prob") {
+            options.config.move_prob = std::strtod(value, nullptr);
+        } else if (arg == "--path-loss") {
+            options.config.rssi.path_loss_exponent = std::strtod(value, nullptr);
+        } else if (arg == "--ticks") {
+            options.ticks = std::atoi(value);
+        } else if (arg == "--report-every") {
+            options.report_every = std::max(1, std::atoi(value));
+        } else if (arg == "--threads") {
+            options.threads = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            options.config.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--trajectory") {
+            options.trajectory = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_row(int tick, ClassCounts const& counts) {
+    std::printf("%d", tick);
+    for (auto const count : counts) {
+        std::printf(",%zu", count);
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    thread_pool pool{options.threads};
+    PopulationSimulator simulator{options.config, pool};
+
+    // Every tick from the initial population on, tick 0, goes to the trajectory
+    TrajectoryWriter trajectory{pool};
+    std::string error;
+    auto const tracing = !options.trajectory.empty();
+    if (tracing &&
+        (!trajectory.open(
+             options.trajectory, options.config.players, options.trajectory_options, error) ||
+         !trajectory.append(simulator.health().data(), error))) {
+        std::fprintf(stderr, "%s: %s\n", options.trajectory.c_str(), error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("tick,immune,super_healthy,healthy,infected_asym,infected_sym,"
+                "infected_sym_late,zombie\n");
+    print_row(simulator.tick(), simulator.class_counts());
+
+    auto const start = std::chrono::steady_clock::now();
+    for (int t = 0; t < options.ticks; ++t) {
+        simulator.step();
+        if (simulator.tick() % options.report_every == 0) {
+            print_row(simulator.tick(), simulator.class_counts());
+        }
+        if (tracing && !trajectory.append(simulator.health().data(), error)) {
+            std::fprintf(stderr, "%s: %s\n", options.trajectory.c_str(), error.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    if (tracing && !trajectory.close(error)) {
+        std::fprintf(stderr, "%s: %s\n", options.trajectory.c_str(), error.c_str());
+        return EXIT_FAILURE;
+    }
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto const updates = static_cast<double>(options.config.players) * options.ticks;
+    std::fprintf(stderr,
+                 "%zu players x %d ticks on %zu threads in %.3f s (%.1f M player-ticks/s)\n",
+                 options.config.players,
+                 options.ticks,
+                 pool.size(),
+                 elapsed,
+                 updates / elapsed / 1e6);
+    return EXIT_SUCCESS;
+}
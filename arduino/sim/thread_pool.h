@@ -0,0 +1,137 @@
+// Fixed-size worker pool for splitting population work across cores
+
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @file **/
+
+/**
+ * @brief Persistent pool of worker threads that run data-parallel loops
+ *
+ * Workers are created once and reused for every call to @p parallel_for, so
+ * a simulation can dispatch several phases per tick without paying for thread
+ * creation. The calling thread participates as worker 0.
+ */
+class thread_pool {
+   public:
+    /**
+     * @brief Signature of a chunk of work
+     * @param begin first index of the chunk
+     * @param end one past the last index of the chunk
+     * @param worker index of the worker running the chunk, in [0, size())
+     */
+    using task_t = std::function<void(std::size_t begin, std::size_t end, std::size_t worker)>;
+
+    /**
+     * @brief Starts the worker threads
+     * @param num_threads total number of workers, including the caller.
+     *        Zero selects @c std::thread::hardware_concurrency()
+     */
+    explicit thread_pool(std::size_t num_threads = 0) {
+        if (num_threads == 0) {
+            num_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+        for (std::size_t worker = 1; worker < num_threads; ++worker) {
+            threads_.emplace_back([this, worker]() { run(worker); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopping_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    thread_pool(thread_pool const&)            = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    /** @returns number of workers, including the calling thread */
+    std::size_t size() const { return threads_.size() + 1; }
+
+    /**
+     * @brief Splits [0, count) into one contiguous chunk per worker and blocks until all finish
+     * @param count number of items to process
+     * @param task function called once per non-empty chunk
+     */
+    void parallel_for(std::size_t count, task_t const& task) {
+        if (count == 0) {
+            return;
+        }
+        if (threads_.empty()) {
+            task(0, count, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            task_      = &task;
+            count_     = count;
+            remaining_ = threads_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        run_chunk(0);
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        done_cv_.wait(lock, [this]() { return remaining_ == 0; });
+        task_ = nullptr;
+    }
+
+   private:
+    void run_chunk(std::size_t worker) const {
+        auto const workers = size();
+        auto const begin   = count_ * worker / workers;
+        auto const end     = count_ * (worker + 1) / workers;
+        if (begin < end) {
+            (*task_)(begin, end, worker);
+        }
+    }
+
+    void run(std::size_t worker) {
+        std::size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                start_cv_.wait(lock, [this, seen_generation]() {
+                    return stopping_ || generation_ != seen_generation;
+                });
+                if (stopping_) {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+
+            run_chunk(worker);
+
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                --remaining_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    task_t const* task_     = nullptr;
+    std::size_t count_      = 0;
+    std::size_t remaining_  = 0;
+    std::size_t generation_ = 0;
+    bool stopping_          = false;
+};
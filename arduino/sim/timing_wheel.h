@@ -0,0 +1,259 @@
+// Hierarchical timing wheel for discrete-event simulation
+
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/** @file **/
+
+/**
+ * @brief Schedules payloads at integer times and fires them in time order
+ *
+ * @p Levels wheels of 2^@p Bits slots each. A level 0 slot holds the events of
+ * one tick, and a level l slot those of 2^(Bits*l) ticks. An event is filed at
+ * the lowest level at which its time shares every higher digit with the
+ * current time. It moves down a level when time reaches its slot. Scheduling
+ * is O(1), and each event is moved at most @p Levels - 1 times before it
+ * fires. Per-level occupancy bitmaps let @c advance jump straight over empty
+ * slots, so sparse schedules cost nothing for the time in between.
+ *
+ * Events due at the same time fire in the order they were scheduled. Events
+ * more than 2^(Bits*Levels) ticks ahead wait in the top level and are re-filed
+ * each time it comes round. Nodes are pooled, so a wheel that has reached its
+ * peak size schedules without allocating.
+ */
+template <typename PayloadT, std::size_t Levels = 4, std::size_t Bits = 8>
+class timing_wheel {
+    static_assert(Levels > 0 && Bits >= 6 && Bits * Levels < 64,
+                  "slots must fill whole bitmap words and times fit in 64 bits");
+
+   public:
+    using time_type    = std::uint64_t;
+    using payload_type = PayloadT;
+
+    /** @brief Slots per level */
+    static constexpr std::size_t kSlots = std::size_t{1} << Bits;
+
+    /** @param now time of the first tick */
+    explicit timing_wheel(time_type now = 0) : now_{now} {
+        for (auto& level : slots_) {
+            level.fill(Slot{});
+        }
+        for (auto& level : occupied_) {
+            level.fill(0);
+        }
+    }
+
+    /** @returns current time */
+    time_type now() const { return now_; }
+
+    /** @returns number of events scheduled and not yet fired */
+    std::size_t size() const { return size_; }
+
+    /** @returns true if no event is scheduled */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Schedules @p payload at @p when
+     * @param when time to fire at, events in the past fire at the current time
+     * @param payload value passed back when the event fires
+     */
+    void schedule(time_type when, PayloadT const& payload) {
+        auto const index = allocate();
+        auto& node       = nodes_[index];
+        node.time        = when < now_ ? now_ : when;
+        node.payload     = payload;
+        file(index);
+        ++size_;
+    }
+
+    /**
+     * @brief Fires every event due at or before @p until, in time order, then moves to @p until
+     * @param until time to advance to, no earlier than @c now
+     * @param on_event called with (time, payload) of each event. It may schedule
+     *        more events, and those due by @p until fire in the same call.
+     * @returns number of events fired
+     */
+    template <typename OnEventT>
+    std::size_t advance(time_type until, OnEventT on_event) {
+        std::size_t fired = 0;
+        while (true) {
+            fired += fire_current(on_event);
+            if (now_ >= until) {
+                return fired;
+            }
+
+            // Next occupied tick in this level 0 rotation
+            auto const digit = static_cast<std::size_t>(now_ & kMask);
+            auto const next  = next_occupied(0, digit + 1);
+            if (next < kSlots) {
+                auto const when = (now_ & ~kMask) | next;
+                if (when > until) {
+                    now_ = until;
+                    return fired;
+                }
+                now_ = when;
+                continue;
+            }
+
+            // Otherwise the start of the next occupied slot higher up
+            auto const when = next_boundary();
+            if (when > until) {
+                now_ = until;
+                return fired;
+            }
+            now_ = when;
+            cascade();
+        }
+    }
+
+   private:
+    static constexpr time_type kMask     = kSlots - 1;
+    static constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t kWords  = kSlots / 64;
+
+    struct Node {
+        time_type time;
+        PayloadT payload;
+        std::uint32_t next;
+    };
+
+    struct Slot {
+        std::uint32_t head = kNone;
+        std::uint32_t tail = kNone;
+    };
+
+    static constexpr std::size_t shift(std::size_t level) { return Bits * level; }
+
+    std::size_t digit(time_type time, std::size_t level) const {
+        return static_cast<std::size_t>((time >> shift(level)) & kMask);
+    }
+
+    std::uint32_t allocate() {
+        if (free_ != kNone) {
+            auto const index = free_;
+            free_            = nodes_[index].next;
+            return index;
+        }
+        nodes_.push_back(Node{});
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void release(std::uint32_t index) {
+        nodes_[index].next = free_;
+        free_              = index;
+    }
+
+    /** @brief Appends node @p index to the slot its time belongs in */
+    void file(std::uint32_t index) {
+        auto const time      = nodes_[index].time;
+        auto const different = time ^ now_;
+        std::size_t level    = 0;
+        while (level + 1 < Levels && (different >> shift(level + 1)) != 0) {
+            ++level;
+        }
+
+        auto const slot_index = digit(time, level);
+        auto& slot            = slots_[level][slot_index];
+        nodes_[index].next    = kNone;
+        if (slot.tail == kNone) {
+            slot.head = index;
+            occupied_[level][slot_index / 64] |= std::uint64_t{1} << (slot_index % 64);
+        } else {
+            nodes_[slot.tail].next = index;
+        }
+        slot.tail = index;
+    }
+
+    /** @returns the list in slot @p slot_index of @p level, leaving the slot empty */
+    std::uint32_t take(std::size_t level, std::size_t slot_index) {
+        auto& slot      = slots_[level][slot_index];
+        auto const head = slot.head;
+        slot            = Slot{};
+        occupied_[level][slot_index / 64] &= ~(std::uint64_t{1} << (slot_index % 64));
+        return head;
+    }
+
+    /** @returns first occupied slot of @p level at or after @p from, or @c kSlots */
+    std::size_t next_occupied(std::size_t level, std::size_t from) const {
+        for (auto word = from / 64; word < kWords; ++word) {
+            auto bits = occupied_[level][word];
+            if (word == from / 64) {
+                bits &= ~std::uint64_t{0} << (from % 64);
+            }
+            if (bits != 0) {
+                return word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits));
+            }
+        }
+        return kSlots;
+    }
+
+    /** @brief Fires the current tick's slot until it stays empty */
+    template <typename OnEventT>
+    std::size_t fire_current(OnEventT& on_event) {
+        std::size_t fired       = 0;
+        auto const slot_index   = digit(now_, 0);
+        while (slots_[0][slot_index].head != kNone) {
+            auto index = take(0, slot_index);
+            while (index != kNone) {
+                auto const next    = nodes_[index].next;
+                auto const time    = nodes_[index].time;
+                auto const payload = nodes_[index].payload;
+                release(index);
+                --size_;
+                ++fired;
+                on_event(time, payload);
+                index = next;
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * @returns start of the next occupied slot above level 0, once the current
+     *          level 0 rotation is exhausted. Past the top level, the next
+     *          rotation of the top level.
+     */
+    time_type next_boundary() const {
+        for (std::size_t level = 1; level < Levels; ++level) {
+            auto const next = next_occupied(level, digit(now_, level) + 1);
+            auto const span = shift(level);
+            if (next < kSlots) {
+                auto const above = (now_ >> (span + Bits)) << (span + Bits);
+                return above | (static_cast<time_type>(next) << span);
+            }
+        }
+        // Nothing filed above the current digits: go round to the next top rotation
+        auto const top_span = shift(Levels);
+        return ((now_ >> top_span) + 1) << top_span;
+    }
+
+    /** @brief Moves the events of every slot whose time has just been reached down a level */
+    void cascade() {
+        // Highest level whose digit just changed, the first to move down
+        std::size_t top = 1;
+        while (top + 1 < Levels && digit(now_, top) == 0) {
+            ++top;
+        }
+        for (auto level = top; level >= 1; --level) {
+            auto index = take(level, digit(now_, level));
+            while (index != kNone) {
+                auto const next = nodes_[index].next;
+                file(index);
+                index = next;
+            }
+        }
+    }
+
+    time_type now_;
+    std::size_t size_ = 0;
+    std::vector<Node> nodes_;
+    std::uint32_t free_ = kNone;
+    std::array<std::array<Slot, kSlots>, Levels> slots_;
+    std::array<std::array<std::uint64_t, kWords>, Levels> occupied_;
+};
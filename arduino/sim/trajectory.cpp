@@ -0,0 +1,480 @@
+// C++ Standard Library
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Superspreader
+#include "game_trace.h"
+#include "population_simulator.h"
+#include "trajectory.h"
+
+namespace {
+
+constexpr char kFileMagic[4] = {'S', 'S', 'T', 'J'};
+
+// Chunk data starts on a cache line, the index on a chunk boundary
+constexpr std::uint64_t kDataOffset = 64;
+
+// Longest run one (run length - 1, value) pair holds
+constexpr std::size_t kMaxRun = 256;
+
+constexpr std::uint64_t align_up(std::uint64_t offset, std::uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Run-length encodes @p values, minus @p previous if given
+ * @returns bytes written to @p out, or 0 if they would be more than @p limit
+ */
+std::size_t encode_runs(std::uint8_t const* values,
+                        std::uint8_t const* previous,
+                        std::size_t count,
+                        std::uint8_t* out,
+                        std::size_t limit) {
+    auto const at = [values, previous](std::size_t i) {
+        return static_cast<std::uint8_t>(previous != nullptr ? values[i] - previous[i] : values[i]);
+    };
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count;) {
+        auto const value = at(i);
+        auto const last  = std::min(count, i + kMaxRun);
+        auto end         = i + 1;
+        while (end < last && at(end) == value) {
+            ++end;
+        }
+        if (size + 2 > limit) {
+            return 0;
+        }
+        out[size++] = static_cast<std::uint8_t>(end - i - 1);
+        out[size++] = value;
+        i           = end;
+    }
+    return size;
+}
+
+/**
+ * @brief Decodes runs into @p values, adding them to what is there if @p delta
+ * @returns false unless the runs cover exactly @p count values
+ */
+bool decode_runs(std::uint8_t const* in,
+                 std::size_t size,
+                 std::uint8_t* values,
+                 std::size_t count,
+                 bool delta) {
+    if (size % 2 != 0) {
+        return false;
+    }
+    std::size_t i = 0;
+    for (std::size_t k = 0; k < size; k += 2) {
+        auto const run   = static_cast<std::size_t>(in[k]) + 1;
+        auto const value = in[k + 1];
+        if (i + run > count) {
+            return false;
+        }
+        if (!delta) {
+            std::memset(values + i, value, run);
+        } else if (value != 0) {
+            for (auto end = i + run; i < end; ++i) {
+                values[i] = static_cast<std::uint8_t>(values[i] + value);
+            }
+            continue;
+        }
+        i += run;
+    }
+    return i == count;
+}
+
+}  // namespace
+
+TrajectoryWriter::TrajectoryWriter(thread_pool& pool) : pool_{pool} {}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    if (fd_ >= 0) {
+        std::string ignored;
+        close(ignored);
+    }
+}
+
+bool TrajectoryWriter::open(std::string const& path,
+                            std::size_t players,
+                            TrajectoryOptions const& options,
+                            std::string& error) {
+    if (fd_ >= 0) {
+        std::string ignored;
+        close(ignored);
+    }
+    if (players == 0 || players > std::numeric_limits<std::uint32_t>::max() ||
+        options.block_players == 0 || options.keyframe_interval == 0) {
+        error = "players, block size and keyframe interval must be positive";
+        return false;
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    players_  = players;
+    options_  = options;
+    blocks_   = (players + options.block_players - 1) / options.block_players;
+    size_     = kDataOffset;
+    capacity_ = 0;
+    for (std::size_t column = 0; column < kNumTrajectoryColumns; ++column) {
+        current_[column].assign(players, 0);
+        previous_[column].assign(players, 0);
+    }
+    scratch_.resize(kNumTrajectoryColumns * blocks_);
+    for (auto& chunk : scratch_) {
+        chunk.resize(options.block_players);
+    }
+    pending_.assign(kNumTrajectoryColumns * blocks_, TrajectoryChunk{});
+    index_.clear();
+
+    // Room for a few uncompressed ticks before the first remap
+    return reserve(kDataOffset + 16 * kNumTrajectoryColumns * players_, error);
+}
+
+bool TrajectoryWriter::append(health_t const* health, std::string& error) {
+    if (fd_ < 0) {
+        error = "no trajectory file open";
+        return false;
+    }
+    auto const keyframe = ticks() % options_.keyframe_interval == 0;
+
+    // Fill in and encode this tick's columns, one block per task
+    pool_.parallel_for(blocks_, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (auto block = begin; block < end; ++block) {
+            auto const first = block * options_.block_players;
+            auto const last  = std::min(players_, first + options_.block_players);
+            auto* const health_column =
+                current_[static_cast<std::size_t>(TrajectoryColumn::HEALTH)].data();
+            auto* const state_column =
+                current_[static_cast<std::size_t>(TrajectoryColumn::STATE)].data();
+            for (auto player = first; player < last; ++player) {
+                health_column[player] = to_trace_health(health[player]);
+                state_column[player] =
+                    static_cast<std::uint8_t>(to_health_class(health[player]));
+            }
+            for (std::size_t column = 0; column < kNumTrajectoryColumns; ++column) {
+                encode(column, block, keyframe);
+            }
+        }
+    });
+
+    // Lay the chunks out one after another, then copy them in parallel
+    auto offset = size_;
+    for (auto& chunk : pending_) {
+        chunk.offset = offset;
+        offset += chunk.size;
+    }
+    if (!reserve(offset, error)) {
+        return false;
+    }
+    pool_.parallel_for(pending_.size(), [this](std::size_t begin, std::size_t end, std::size_t) {
+        for (auto i = begin; i < end; ++i) {
+            std::memcpy(map_ + pending_[i].offset, scratch_[i].data(), pending_[i].size);
+        }
+    });
+    size_ = offset;
+    index_.insert(index_.end(), pending_.begin(), pending_.end());
+    for (std::size_t column = 0; column < kNumTrajectoryColumns; ++column) {
+        current_[column].swap(previous_[column]);
+    }
+    return true;
+}
+
+void TrajectoryWriter::encode(std::size_t column, std::size_t block, bool keyframe) {
+    auto const first   = block * options_.block_players;
+    auto const count   = std::min<std::size_t>(options_.block_players, players_ - first);
+    auto const* values = current_[column].data() + first;
+    auto& out          = scratch_[column * blocks_ + block];
+    auto& chunk        = pending_[column * blocks_ + block];
+
+    std::size_t size = 0;
+    if (options_.compress) {
+        // Runs are worth it only if they take less space than the values
+        auto const* previous = keyframe ? nullptr : previous_[column].data() + first;
+        size                 = encode_runs(values, previous, count, out.data(), count - 1);
+        chunk.encoding = keyframe ? TrajectoryEncoding::RLE : TrajectoryEncoding::DELTA_RLE;
+    }
+    if (size == 0) {
+        std::memcpy(out.data(), values, count);
+        size           = count;
+        chunk.encoding = TrajectoryEncoding::RAW;
+    }
+    chunk.size = static_cast<std::uint32_t>(size);
+}
+
+bool TrajectoryWriter::reserve(std::uint64_t bytes, std::string& error) {
+    if (bytes <= capacity_) {
+        return true;
+    }
+    auto const capacity = std::max(bytes, 2 * capacity_);
+    if (map_ != nullptr) {
+        ::munmap(map_, capacity_);
+        map_ = nullptr;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    auto* map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        error = std::strerror(errno);
+        return false;
+    }
+    map_      = static_cast<std::uint8_t*>(map);
+    capacity_ = capacity;
+    return true;
+}
+
+bool TrajectoryWriter::close(std::string& error) {
+    if (fd_ < 0) {
+        error = "no trajectory file open";
+        return false;
+    }
+
+    auto const index_offset = align_up(size_, sizeof(TrajectoryChunk));
+    auto const end          = index_offset + index_.size() * sizeof(TrajectoryChunk);
+    auto ok                 = map_ != nullptr && reserve(end, error);
+    if (ok) {
+        std::memset(map_ + size_, 0, index_offset - size_);
+        std::memcpy(map_ + index_offset, index_.data(), index_.size() * sizeof(TrajectoryChunk));
+
+        TrajectoryFileHeader header{};
+        std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+        header.version           = kTrajectoryFileVersion;
+        header.columns           = kNumTrajectoryColumns;
+        header.players           = static_cast<std::uint32_t>(players_);
+        header.block_players     = options_.block_players;
+        header.keyframe_interval = options_.keyframe_interval;
+        header.ticks             = ticks();
+        header.index_offset      = index_offset;
+        std::memset(map_, 0, kDataOffset);
+        std::memcpy(map_, &header, sizeof(header));
+    }
+
+    if (map_ != nullptr) {
+        ::munmap(map_, capacity_);
+        map_ = nullptr;
+    }
+    if (ok && ::ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+        error = std::strerror(errno);
+        ok    = false;
+    }
+    if (::close(fd_) != 0 && ok) {
+        error = std::strerror(errno);
+        ok    = false;
+    }
+    fd_       = -1;
+    capacity_ = 0;
+    return ok;
+}
+
+TrajectoryReader::~TrajectoryReader() { close(); }
+
+bool TrajectoryReader::open(std::string const& path, std::string& error) {
+    close();
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        error = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    auto const bytes = static_cast<std::size_t>(info.st_size);
+    if (bytes < kDataOffset) {
+        error = "too short for a trajectory";
+        ::close(fd);
+        return false;
+    }
+
+    auto* data = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        error = std::strerror(errno);
+        return false;
+    }
+
+    auto const* map    = static_cast<std::uint8_t const*>(data);
+    auto const& header = *reinterpret_cast<TrajectoryFileHeader const*>(map);
+    auto const blocks =
+        header.block_players == 0
+            ? 0
+            : (static_cast<std::size_t>(header.players) + header.block_players - 1) /
+                  header.block_players;
+    auto const chunks = header.ticks * kNumTrajectoryColumns * blocks;
+    if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+        error = "not a trajectory";
+    } else if (header.version != kTrajectoryFileVersion ||
+               header.columns != kNumTrajectoryColumns) {
+        error = "unsupported trajectory version";
+    } else if (header.index_offset == 0) {
+        error = "trajectory was not closed";
+    } else if (blocks == 0 || header.keyframe_interval == 0 ||
+               header.index_offset % sizeof(TrajectoryChunk) != 0 ||
+               header.index_offset > bytes ||
+               chunks > (bytes - header.index_offset) / sizeof(TrajectoryChunk)) {
+        error = "trajectory index is out of bounds";
+    } else {
+        // Check every chunk once here, so decoding can trust the index
+        auto const* index = reinterpret_cast<TrajectoryChunk const*>(map + header.index_offset);
+        auto valid        = true;
+        for (std::uint64_t i = 0; i < chunks && valid; ++i) {
+            auto const block = i % blocks;
+            auto const count = std::min<std::size_t>(
+                header.block_players, header.players - block * header.block_players);
+            auto const& chunk = index[i];
+            if (chunk.offset < kDataOffset || chunk.offset > header.index_offset ||
+                chunk.size > header.index_offset - chunk.offset ||
+                chunk.encoding > TrajectoryEncoding::DELTA_RLE ||
+                (chunk.encoding == TrajectoryEncoding::RAW && chunk.size != count) ||
+                (chunk.encoding == TrajectoryEncoding::DELTA_RLE &&
+                 i < kNumTrajectoryColumns * blocks)) {
+                error = "trajectory chunk " + std::to_string(i) + " is out of bounds";
+                valid = false;
+            }
+        }
+        if (valid) {
+            map_    = map;
+            bytes_  = bytes;
+            blocks_ = blocks;
+            index_  = index;
+            return true;
+        }
+    }
+    ::munmap(data, bytes);
+    return false;
+}
+
+TrajectoryChunk const& TrajectoryReader::chunk(std::uint64_t tick,
+                                               TrajectoryColumn column,
+                                               std::size_t block) const {
+    auto const row = tick * kNumTrajectoryColumns + static_cast<std::size_t>(column);
+    return index_[row * blocks_ + block];
+}
+
+bool TrajectoryReader::read(TrajectoryColumn column,
+                            std::uint64_t first_tick,
+                            std::uint64_t tick_count,
+                            std::size_t first_player,
+                            std::size_t player_count,
+                            std::uint8_t* out,
+                            std::string& error) const {
+    if (tick_count == 0) {
+        return true;
+    }
+    TrajectoryCursor cursor{*this, column, first_player, player_count};
+    if (!cursor.seek(first_tick, error)) {
+        return false;
+    }
+    for (std::uint64_t t = 0; t < tick_count; ++t) {
+        if (t > 0 && !cursor.next(error)) {
+            return false;
+        }
+        std::memcpy(out + t * player_count, cursor.values(), player_count);
+    }
+    return true;
+}
+
+void TrajectoryReader::close() {
+    if (map_ != nullptr) {
+        ::munmap(const_cast<std::uint8_t*>(map_), bytes_);
+        map_    = nullptr;
+        bytes_  = 0;
+        blocks_ = 0;
+        index_  = nullptr;
+    }
+}
+
+TrajectoryCursor::TrajectoryCursor(TrajectoryReader const& reader,
+                                   TrajectoryColumn column,
+                                   std::size_t first_player,
+                                   std::size_t player_count)
+    : reader_{reader},
+      column_{column},
+      player_count_{player_count},
+      first_block_{0},
+      last_block_{0},
+      offset_{0} {
+    if (reader_.blocks() == 0 || player_count == 0 ||
+        first_player + player_count > reader_.players()) {
+        return;
+    }
+    first_block_ = first_player / reader_.block_players();
+    last_block_  = (first_player + player_count - 1) / reader_.block_players();
+    offset_      = first_player - first_block_ * reader_.block_players();
+    values_.resize((last_block_ - first_block_ + 1) * reader_.block_players());
+    valid_ = true;
+}
+
+bool TrajectoryCursor::seek(std::uint64_t tick, std::string& error) {
+    if (!valid_ || tick >= reader_.ticks()) {
+        error = "tick or players out of range";
+        return false;
+    }
+    for (auto block = first_block_; block <= last_block_; ++block) {
+        // Back to the last chunk that stands on its own, then forward through the deltas
+        auto start = tick;
+        while (reader_.chunk(start, column_, block).encoding == TrajectoryEncoding::DELTA_RLE) {
+            --start;
+        }
+        for (auto t = start; t <= tick; ++t) {
+            if (!decode(t, block, error)) {
+                return false;
+            }
+        }
+    }
+    tick_ = tick;
+    return true;
+}
+
+bool TrajectoryCursor::next(std::string& error) {
+    if (!valid_ || tick_ + 1 >= reader_.ticks()) {
+        error = "no tick after the last one";
+        return false;
+    }
+    ++tick_;
+    for (auto block = first_block_; block <= last_block_; ++block) {
+        if (!decode(tick_, block, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TrajectoryCursor::decode(std::uint64_t tick, std::size_t block, std::string& error) {
+    auto const& chunk = reader_.chunk(tick, column_, block);
+    auto const first  = block * reader_.block_players();
+    auto const count  = std::min(reader_.block_players(), reader_.players() - first);
+    auto* const out   = values_.data() + (block - first_block_) * reader_.block_players();
+    auto const* in    = reader_.data(chunk);
+
+    auto ok = true;
+    switch (chunk.encoding) {
+        case TrajectoryEncoding::RAW:
+            std::memcpy(out, in, count);
+            break;
+        case TrajectoryEncoding::RLE:
+            ok = decode_runs(in, chunk.size, out, count, false);
+            break;
+        case TrajectoryEncoding::DELTA_RLE:
+            ok = decode_runs(in, chunk.size, out, count, true);
+            break;
+    }
+    if (!ok) {
+        error = "corrupt chunk at tick " + std::to_string(tick);
+    }
+    return ok;
+}
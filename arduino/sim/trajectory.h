@@ -0,0 +1,288 @@
+// Columnar per-tick trajectories of every player, written to and read from mapped files
+
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_core.h"
+#include "thread_pool.h"
+
+/** @file **/
+
+/** @brief Columns stored for every player at every tick */
+enum struct TrajectoryColumn : std::uint8_t {
+    HEALTH = 0, /**< Health, clamped to 255 */
+    STATE  = 1, /**< Display class, a @c HealthClass */
+};
+
+/** @brief Number of distinct @c TrajectoryColumn values */
+constexpr std::size_t kNumTrajectoryColumns = 2;
+
+/** @brief How the values of one chunk are stored */
+enum struct TrajectoryEncoding : std::uint8_t {
+    RAW       = 0, /**< One byte per player */
+    RLE       = 1, /**< (run length - 1, value) byte pairs */
+    DELTA_RLE = 2, /**< Runs of the difference from the previous tick, modulo 256 */
+};
+
+/**
+ * @brief Start of a trajectory file
+ *
+ * Chunks follow the header, and the chunk index follows the chunks. The index
+ * holds a @c TrajectoryChunk for each tick, column and block of players, in
+ * that order.
+ *
+ * @note Native byte order, little-endian on every supported host
+ */
+struct TrajectoryFileHeader {
+    char magic[4];                   /**< "SSTJ" */
+    std::uint16_t version;           /**< @c kTrajectoryFileVersion */
+    std::uint16_t columns;           /**< @c kNumTrajectoryColumns */
+    std::uint32_t players;           /**< Players per tick */
+    std::uint32_t block_players;     /**< Players per chunk, except in the last block */
+    std::uint32_t keyframe_interval; /**< Ticks between chunks that do not need the tick before */
+    std::uint32_t reserved;          /**< Zero */
+    std::uint64_t ticks;             /**< Ticks written */
+    std::uint64_t index_offset;      /**< Offset of the chunk index, zero until closed */
+};
+
+static_assert(sizeof(TrajectoryFileHeader) == 40, "header layout is part of the file format");
+
+/** @brief Location and encoding of the values of one block of players at one tick */
+struct TrajectoryChunk {
+    std::uint64_t offset;        /**< Offset of the first byte in the file */
+    std::uint32_t size;          /**< Bytes stored */
+    TrajectoryEncoding encoding; /**< How the bytes are stored */
+    std::uint8_t reserved[3];    /**< Zero */
+};
+
+static_assert(sizeof(TrajectoryChunk) == 16, "index layout is part of the file format");
+
+/** @brief Trajectory file layout written by @c TrajectoryWriter */
+constexpr std::uint16_t kTrajectoryFileVersion = 1;
+
+/** @brief Layout choices for a new trajectory file */
+struct TrajectoryOptions {
+    std::uint32_t block_players     = 65536; /**< Players per chunk */
+    std::uint32_t keyframe_interval = 64;    /**< Ticks between chunks without deltas */
+    bool compress                   = true;  /**< Run-length encode chunks when it saves space */
+};
+
+/**
+ * @brief Streams the health of every player, one tick at a time, into a mapped file
+ *
+ * Each tick is cut into blocks of @c TrajectoryOptions::block_players players,
+ * and each block of each column becomes one chunk. With compression on, a chunk
+ * holds runs of the differences from the previous tick, or of the values
+ * themselves on keyframe ticks, unless that takes more space than one byte per
+ * player. Blocks are encoded in parallel and copied straight into the mapping,
+ * which grows by doubling, so writing costs about a pass over memory per tick.
+ *
+ * Errors are reported as false plus a reason. A file that is not closed has no
+ * index, and readers reject it.
+ */
+class TrajectoryWriter {
+   public:
+    /** @param pool workers to split blocks across */
+    explicit TrajectoryWriter(thread_pool& pool);
+
+    /** @brief Closes the file, if still open */
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(TrajectoryWriter const&)            = delete;
+    TrajectoryWriter& operator=(TrajectoryWriter const&) = delete;
+
+    /**
+     * @brief Creates or overwrites @p path, closing any file open before
+     * @param path file to write
+     * @param players players in every tick
+     * @param options chunk layout
+     * @param error set to the reason on failure
+     * @returns false if the file could not be created
+     */
+    bool open(std::string const& path,
+              std::size_t players,
+              TrajectoryOptions const& options,
+              std::string& error);
+
+    /**
+     * @brief Appends one tick
+     * @param health health of every player, indexed by player id
+     * @param error set to the reason on failure
+     * @returns false if the file could not grow
+     */
+    bool append(health_t const* health, std::string& error);
+
+    /**
+     * @brief Writes the index and header and closes the file
+     * @param error set to the reason on failure
+     * @returns false if nothing was open or the file could not be finished
+     */
+    bool close(std::string& error);
+
+    /** @returns ticks appended so far */
+    std::uint64_t ticks() const { return index_.size() / (kNumTrajectoryColumns * blocks_); }
+
+    /** @returns bytes of chunk data written so far */
+    std::uint64_t bytes() const { return size_; }
+
+   private:
+    bool reserve(std::uint64_t bytes, std::string& error);
+    void encode(std::size_t column, std::size_t block, bool keyframe);
+
+    thread_pool& pool_;
+    int fd_                 = -1;
+    std::uint8_t* map_      = nullptr;
+    std::uint64_t capacity_ = 0;
+    std::uint64_t size_     = 0;
+    std::size_t players_    = 0;
+    std::size_t blocks_     = 1;
+    TrajectoryOptions options_;
+
+    // Values of this tick and the one before, per column
+    std::vector<std::uint8_t> current_[kNumTrajectoryColumns];
+    std::vector<std::uint8_t> previous_[kNumTrajectoryColumns];
+
+    // Encoded chunks of this tick, one per column and block, and the index so far
+    std::vector<std::vector<std::uint8_t>> scratch_;
+    std::vector<TrajectoryChunk> pending_;
+    std::vector<TrajectoryChunk> index_;
+};
+
+/**
+ * @brief Trajectory file mapped read-only into memory
+ *
+ * Opening checks the header and that every chunk lies inside the file, and
+ * reads nothing else. Values are decoded by @c TrajectoryCursor, so only the
+ * pages of the ticks and players asked for are ever read.
+ */
+class TrajectoryReader {
+   public:
+    TrajectoryReader() = default;
+    ~TrajectoryReader();
+
+    TrajectoryReader(TrajectoryReader const&)            = delete;
+    TrajectoryReader& operator=(TrajectoryReader const&) = delete;
+
+    /**
+     * @brief Maps @p path, unmapping any file mapped before
+     * @param path file written by @c TrajectoryWriter
+     * @param error set to the reason on failure
+     * @returns false if @p path could not be mapped or is not a closed trajectory file
+     */
+    bool open(std::string const& path, std::string& error);
+
+    /** @returns players per tick */
+    std::size_t players() const { return header().players; }
+
+    /** @returns ticks in the file */
+    std::uint64_t ticks() const { return header().ticks; }
+
+    /** @returns players per chunk */
+    std::size_t block_players() const { return header().block_players; }
+
+    /** @returns number of player blocks per tick */
+    std::size_t blocks() const { return blocks_; }
+
+    /** @returns the chunk of @p block of @p column at @p tick, which must be in range */
+    TrajectoryChunk const& chunk(std::uint64_t tick,
+                                 TrajectoryColumn column,
+                                 std::size_t block) const;
+
+    /** @returns the stored bytes of @p chunk */
+    std::uint8_t const* data(TrajectoryChunk const& chunk) const { return map_ + chunk.offset; }
+
+    /**
+     * @brief Reads a range of ticks and players of one column
+     * @param column column to read
+     * @param first_tick first tick to read
+     * @param tick_count number of ticks
+     * @param first_player first player to read
+     * @param player_count number of players
+     * @param out @p tick_count rows of @p player_count values
+     * @param error set to the reason on failure
+     * @returns false if the range is outside the file or a chunk is corrupt
+     */
+    bool read(TrajectoryColumn column,
+              std::uint64_t first_tick,
+              std::uint64_t tick_count,
+              std::size_t first_player,
+              std::size_t player_count,
+              std::uint8_t* out,
+              std::string& error) const;
+
+   private:
+    TrajectoryFileHeader const& header() const {
+        return *reinterpret_cast<TrajectoryFileHeader const*>(map_);
+    }
+    void close();
+
+    std::uint8_t const* map_      = nullptr;
+    std::size_t bytes_            = 0;
+    std::size_t blocks_           = 0;
+    TrajectoryChunk const* index_ = nullptr;
+};
+
+/**
+ * @brief Walks one column of a range of players tick by tick
+ *
+ * Holds the decoded values of the blocks the range touches at the current
+ * tick, so memory grows with the range and not with the number of ticks.
+ * @c seek decodes forward from the last chunk before the tick that does not
+ * need the tick before it, at most @c TrajectoryOptions::keyframe_interval
+ * chunks per block. @c next decodes one chunk per block.
+ */
+class TrajectoryCursor {
+   public:
+    /**
+     * @param reader open file to read, which must outlive the cursor
+     * @param column column to read
+     * @param first_player first player of the range
+     * @param player_count number of players in the range
+     */
+    TrajectoryCursor(TrajectoryReader const& reader,
+                     TrajectoryColumn column,
+                     std::size_t first_player,
+                     std::size_t player_count);
+
+    /**
+     * @brief Moves to @p tick
+     * @returns false if @p tick or the player range is outside the file, or a chunk is corrupt
+     */
+    bool seek(std::uint64_t tick, std::string& error);
+
+    /**
+     * @brief Moves to the tick after the current one
+     * @returns false past the last tick or if a chunk is corrupt
+     */
+    bool next(std::string& error);
+
+    /** @returns current tick */
+    std::uint64_t tick() const { return tick_; }
+
+    /** @returns values of the players in the range at the current tick */
+    std::uint8_t const* values() const { return values_.data() + offset_; }
+
+    /** @returns number of players in the range */
+    std::size_t size() const { return player_count_; }
+
+   private:
+    bool decode(std::uint64_t tick, std::size_t block, std::string& error);
+
+    TrajectoryReader const& reader_;
+    TrajectoryColumn column_;
+    std::size_t player_count_;
+    std::size_t first_block_;
+    std::size_t last_block_;
+    std::size_t offset_;
+    std::uint64_t tick_ = 0;
+    bool valid_         = false;
+
+    // Decoded values of blocks [first_block_, last_block_]
+    std::vector<std::uint8_t> values_;
+};
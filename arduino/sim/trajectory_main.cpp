@@ -0,0 +1,213 @@
+// Summarizes and slices trajectory files written by the population simulator
+//
+// Reads go through a memory mapping and only decode the ticks and players asked
+// for, so files far bigger than RAM can be analyzed.
+//
+// Example:
+//   superspreader_simulator --players 1000000 --ticks 10000 --trajectory run.sstj > run.csv
+//   superspreader_trajectory info run.sstj
+//   superspreader_trajectory counts --every 100 run.sstj > counts.csv
+//   superspreader_trajectory player --player 42 --ticks 5000 100 run.sstj > player42.csv
+
+// C++ Standard Library
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "population_simulator.h"
+#include "trajectory.h"
+
+namespace {
+
+struct Options {
+    std::string command;
+    std::string file;
+    std::size_t first_player = 0;
+    std::size_t players      = 0;  // 0 for every player from first_player on
+    std::uint64_t first_tick = 0;
+    std::uint64_t ticks      = 0;  // 0 for every tick from first_tick on
+    std::uint64_t every      = 1;
+};
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s info FILE\n"
+                 "       %s counts [options] FILE\n"
+                 "       %s player --player N [options] FILE\n"
+                 "  --players FIRST N   players to count (default all)\n"
+                 "  --player N          player to print\n"
+                 "  --ticks FIRST N     ticks to read (default all)\n"
+                 "  --every N           ticks between counts rows (default 1)\n",
+                 program,
+                 program,
+                 program);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    if (argc < 2) {
+        return false;
+    }
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            options.file = arg;
+        } else if (i + 1 >= argc) {
+            return false;
+        } else if (arg == "--player") {
+            options.first_player = std::strtoull(argv[++i], nullptr, 10);
+            options.players      = 1;
+        } else if (arg == "--every") {
+            options.every = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 2 >= argc) {
+            return false;
+        } else if (arg == "--players") {
+            options.first_player = std::strtoull(argv[++i], nullptr, 10);
+            options.players      = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--ticks") {
+            options.first_tick = std::strtoull(argv[++i], nullptr, 10);
+            options.ticks      = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return !options.file.empty() && options.every > 0 &&
+           (options.command == "info" || options.command == "counts" ||
+            (options.command == "player" && options.players == 1));
+}
+
+int info(TrajectoryReader const& reader) {
+    // Encodings and stored bytes straight from the index, without decoding anything
+    std::uint64_t chunks[3] = {};
+    std::uint64_t stored    = 0;
+    for (std::uint64_t tick = 0; tick < reader.ticks(); ++tick) {
+        for (std::size_t column = 0; column < kNumTrajectoryColumns; ++column) {
+            for (std::size_t block = 0; block < reader.blocks(); ++block) {
+                auto const& chunk =
+                    reader.chunk(tick, static_cast<TrajectoryColumn>(column), block);
+                ++chunks[static_cast<std::size_t>(chunk.encoding)];
+                stored += chunk.size;
+            }
+        }
+    }
+    auto const raw = static_cast<double>(reader.ticks()) * static_cast<double>(reader.players()) *
+                     kNumTrajectoryColumns;
+    std::printf("players %zu\nticks %" PRIu64 "\nblock players %zu\n",
+                reader.players(),
+                reader.ticks(),
+                reader.block_players());
+    std::printf("chunks raw %" PRIu64 ", rle %" PRIu64 ", delta rle %" PRIu64 "\n",
+                chunks[0],
+                chunks[1],
+                chunks[2]);
+    std::printf("stored %" PRIu64 " bytes, %.1fx smaller than raw\n",
+                stored,
+                stored > 0 ? raw / static_cast<double>(stored) : 0.0);
+    return EXIT_SUCCESS;
+}
+
+int counts(TrajectoryReader const& reader, Options const& options) {
+    TrajectoryCursor cursor{reader, TrajectoryColumn::STATE, options.first_player, options.players};
+    std::string error;
+    if (!cursor.seek(options.first_tick, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("tick,immune,super_healthy,healthy,infected_asym,infected_sym,"
+                "infected_sym_late,zombie\n");
+    auto const start = std::chrono::steady_clock::now();
+    for (std::uint64_t t = 0; t < options.ticks; ++t) {
+        if (t > 0 && !cursor.next(error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return EXIT_FAILURE;
+        }
+        if (t % options.every != 0) {
+            continue;
+        }
+        ClassCounts classes{};
+        auto const* states = cursor.values();
+        for (std::size_t i = 0; i < cursor.size(); ++i) {
+            ++classes[states[i] < kNumHealthClasses ? states[i] : kNumHealthClasses - 1];
+        }
+        std::printf("%" PRIu64, cursor.tick());
+        for (auto const count : classes) {
+            std::printf(",%zu", count);
+        }
+        std::printf("\n");
+    }
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr,
+                 "%" PRIu64 " ticks x %zu players in %.3f s (%.1f M player-ticks/s)\n",
+                 options.ticks,
+                 options.players,
+                 elapsed,
+                 static_cast<double>(options.ticks) * static_cast<double>(options.players) /
+                     elapsed / 1e6);
+    return EXIT_SUCCESS;
+}
+
+int player(TrajectoryReader const& reader, Options const& options) {
+    std::vector<std::uint8_t> health(options.ticks);
+    std::vector<std::uint8_t> state(options.ticks);
+    std::string error;
+    if (!reader.read(TrajectoryColumn::HEALTH,
+                     options.first_tick,
+                     options.ticks,
+                     options.first_player,
+                     1,
+                     health.data(),
+                     error) ||
+        !reader.read(TrajectoryColumn::STATE,
+                     options.first_tick,
+                     options.ticks,
+                     options.first_player,
+                     1,
+                     state.data(),
+                     error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+    std::printf("tick,health,state\n");
+    for (std::uint64_t t = 0; t < options.ticks; ++t) {
+        std::printf("%" PRIu64 ",%u,%u\n", options.first_tick + t, health[t], state[t]);
+    }
+    return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    TrajectoryReader reader;
+    std::string error;
+    if (!reader.open(options.file, error)) {
+        std::fprintf(stderr, "%s: %s\n", options.file.c_str(), error.c_str());
+        return EXIT_FAILURE;
+    }
+    if (options.players == 0 && options.first_player < reader.players()) {
+        options.players = reader.players() - options.first_player;
+    }
+    if (options.ticks == 0 && options.first_tick < reader.ticks()) {
+        options.ticks = reader.ticks() - options.first_tick;
+    }
+
+    if (options.command == "info") {
+        return info(reader);
+    } else if (options.command == "counts") {
+        return counts(reader, options);
+    }
+    return player(reader, options);
+}
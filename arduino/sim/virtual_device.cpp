@@ -0,0 +1,199 @@
+// C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// Superspreader
+#include "virtual_device.h"
+
+namespace {
+
+// Tick used to key the random streams that place devices
+constexpr auto kPlacementTick = std::numeric_limits<std::uint64_t>::max();
+
+// Random stream keyed by tick and device id, reserved for treatment decisions
+constexpr std::uint64_t kTreatmentStream = 0x7472656174ULL;
+
+std::vector<float> place(FleetConfig const& config, bool along_x) {
+    std::vector<float> positions(config.devices);
+    for (std::size_t id = 0; id < config.devices; ++id) {
+        counter_rng rng{config.seed, kPlacementTick, id};
+        auto const x = static_cast<float>(rng.uniform());
+        auto const y = static_cast<float>(rng.uniform());
+        positions[id] = along_x ? x * config.venue_width : y * config.venue_height;
+    }
+    return positions;
+}
+
+}  // namespace
+
+VirtualAir::VirtualAir(std::vector<float> const& x,
+                       std::vector<float> const& y,
+                       RssiModel const& rssi,
+                       int sensitivity,
+                       std::size_t max_results)
+    : neighbours_(x.size()), current_(x.size()), next_(x.size()) {
+    std::vector<Neighbour> heard;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        heard.clear();
+        for (std::size_t j = 0; j < x.size(); ++j) {
+            if (i == j) {
+                continue;
+            }
+            // Devices closer than 10 cm read as if 10 cm away
+            auto const distance = std::max(std::hypot(x[j] - x[i], y[j] - y[i]), 0.1f);
+            auto const level    = static_cast<int>(std::lround(rssi.rssi_at(distance)));
+            if (level >= sensitivity) {
+                heard.push_back(Neighbour{static_cast<std::uint32_t>(j), level});
+            }
+        }
+
+        // A crowded scan loses the weakest advertisements
+        auto const kept = std::min(heard.size(), max_results);
+        std::partial_sort(heard.begin(),
+                          heard.begin() + kept,
+                          heard.end(),
+                          [](Neighbour const& a, Neighbour const& b) { return a.rssi > b.rssi; });
+        neighbours_[i].assign(heard.begin(), heard.begin() + kept);
+    }
+}
+
+void VirtualAir::advertise(std::size_t device,
+                           char const* display_name,
+                           std::uint8_t const* data,
+                           std::size_t length) {
+    // Advertisement: flags and manufacturer data. Scan response: complete local name.
+    auto& payload = next_[device];
+    auto* out     = payload.bytes.data();
+    auto* end     = out + kMaxPayload;
+
+    *out++ = 0x02;
+    *out++ = 0x01;
+    *out++ = 0x06;
+
+    *out++ = static_cast<std::uint8_t>(length + 1);
+    *out++ = 0xFF;
+    std::memcpy(out, data, length);
+    out += length;
+
+    auto const room        = static_cast<std::size_t>(end - out - 2);
+    auto const name_length = std::min(kMonitorPrefixLength + std::strlen(display_name), room);
+    *out++ = static_cast<std::uint8_t>(name_length + 1);
+    *out++ = 0x09;
+    std::memcpy(out, kMonitorPrefix, std::min(name_length, kMonitorPrefixLength));
+    if (name_length > kMonitorPrefixLength) {
+        std::memcpy(out + kMonitorPrefixLength, display_name, name_length - kMonitorPrefixLength);
+    }
+    out += name_length;
+
+    payload.length = static_cast<std::size_t>(out - payload.bytes.data());
+}
+
+void VirtualAir::publish() { current_ = next_; }
+
+VirtualHal::VirtualHal(std::size_t id, VirtualAir& air, std::uint64_t seed)
+    : id_{id}, air_{air}, seed_{seed}, rng_{seed, 0, id} {}
+
+PlayerState VirtualHal::player_state() const {
+    // Loading repairs RTC memory in place, so read a copy
+    auto player = new_player_state();
+    auto stored = persistent_state_;
+    load_player_state(stored, player);
+    return player;
+}
+
+void VirtualHal::set_health(health_t health) {
+    auto player          = player_state();
+    player.health.health = health;
+    set_player_state(player);
+}
+
+std::vector<EventLogRecord> VirtualHal::event_history() const {
+    auto history = written_events_;
+    history.insert(history.end(), event_log_.begin(), event_log_.end());
+    return history;
+}
+
+void VirtualHal::wake(bool treated) {
+    wake_cause_ = treated ? WakeCause::TREATMENT : WakeCause::TIMER;
+    rng_        = counter_rng{seed_, ++wakes_, id_};
+    run_wake_cycle(*this);
+}
+
+void VirtualHal::wake(bool treated, GameTraceHistogram& trace) {
+    wake_cause_ = treated ? WakeCause::TREATMENT : WakeCause::TIMER;
+    rng_        = counter_rng{seed_, ++wakes_, id_};
+    run_wake_cycle(*this, trace);
+}
+
+VirtualFleet::VirtualFleet(FleetConfig const& config, thread_pool& pool)
+    : config_{config},
+      pool_{pool},
+      air_{place(config, true), place(config, false), config.rssi},
+      traces_(config.trace ? pool.size() : 0) {
+    for (std::size_t id = 0; id < config_.devices; ++id) {
+        devices_.emplace_back(id, air_, config_.seed);
+    }
+
+    // Seed the outbreak at evenly spaced devices so it is independent of the seed
+    auto const zombies = std::min(config_.initial_zombie, config_.devices);
+    for (std::size_t i = 0; i < zombies; ++i) {
+        devices_[i * config_.devices / zombies].set_health(to_health(StateBounds::ZOMBIE));
+    }
+}
+
+void VirtualFleet::run_round() {
+    pool_.parallel_for(
+        devices_.size(), [this](std::size_t begin, std::size_t end, std::size_t worker) {
+            for (std::size_t id = begin; id < end; ++id) {
+                counter_rng rng{
+                    config_.seed ^ kTreatmentStream, static_cast<std::uint64_t>(round_), id};
+                auto const treated = rng.uniform() < config_.treatment_prob;
+                if (traces_.empty()) {
+                    devices_[id].wake(treated);
+                } else {
+                    devices_[id].wake(treated, traces_[worker]);
+                }
+            }
+        });
+    air_.publish();
+    ++round_;
+}
+
+ClassCounts VirtualFleet::class_counts() const {
+    ClassCounts counts{};
+    for (auto const& device : devices_) {
+        ++counts[static_cast<std::size_t>(to_health_class(device.health()))];
+    }
+    return counts;
+}
+
+std::uint64_t VirtualFleet::total_awake_us() const {
+    std::uint64_t total = 0;
+    for (auto const& device : devices_) {
+        total += device.awake_us();
+    }
+    return total;
+}
+
+WakeProfile VirtualFleet::wake_profile() const {
+    WakeProfile total{};
+    for (auto const& device : devices_) {
+        auto const& profile = device.wake_profile();
+        total.wakes += profile.wakes;
+        for (std::size_t i = 0; i < kNumWakePhases; ++i) {
+            total.duration_us[i] += profile.duration_us[i];
+            total.energy_nj[i] += profile.energy_nj[i];
+        }
+    }
+    return total;
+}
+
+GameTraceHistogram VirtualFleet::game_trace() const {
+    GameTraceHistogram total;
+    for (auto const& trace : traces_) {
+        total.merge(trace);
+    }
+    return total;
+}
@@ -0,0 +1,283 @@
+// Virtual health monitors running the firmware wake cycle in-process
+
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Superspreader
+#include "contact_engine.h"
+#include "counter_rng.h"
+#include "game_trace_histogram.h"
+#include "population_simulator.h"
+#include "thread_pool.h"
+#include "wake_cycle.h"
+
+/** @file **/
+
+/**
+ * @brief Radio environment shared by virtual devices
+ *
+ * Devices sit at fixed positions and hear each other with the RSSI given by an
+ * @c RssiModel. Advertisements are double-buffered: scans during a round see what
+ * every device advertised in the previous round, so all devices can wake in
+ * parallel without locking.
+ */
+class VirtualAir {
+   public:
+    /** @brief Largest advertisement plus scan response, in bytes */
+    static constexpr std::size_t kMaxPayload = 62;
+
+    /**
+     * @brief Places devices and works out who can hear whom
+     * @param x position of each device along x in meters
+     * @param y position of each device along y in meters
+     * @param rssi signal model
+     * @param sensitivity weakest RSSI in dBm a scan still reports
+     * @param max_results most devices one scan reports, keeping the strongest
+     */
+    VirtualAir(std::vector<float> const& x,
+               std::vector<float> const& y,
+               RssiModel const& rssi,
+               int sensitivity         = -100,
+               std::size_t max_results = 256);
+
+    /** @returns number of devices */
+    std::size_t size() const { return neighbours_.size(); }
+
+    /** @returns BLE address of @p device, unique within the air */
+    static constexpr ble_address_t address(std::size_t device) {
+        return 0x5A0000000000ULL | static_cast<ble_address_t>(device);
+    }
+
+    /**
+     * @brief Sets what @p device advertises from the next round on
+     * @param device index of the advertising device
+     * @param display_name text after @c kMonitorPrefix, sent in the scan response
+     * @param data manufacturer specific data
+     * @param length number of bytes in @p data
+     */
+    void advertise(std::size_t device,
+                   char const* display_name,
+                   std::uint8_t const* data,
+                   std::size_t length);
+
+    /**
+     * @brief Reports devices in radio range of @p device, as of the previous round
+     * @param device index of the scanning device
+     * @param on_device called with (address, rssi, payload, length) of each device heard,
+     *        strongest first, until it returns false
+     * @returns fraction of the devices in range that were reported
+     */
+    template <typename OnDeviceT>
+    double scan(std::size_t device, OnDeviceT on_device) const {
+        auto const& neighbours = neighbours_[device];
+        for (std::size_t i = 0; i < neighbours.size(); ++i) {
+            auto const& payload = current_[neighbours[i].device];
+            if (payload.length > 0 && !on_device(address(neighbours[i].device),
+                                                 neighbours[i].rssi,
+                                                 payload.bytes.data(),
+                                                 payload.length)) {
+                return static_cast<double>(i + 1) / static_cast<double>(neighbours.size());
+            }
+        }
+        return 1.0;
+    }
+
+    /** @brief Makes this round's advertisements visible to the next round's scans */
+    void publish();
+
+   private:
+    struct Neighbour {
+        std::uint32_t device;
+        int rssi;
+    };
+
+    struct Payload {
+        std::array<std::uint8_t, kMaxPayload> bytes;
+        std::size_t length = 0;
+    };
+
+    std::vector<std::vector<Neighbour>> neighbours_;
+    std::vector<Payload> current_;
+    std::vector<Payload> next_;
+};
+
+/**
+ * @brief In-process hardware for @c run_wake_cycle
+ *
+ * RTC memory, LEDs and sleep are plain members. Time spent in delays and scans
+ * is added to a virtual clock instead of being waited for, so a wake costs only
+ * the CPU time of the firmware logic. A scan stopped early is charged the share
+ * of the window it took to hear the devices reported.
+ */
+class VirtualHal {
+   public:
+    /**
+     * @param id index of this device in @p air
+     * @param air radio environment to advertise into and scan
+     * @param seed seed for the device's random stream
+     */
+    VirtualHal(std::size_t id, VirtualAir& air, std::uint64_t seed);
+
+    VirtualHal(VirtualHal const&)            = delete;
+    VirtualHal& operator=(VirtualHal const&) = delete;
+
+    //// HAL, see run_wake_cycle ////////////////////////////////////////
+
+    PersistentState& persistent_state() { return persistent_state_; }
+    InterruptEventQueue& interrupt_queue() { return interrupt_queue_; }
+    void begin() { leds_ = {}; }
+    WakeCause wakeup_cause() const { return wake_cause_; }
+    void set_led(Led led, bool on) { leds_[static_cast<std::size_t>(led)] = on; }
+    void blink_led(Led, std::uint64_t period_us) { blink_period_us_ = period_us; }
+    void advertise(char const* display_name, std::uint8_t const* data, std::size_t length) {
+        air_.advertise(id_, display_name, data, length);
+    }
+    template <typename OnDeviceT>
+    void scan(int seconds, OnDeviceT on_device) {
+        // Advertisements are taken to arrive evenly over the window
+        auto const heard = air_.scan(id_, on_device);
+        awake_us_ += static_cast<std::uint64_t>(heard * seconds * uS_TO_S_FACTOR);
+    }
+    void delay_ms(std::uint32_t ms) { awake_us_ += ms * 1000ULL; }
+    long random(long low, long high) {
+        return low + static_cast<long>(rng_.below(static_cast<std::uint64_t>(high - low)));
+    }
+    void log(char const*) {}
+    void log(char const*, long) {}
+    void deep_sleep(std::uint64_t timer_us) { sleep_us_ = timer_us; }
+    std::uint64_t micros() const { return awake_us_; }
+    WakeProfile& wake_profile() { return wake_profile_; }
+    EventLog& event_log() { return event_log_; }
+    void write_event_log(EventLogRecord const* records, std::size_t count) {
+        written_events_.insert(written_events_.end(), records, records + count);
+    }
+
+    //// Virtual device controls ////////////////////////////////////////
+
+    /**
+     * @brief Runs one wake cycle
+     * @param treated if true, the device was woken by the treatment pin
+     */
+    void wake(bool treated);
+
+    /**
+     * @brief Runs one wake cycle, adding its @c game_update trace to @p trace
+     * @param treated if true, the device was woken by the treatment pin
+     * @param trace histograms to add to
+     */
+    void wake(bool treated, GameTraceHistogram& trace);
+
+    /** @brief Raises the treatment interrupt while awake, as the ISR does */
+    void press_treatment() { interrupt_queue_.try_emplace_back(TreatmentEvent{}); }
+
+    /** @returns player as stored in RTC memory, or a new player before the first wake */
+    PlayerState player_state() const;
+
+    /** @brief Overwrites the player in RTC memory, clearing its wake history */
+    void set_player_state(PlayerState const& player) {
+        reset_persistent_state(player, persistent_state_);
+    }
+
+    /** @brief Overwrites the health in RTC memory, keeping the tick */
+    void set_health(health_t health);
+
+    /** @returns current health, as stored in RTC memory */
+    health_t health() const { return player_state().health.health; }
+
+    /** @returns true if @p led is on */
+    bool led(Led led) const { return leds_[static_cast<std::size_t>(led)]; }
+
+    /** @returns sleep requested at the end of the last wake, in microseconds */
+    std::uint64_t sleep_us() const { return sleep_us_; }
+
+    /** @returns virtual time spent awake in delays and scans over all wakes, in microseconds */
+    std::uint64_t awake_us() const { return awake_us_; }
+
+    /** @returns per-phase time and energy over all wakes, charged on the virtual clock */
+    WakeProfile const& wake_profile() const { return wake_profile_; }
+
+    /** @returns event log records of every wake, oldest first, flushed or still in RTC memory */
+    std::vector<EventLogRecord> event_history() const;
+
+   private:
+    std::size_t id_;
+    VirtualAir& air_;
+    std::uint64_t seed_;
+    std::uint64_t wakes_ = 0;
+    counter_rng rng_;
+
+    // RTC memory
+    PersistentState persistent_state_{};
+    InterruptEventQueue interrupt_queue_;
+    WakeProfile wake_profile_{};
+    EventLog event_log_;
+
+    std::vector<EventLogRecord> written_events_;  // flushed by write_event_log
+    WakeCause wake_cause_ = WakeCause::OTHER;
+    std::array<bool, 3> leds_{};
+    std::uint64_t blink_period_us_ = 0;
+    std::uint64_t sleep_us_        = 0;
+    std::uint64_t awake_us_        = 0;
+};
+
+/** @brief Parameters of a virtual device run */
+struct FleetConfig {
+    std::size_t devices        = 1000;  /**< Number of virtual health monitors */
+    std::size_t initial_zombie = 10;    /**< Devices that start as zombies */
+    double treatment_prob      = 0.01;  /**< Chance a device is woken by treatment */
+    float venue_width          = 50.0f; /**< Venue extent along x in meters */
+    float venue_height         = 50.0f; /**< Venue extent along y in meters */
+    std::uint64_t seed         = 1;     /**< Seed for placement and every device */
+    RssiModel rssi;                     /**< Signal model between devices */
+    bool trace                 = false; /**< Trace every game update, see @c game_trace */
+};
+
+/**
+ * @brief Many virtual devices waking in lockstep rounds
+ *
+ * Every round each device runs one @c run_wake_cycle, split across a
+ * @c thread_pool, then the round's advertisements are published.
+ */
+class VirtualFleet {
+   public:
+    /**
+     * @param config fleet parameters
+     * @param pool workers to split devices across
+     */
+    VirtualFleet(FleetConfig const& config, thread_pool& pool);
+
+    /** @brief Wakes every device once */
+    void run_round();
+
+    /** @returns rounds run so far */
+    int round() const { return round_; }
+
+    /** @returns device @p id */
+    VirtualHal& device(std::size_t id) { return devices_[id]; }
+
+    /** @returns number of devices currently in each display class */
+    ClassCounts class_counts() const;
+
+    /** @returns virtual awake time summed over every device and wake, in microseconds */
+    std::uint64_t total_awake_us() const;
+
+    /** @returns wake profiles of every device added together */
+    WakeProfile wake_profile() const;
+
+    /** @returns traces of every game update so far, empty unless @c FleetConfig::trace is set */
+    GameTraceHistogram game_trace() const;
+
+   private:
+    FleetConfig config_;
+    thread_pool& pool_;
+    int round_ = 0;
+    VirtualAir air_;
+    std::deque<VirtualHal> devices_;
+    std::vector<GameTraceHistogram> traces_;  // one per worker, if tracing
+};
@@ -0,0 +1,141 @@
+// Runs many virtual health monitors through the firmware wake cycle
+//
+// Example:
+//   superspreader_virtual_devices --devices 2000 --rounds 100 --venue 60 40 > run.csv
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Superspreader
+#include "event_log_replay.h"
+#include "game_trace_histogram.h"
+#include "thread_pool.h"
+#include "virtual_device.h"
+#include "wake_profile_report.h"
+
+namespace {
+
+struct Options {
+    FleetConfig config;
+    int rounds          = 100;
+    std::size_t threads = 0;
+    std::string event_logs;
+};
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --devices N          number of virtual health monitors (default 1000)\n"
+                 "  --initial-zombie N   devices that start as zombies (default 10)\n"
+                 "  --treatment-prob P   chance a device is woken by treatment (default 0.01)\n"
+                 "  --venue W H          venue size in meters (default 50 50)\n"
+                 "  --rounds N           wake cycles per device (default 100)\n"
+                 "  --threads N          worker threads, 0 for all cores (default 0)\n"
+                 "  --seed N             random seed (default 1)\n"
+                 "  --event-logs DIR     write each device's event log to DIR/device_<id>.sslog\n"
+                 "  --trace              print histograms of every game update's trace\n",
+                 program);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--trace") {
+            options.config.trace = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        char const* value = argv[++i];
+        if (arg == "--devices") {
+            options.config.devices = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--initial-zombie") {
+            options.config.initial_zombie = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--treatment-prob") {
+            options.config.treatment_prob = std::strtod(value, nullptr);
+        } else if (arg == "--venue") {
+            if (i + 1 >= argc) {
+                return false;
+            }
+            options.config.venue_width  = std::strtof(value, nullptr);
+            options.config.venue_height = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--rounds") {
+            options.rounds = std::atoi(value);
+        } else if (arg == "--threads") {
+            options.threads = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            options.config.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--event-logs") {
+            options.event_logs = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_row(int round, ClassCounts const& counts) {
+    std::printf("%d", round);
+    for (auto const count : counts) {
+        std::printf(",%zu", count);
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    thread_pool pool{options.threads};
+    VirtualFleet fleet{options.config, pool};
+
+    std::printf("round,immune,super_healthy,healthy,infected_asym,infected_sym,"
+                "infected_sym_late,zombie\n");
+    print_row(fleet.round(), fleet.class_counts());
+
+    auto const start = std::chrono::steady_clock::now();
+    for (int r = 0; r < options.rounds; ++r) {
+        fleet.run_round();
+        print_row(fleet.round(), fleet.class_counts());
+    }
+    auto const elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto const wakes = static_cast<double>(options.config.devices) * options.rounds;
+    std::fprintf(stderr,
+                 "%zu devices x %d wakes on %zu threads in %.3f s (%.0f ns CPU per wake, "
+                 "%.2f s virtual awake time per wake)\n",
+                 options.config.devices,
+                 options.rounds,
+                 pool.size(),
+                 elapsed,
+                 elapsed / wakes * 1e9 * static_cast<double>(pool.size()),
+                 static_cast<double>(fleet.total_awake_us()) / wakes / 1e6);
+    print_wake_profile(fleet.wake_profile(), 1000.0, stderr);
+    if (options.config.trace) {
+        print_game_trace(fleet.game_trace(), stderr);
+    }
+
+    if (!options.event_logs.empty()) {
+        for (std::size_t id = 0; id < options.config.devices; ++id) {
+            auto const path    = options.event_logs + "/device_" + std::to_string(id) + ".sslog";
+            auto const records = fleet.device(id).event_history();
+            if (!write_event_log_file(
+                    path, static_cast<std::uint32_t>(id), records.data(), records.size())) {
+                std::fprintf(stderr, "could not write %s\n", path.c_str());
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+// Reports where battery time goes from a health monitor's serial log
+//
+// Each wake logs its accumulated profile, so the last record in the log covers
+// every wake since power on.
+//
+// Example:
+//   superspreader_wake_profile --battery-mah 500 < serial.log
+
+// C++ Standard Library
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Superspreader
+#include "wake_profile_report.h"
+
+namespace {
+
+void print_usage(char const* program) {
+    std::fprintf(stderr,
+                 "usage: %s [options] < serial.log\n"
+                 "  --battery-mah N   battery capacity (default 1000)\n",
+                 program);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double battery_mah = 1000.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--battery-mah" && i + 1 < argc) {
+            battery_mah = std::strtod(argv[++i], nullptr);
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    WakeProfile profile{};
+    bool found = false;
+    char line[1024];
+    while (std::fgets(line, sizeof(line), stdin) != nullptr) {
+        found = parse_wake_profile(line, profile) || found;
+    }
+    if (!found) {
+        std::fprintf(stderr, "no wake_profile record in input\n");
+        return EXIT_FAILURE;
+    }
+
+    print_wake_profile(profile, battery_mah, stdout);
+    return EXIT_SUCCESS;
+}
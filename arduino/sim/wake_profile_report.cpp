@@ -0,0 +1,60 @@
+// Superspreader
+#include "wake_profile_report.h"
+
+namespace {
+
+std::uint64_t total_duration_us(WakeProfile const& profile) {
+    std::uint64_t total = 0;
+    for (auto const duration : profile.duration_us) {
+        total += duration;
+    }
+    return total;
+}
+
+std::uint64_t total_energy_nj(WakeProfile const& profile) {
+    std::uint64_t total = 0;
+    for (auto const energy : profile.energy_nj) {
+        total += energy;
+    }
+    return total;
+}
+
+double percent(std::uint64_t part, std::uint64_t whole) {
+    return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+}  // namespace
+
+double average_power_mw(WakeProfile const& profile) {
+    auto const duration_us = total_duration_us(profile);
+    // nJ per us is mW
+    return duration_us > 0 ? static_cast<double>(total_energy_nj(profile)) / duration_us : 0.0;
+}
+
+double battery_life_hours(WakeProfile const& profile, double battery_mah) {
+    auto const power_mw = average_power_mw(profile);
+    return power_mw > 0 ? battery_mah * kBatteryVolts / power_mw : 0.0;
+}
+
+void print_wake_profile(WakeProfile const& profile, double battery_mah, std::FILE* out) {
+    auto const wakes       = profile.wakes > 0 ? static_cast<double>(profile.wakes) : 1.0;
+    auto const duration_us = total_duration_us(profile);
+    auto const energy_nj   = total_energy_nj(profile);
+
+    std::fprintf(out, "%u wakes\n", static_cast<unsigned>(profile.wakes));
+    std::fprintf(out, "%-12s %12s %8s %12s %8s\n", "phase", "ms/wake", "time", "mJ/wake", "energy");
+    for (std::size_t i = 0; i < kNumWakePhases; ++i) {
+        std::fprintf(out,
+                     "%-12s %12.1f %7.1f%% %12.2f %7.1f%%\n",
+                     wake_phase_name(static_cast<WakePhase>(i)),
+                     static_cast<double>(profile.duration_us[i]) / wakes / 1e3,
+                     percent(profile.duration_us[i], duration_us),
+                     static_cast<double>(profile.energy_nj[i]) / wakes / 1e6,
+                     percent(profile.energy_nj[i], energy_nj));
+    }
+    std::fprintf(out,
+                 "average power %.2f mW, %.0f mAh battery lasts %.1f h\n",
+                 average_power_mw(profile),
+                 battery_mah,
+                 battery_life_hours(profile, battery_mah));
+}
@@ -0,0 +1,31 @@
+// Summaries of a WakeProfile logged by health monitors
+
+#pragma once
+
+// C++ Standard Library
+#include <cstdio>
+
+// Superspreader
+#include "wake_profile.h"
+
+/** @file **/
+
+/** @brief Battery voltage assumed by the power estimates in @c kPhasePowerUw */
+constexpr double kBatteryVolts = 3.3;
+
+/** @returns average power over every wake and sleep in @p profile, in milliwatts */
+double average_power_mw(WakeProfile const& profile);
+
+/**
+ * @returns hours a battery of @p battery_mah lasts at the average power of @p profile,
+ *          or 0 if @p profile is empty
+ */
+double battery_life_hours(WakeProfile const& profile, double battery_mah);
+
+/**
+ * @brief Prints per-wake time and energy of each phase, and the expected battery life
+ * @param profile accumulated profile, such as one read by @c parse_wake_profile
+ * @param battery_mah battery capacity in milliamp hours
+ * @param out stream to print to
+ */
+void print_wake_profile(WakeProfile const& profile, double battery_mah, std::FILE* out);
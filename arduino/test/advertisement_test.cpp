@@ -0,0 +1,269 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "advertisement.h"
+
+namespace {
+
+std::vector<AdvertisedState> const kStates = {
+    AdvertisedState::IMMUNE,
+    AdvertisedState::SUPER_HEALTHY,
+    AdvertisedState::HEALTHY,
+    AdvertisedState::ASYMPTOMATIC,
+    AdvertisedState::SICK,
+    AdvertisedState::ZOMBIE,
+    AdvertisedState::CAT,
+};
+
+AdvertisedState classify(std::string const& name) {
+    return classify_name(name.data(), name.size());
+}
+
+/** @brief String based classification the firmware used before, as a reference */
+AdvertisedState classify_reference(std::string const& name) {
+    std::string const prefix = kMonitorPrefix;
+    if (name.rfind(prefix, 0) != 0) {
+        return AdvertisedState::UNKNOWN;
+    }
+    auto const state = name.substr(prefix.length());
+    for (auto const candidate : kStates) {
+        if (state == to_display_name(candidate)) {
+            return candidate;
+        }
+    }
+    return AdvertisedState::UNKNOWN;
+}
+
+/** @returns advertising data with a flags structure followed by a complete local name */
+std::vector<std::uint8_t> make_payload(std::string const& name) {
+    std::vector<std::uint8_t> payload{0x02, 0x01, 0x06};
+    payload.push_back(static_cast<std::uint8_t>(name.size() + 1));
+    payload.push_back(0x09);
+    payload.insert(payload.end(), name.begin(), name.end());
+    return payload;
+}
+
+}  // namespace
+
+TEST(AdvertisementTests, ClassifiesEveryDisplayName) {
+    for (auto const state : kStates) {
+        EXPECT_EQ(classify(std::string{kMonitorPrefix} + to_display_name(state)), state)
+            << to_display_name(state);
+    }
+}
+
+TEST(AdvertisementTests, RejectsOtherDevices) {
+    EXPECT_EQ(classify(""), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("HM - "), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("HM - Zombi"), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("HM - Zombie -2"), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("HM -Sick"), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("hm - Sick"), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("Sick"), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify("Galaxy Buds"), AdvertisedState::UNKNOWN);
+}
+
+TEST(AdvertisementTests, DoesNotReadPastLength) {
+    char const name[] = "HM - Zombie -1";
+    EXPECT_EQ(classify_name(name, 11), AdvertisedState::ZOMBIE);
+    EXPECT_EQ(classify_name(name, 14), AdvertisedState::CAT);
+}
+
+TEST(AdvertisementTests, InfectedHumansMatchHealth) {
+    for (health_t health = 0; health < kNumHealthValues; ++health) {
+        auto const state = to_advertised_state(health);
+        EXPECT_EQ(is_infected_human(state), is_infected(health) || is_zombie(health))
+            << "health=" << health;
+        EXPECT_FALSE(is_cat(state));
+    }
+}
+
+TEST(AdvertisementTests, ClassifiesRawAdvertisement) {
+    for (auto const state : kStates) {
+        auto const payload = make_payload(std::string{kMonitorPrefix} + to_display_name(state));
+        EXPECT_EQ(classify_advertisement(payload.data(), payload.size()), state);
+    }
+
+    // Shortened names are accepted too
+    auto payload = make_payload("HM - Sick");
+    payload[4]   = 0x08;
+    EXPECT_EQ(classify_advertisement(payload.data(), payload.size()), AdvertisedState::SICK);
+
+    // Padding ends the advertisement
+    std::vector<std::uint8_t> padded{0x02, 0x01, 0x06, 0x00, 0x00};
+    EXPECT_EQ(classify_advertisement(padded.data(), padded.size()), AdvertisedState::UNKNOWN);
+    EXPECT_EQ(classify_advertisement(nullptr, 0), AdvertisedState::UNKNOWN);
+}
+
+TEST(AdvertisementTests, RejectsTruncatedAdvertisement) {
+    auto const payload = make_payload("HM - Zombie");
+    for (std::size_t length = 0; length < payload.size(); ++length) {
+        // Copy so reading past the end is caught by sanitizers
+        std::vector<std::uint8_t> const truncated{payload.begin(), payload.begin() + length};
+        EXPECT_EQ(classify_advertisement(truncated.data(), truncated.size()),
+                  AdvertisedState::UNKNOWN)
+            << "length=" << length;
+    }
+}
+
+TEST(AdvertisementCodecTests, RoundTripsEveryHealth) {
+    for (health_t health = 0; health < kNumHealthValues; ++health) {
+        std::uint8_t data[kManufacturerDataSize];
+        encode_manufacturer_data(to_advertised_state(health), health, data);
+        auto const decoded = decode_manufacturer_data(data, sizeof(data));
+        EXPECT_EQ(decoded.state, to_advertised_state(health)) << "health=" << health;
+        EXPECT_EQ(decoded.health, health);
+    }
+}
+
+TEST(AdvertisementCodecTests, RoundTripsEveryState) {
+    for (auto const state : kStates) {
+        std::uint8_t data[kManufacturerDataSize];
+        encode_manufacturer_data(state, to_health(StateBounds::ZOMBIE), data);
+        EXPECT_EQ(decode_manufacturer_data(data, sizeof(data)).state, state);
+    }
+}
+
+TEST(AdvertisementCodecTests, ClampsHealth) {
+    std::uint8_t data[kManufacturerDataSize];
+    encode_manufacturer_data(AdvertisedState::ZOMBIE, 1000, data);
+    EXPECT_EQ(decode_manufacturer_data(data, sizeof(data)).health,
+              to_health(StateBounds::ZOMBIE));
+}
+
+TEST(AdvertisementCodecTests, LayoutIsStable) {
+    std::uint8_t data[kManufacturerDataSize];
+    encode_manufacturer_data(AdvertisedState::SICK, 75, data);
+    std::vector<std::uint8_t> const expected{0xFF, 0xFF, 0x5A, 0x15, 75};
+    EXPECT_EQ(std::vector<std::uint8_t>(data, data + sizeof(data)), expected);
+}
+
+TEST(AdvertisementCodecTests, RejectsForeignData) {
+    std::uint8_t valid[kManufacturerDataSize];
+    encode_manufacturer_data(AdvertisedState::ZOMBIE, 99, valid);
+
+    auto decode_with = [&valid](std::size_t index, std::uint8_t value) {
+        std::vector<std::uint8_t> data{valid, valid + sizeof(valid)};
+        data[index] = value;
+        return decode_manufacturer_data(data.data(), data.size());
+    };
+    EXPECT_EQ(decode_with(0, 0x4C).state, AdvertisedState::UNKNOWN);  // another company
+    EXPECT_EQ(decode_with(2, 0x00).state, AdvertisedState::UNKNOWN);  // magic
+    EXPECT_EQ(decode_with(3, 0x26).state, AdvertisedState::UNKNOWN);  // version 2
+    EXPECT_EQ(decode_with(3, 0x10).state, AdvertisedState::UNKNOWN);  // UNKNOWN state
+    EXPECT_EQ(decode_with(3, 0x18).state, AdvertisedState::UNKNOWN);  // state out of range
+    EXPECT_EQ(decode_with(4, 100).state, AdvertisedState::UNKNOWN);   // health out of range
+    EXPECT_EQ(decode_with(4, 100).health, 0u);
+    EXPECT_EQ(decode_manufacturer_data(valid, sizeof(valid) - 1).state, AdvertisedState::UNKNOWN);
+
+    // Trailing bytes are left for later additions
+    std::vector<std::uint8_t> longer{valid, valid + sizeof(valid)};
+    longer.push_back(0xAB);
+    EXPECT_EQ(decode_manufacturer_data(longer.data(), longer.size()).state,
+              AdvertisedState::ZOMBIE);
+}
+
+TEST(AdvertisementCodecTests, ClassifiesBinaryAndTextAdvertisements) {
+    std::uint8_t data[kManufacturerDataSize];
+    encode_manufacturer_data(AdvertisedState::ASYMPTOMATIC, 45, data);
+
+    std::vector<std::uint8_t> payload{0x02, 0x01, 0x06, kManufacturerDataSize + 1, 0xFF};
+    payload.insert(payload.end(), data, data + sizeof(data));
+    EXPECT_EQ(classify_advertisement(payload.data(), payload.size()),
+              AdvertisedState::ASYMPTOMATIC);
+
+    // Foreign manufacturer data does not hide a text name from older firmware
+    std::vector<std::uint8_t> mixed{0x03, 0xFF, 0x4C, 0x00};
+    auto const named = make_payload("HM - Zombie");
+    mixed.insert(mixed.end(), named.begin(), named.end());
+    EXPECT_EQ(classify_advertisement(mixed.data(), mixed.size()), AdvertisedState::ZOMBIE);
+}
+
+TEST(AdvertisementFuzzTests, NamesMatchReference) {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::uniform_int_distribution<std::size_t> pick{0, kStates.size() - 1};
+    std::uniform_int_distribution<int> mutation{0, 4};
+
+    for (int n = 0; n < 200000; ++n) {
+        std::string name = std::string{kMonitorPrefix} + to_display_name(kStates[pick(gen)]);
+        switch (mutation(gen)) {
+            case 0:  // flip one character
+                name[std::uniform_int_distribution<std::size_t>{0, name.size() - 1}(gen)] =
+                    static_cast<char>(byte(gen));
+                break;
+            case 1:  // truncate
+                name.resize(std::uniform_int_distribution<std::size_t>{0, name.size()}(gen));
+                break;
+            case 2:  // append
+                name.push_back(static_cast<char>(byte(gen)));
+                break;
+            case 3:  // random bytes
+                name.resize(std::uniform_int_distribution<std::size_t>{0, 24}(gen));
+                for (auto& c : name) {
+                    c = static_cast<char>(byte(gen));
+                }
+                break;
+            default:  // unchanged
+                break;
+        }
+        // Copy to an exact-size buffer so reading past the end is caught by sanitizers
+        std::vector<char> const buffer{name.begin(), name.end()};
+        ASSERT_EQ(classify_name(buffer.data(), buffer.size()), classify_reference(name))
+            << "name=" << name;
+    }
+}
+
+TEST(AdvertisementFuzzTests, RandomManufacturerDataDecodesConsistently) {
+    std::mt19937 gen{11};
+    std::uniform_int_distribution<int> byte{0, 255};
+
+    for (int n = 0; n < 200000; ++n) {
+        std::vector<std::uint8_t> data(kManufacturerDataSize);
+        for (auto& b : data) {
+            b = static_cast<std::uint8_t>(byte(gen));
+        }
+        // Keep the header valid half of the time so accepted data is exercised
+        if (n % 2 == 0) {
+            encode_manufacturer_data(AdvertisedState::UNKNOWN, 0, data.data());
+            data[3] |= static_cast<std::uint8_t>(byte(gen) & 0x0F);
+            data[4] = static_cast<std::uint8_t>(byte(gen));
+        }
+
+        auto const decoded = decode_manufacturer_data(data.data(), data.size());
+        if (decoded.state == AdvertisedState::UNKNOWN) {
+            ASSERT_EQ(decoded.health, 0u);
+            continue;
+        }
+        // Anything accepted encodes back to the same bytes
+        std::uint8_t encoded[kManufacturerDataSize];
+        encode_manufacturer_data(decoded.state, decoded.health, encoded);
+        ASSERT_EQ(std::vector<std::uint8_t>(encoded, encoded + sizeof(encoded)), data);
+    }
+}
+
+TEST(AdvertisementFuzzTests, RandomAdvertisementsStayInBounds) {
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::uniform_int_distribution<std::size_t> size{0, 31};
+
+    for (int n = 0; n < 200000; ++n) {
+        std::vector<std::uint8_t> payload(size(gen));
+        for (auto& b : payload) {
+            b = static_cast<std::uint8_t>(byte(gen));
+        }
+        // Bias towards name and manufacturer structures so both parsers are reached
+        if (payload.size() > 1 && n % 3 != 0) {
+            payload[1] = n % 3 == 1 ? 0x09 : 0xFF;
+        }
+        auto const state = classify_advertisement(payload.data(), payload.size());
+        ASSERT_LE(static_cast<int>(state), static_cast<int>(AdvertisedState::CAT));
+    }
+}
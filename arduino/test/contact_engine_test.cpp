@@ -0,0 +1,207 @@
+// C++ Standard Library
+#include <random>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Superspreader
+#include "contact_engine.h"
+
+namespace {
+
+struct Crowd {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<Beacon> beacons;
+};
+
+Crowd make_crowd(std::size_t count, float width, float height) {
+    std::mt19937 gen{7};
+    std::uniform_real_distribution<float> along_x{0.0f, width};
+    std::uniform_real_distribution<float> along_y{0.0f, height};
+    std::discrete_distribution<int> beacon{6, 3, 1};
+
+    Crowd crowd;
+    for (std::size_t i = 0; i < count; ++i) {
+        crowd.x.push_back(along_x(gen));
+        crowd.y.push_back(along_y(gen));
+        crowd.beacons.push_back(static_cast<Beacon>(beacon(gen)));
+    }
+    return crowd;
+}
+
+}  // namespace
+
+TEST(ContactEngineTests, RangeMatchesFirmwareCutoff) {
+    RssiModel const model;
+    EXPECT_NEAR(model.rssi_at(model.range()), RSSI_LOWER_BOUND, 1e-9);
+    EXPECT_TRUE(is_close(static_cast<int>(model.rssi_at(0.99 * model.range()))));
+    EXPECT_FALSE(is_close(static_cast<int>(model.rssi_at(1.5 * model.range()))));
+}
+
+TEST(ContactEngineTests, MatchesBruteForce) {
+    constexpr float kWidth  = 60.0f;
+    constexpr float kHeight = 35.0f;
+    auto const crowd        = make_crowd(3000, kWidth, kHeight);
+    auto const receivers    = crowd.x.size() - 100;  // the rest are beacons only
+
+    for (std::size_t threads : {1, 3}) {
+        thread_pool pool{threads};
+        ContactEngine engine{kWidth, kHeight, RssiModel{}, pool};
+        engine.build(crowd.x.data(), crowd.y.data(), crowd.beacons.data(), crowd.x.size());
+
+        std::vector<health_t> human(receivers);
+        std::vector<health_t> cat(receivers);
+        engine.count_exposures(
+            crowd.x.data(), crowd.y.data(), receivers, nullptr, human.data(), cat.data());
+
+        auto const range_squared = engine.range() * engine.range();
+        for (std::size_t i = 0; i < receivers; ++i) {
+            health_t expected_human = 0;
+            health_t expected_cat   = 0;
+            for (std::size_t j = 0; j < crowd.x.size(); ++j) {
+                auto const dx = crowd.x[j] - crowd.x[i];
+                auto const dy = crowd.y[j] - crowd.y[i];
+                if (i == j || dx * dx + dy * dy > range_squared) {
+                    continue;
+                }
+                expected_human += crowd.beacons[j] == Beacon::INFECTED_HUMAN;
+                expected_cat += crowd.beacons[j] == Beacon::CAT;
+            }
+            ASSERT_EQ(human[i], expected_human) << "player " << i << ", threads " << threads;
+            ASSERT_EQ(cat[i], expected_cat) << "player " << i << ", threads " << threads;
+        }
+    }
+}
+
+TEST(ContactEngineTests, DoesNotCountItself) {
+    thread_pool pool{1};
+    ContactEngine engine{10.0f, 10.0f, RssiModel{}, pool};
+
+    std::vector<float> const x{5.0f};
+    std::vector<float> const y{5.0f};
+    std::vector<Beacon> const beacons{Beacon::INFECTED_HUMAN};
+    engine.build(x.data(), y.data(), beacons.data(), 1);
+
+    health_t human = 1;
+    health_t cat   = 1;
+    engine.count_exposures(x.data(), y.data(), 1, nullptr, &human, &cat);
+    EXPECT_EQ(human, 0);
+    EXPECT_EQ(cat, 0);
+}
+
+TEST(ContactEngineTests, SkipsPlayersThatAreNotListening) {
+    thread_pool pool{1};
+    ContactEngine engine{10.0f, 10.0f, RssiModel{}, pool};
+
+    std::vector<float> const x{1.0f, 2.0f, 3.0f};
+    std::vector<float> const y{1.0f, 1.0f, 1.0f};
+    std::vector<Beacon> const beacons{Beacon::NONE, Beacon::NONE, Beacon::CAT};
+    std::vector<std::uint8_t> const listening{1, 0};
+    engine.build(x.data(), y.data(), beacons.data(), x.size());
+
+    std::vector<health_t> human(2, 7);
+    std::vector<health_t> cat(2, 7);
+    engine.count_exposures(x.data(), y.data(), 2, listening.data(), human.data(), cat.data());
+    EXPECT_EQ(cat[0], 1);
+    EXPECT_EQ(cat[1], 0);
+    EXPECT_EQ(human[1], 0);
+}
+
+TEST(ContactEngineTests, DevicesOnTheWallsAreBucketed) {
+    thread_pool pool{1};
+    ContactEngine engine{50.0f, 50.0f, RssiModel{}, pool};
+
+    std::vector<float> const x{50.0f, 49.0f, 0.0f};
+    std::vector<float> const y{50.0f, 49.0f, 0.0f};
+    std::vector<Beacon> const beacons{Beacon::INFECTED_HUMAN, Beacon::INFECTED_HUMAN, Beacon::CAT};
+    engine.build(x.data(), y.data(), beacons.data(), x.size());
+
+    std::vector<health_t> human(3);
+    std::vector<health_t> cat(3);
+    engine.count_exposures(x.data(), y.data(), 3, nullptr, human.data(), cat.data());
+    EXPECT_EQ(human[0], 1);
+    EXPECT_EQ(human[1], 1);
+    EXPECT_EQ(human[2], 0);
+    EXPECT_EQ(cat[0], 0);
+}
+
+TEST(ContactEngineTests, IncrementalMatchesFullCount) {
+    constexpr float kWidth  = 60.0f;
+    constexpr float kHeight = 35.0f;
+    auto crowd              = make_crowd(3000, kWidth, kHeight);
+    auto const receivers    = crowd.x.size() - 100;
+
+    for (std::size_t threads : {1, 3}) {
+        thread_pool pool{threads};
+        IncrementalContactEngine incremental{kWidth, kHeight, RssiModel{}, pool};
+        ContactEngine full{kWidth, kHeight, RssiModel{}, pool};
+
+        std::mt19937 gen{11};
+        std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+        std::vector<std::uint8_t> listening(receivers, 1);
+        std::vector<health_t> human(receivers);
+        std::vector<health_t> cat(receivers);
+        for (int tick = 0; tick < 30; ++tick) {
+            // Mostly a few changes, every fifth tick so many that everyone is recounted
+            auto const share = tick % 5 == 4 ? 0.5f : 0.01f;
+            for (std::size_t i = 0; i < crowd.x.size(); ++i) {
+                if (unit(gen) < share) {
+                    crowd.x[i] = unit(gen) * kWidth;
+                    crowd.y[i] = unit(gen) * kHeight;
+                }
+                if (unit(gen) < share && i < receivers) {
+                    crowd.beacons[i] = crowd.beacons[i] == Beacon::NONE ? Beacon::INFECTED_HUMAN
+                                                                        : Beacon::NONE;
+                }
+                if (unit(gen) < share && i < receivers) {
+                    listening[i] = !listening[i];
+                }
+            }
+
+            incremental.update(crowd.x.data(),
+                               crowd.y.data(),
+                               crowd.beacons.data(),
+                               crowd.x.size(),
+                               receivers,
+                               listening.data());
+            EXPECT_EQ(incremental.recounted(), tick == 0 || share > 0.1f);
+
+            full.build(crowd.x.data(), crowd.y.data(), crowd.beacons.data(), crowd.x.size());
+            full.count_exposures(crowd.x.data(),
+                                 crowd.y.data(),
+                                 receivers,
+                                 listening.data(),
+                                 human.data(),
+                                 cat.data());
+            for (std::size_t i = 0; i < receivers; ++i) {
+                ASSERT_EQ(incremental.human()[i], human[i])
+                    << "player " << i << ", tick " << tick << ", threads " << threads;
+                ASSERT_EQ(incremental.cat()[i], cat[i])
+                    << "player " << i << ", tick " << tick << ", threads " << threads;
+            }
+        }
+    }
+}
+
+TEST(ContactEngineTests, CountsListedPlayersOnly) {
+    thread_pool pool{2};
+    ContactEngine engine{10.0f, 10.0f, RssiModel{}, pool};
+
+    std::vector<float> const x{1.0f, 2.0f, 3.0f};
+    std::vector<float> const y{1.0f, 1.0f, 1.0f};
+    std::vector<Beacon> const beacons{Beacon::INFECTED_HUMAN, Beacon::CAT, Beacon::CAT};
+    std::vector<std::uint32_t> const ids{5, 6, 7};
+    engine.build(x.data(), y.data(), beacons.data(), x.size(), ids.data());
+
+    // Device ids, not positions in the build, decide who is skipped as itself
+    std::vector<std::uint32_t> const players{0, 1};
+    std::vector<health_t> human(2, 7);
+    std::vector<health_t> cat(2, 7);
+    engine.count_exposures_of(x.data(), y.data(), players.data(), 1, human.data(), cat.data());
+    EXPECT_EQ(human[0], 1);
+    EXPECT_EQ(cat[0], 2);
+    EXPECT_EQ(human[1], 7);
+    EXPECT_EQ(cat[1], 7);
+}
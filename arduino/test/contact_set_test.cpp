@@ -0,0 +1,84 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <random>
+#include <set>
+
+// Superspreader
+#include "contact_set.h"
+
+TEST(ContactSetTests, PacksAddressBytes) {
+    std::uint8_t const bytes[6] = {0x24, 0x0A, 0xC4, 0x12, 0x34, 0x56};
+    EXPECT_EQ(to_ble_address(bytes), 0x240AC4123456u);
+}
+
+TEST(ContactSetTests, AggregatesRepeatedAddresses) {
+    contact_set<16> contacts;
+    EXPECT_TRUE(contacts.empty());
+
+    auto* first = contacts.insert(0xA1, -80);
+    ASSERT_NE(first, nullptr);
+    EXPECT_FALSE(first->counted);
+    first->counted = true;
+
+    auto* again = contacts.insert(0xA1, -60);
+    EXPECT_EQ(again, first);
+    EXPECT_TRUE(again->counted);
+    EXPECT_EQ(again->sightings, 2);
+    EXPECT_EQ(again->strongest_rssi, -60);
+    EXPECT_EQ(again->mean_rssi(), -70);
+
+    contacts.insert(0xA2, -50);
+    EXPECT_EQ(contacts.size(), 2u);
+    EXPECT_EQ(contacts.find(0xA3), nullptr);
+    EXPECT_EQ(contacts.find(0xA2)->strongest_rssi, -50);
+}
+
+TEST(ContactSetTests, SightingsSaturate) {
+    contact_set<4> contacts;
+    for (int i = 0; i < 1000; ++i) {
+        contacts.insert(1, -100);
+    }
+    auto const* contact = contacts.find(1);
+    EXPECT_EQ(contact->sightings, 255);
+    EXPECT_EQ(contact->mean_rssi(), -100);
+}
+
+TEST(ContactSetTests, DropsNewAddressesWhenFull) {
+    contact_set<16> contacts;
+    static_assert(contact_set<16>::capacity() == 12, "three quarters of the slots");
+    for (ble_address_t address = 0; address < 20; ++address) {
+        auto* const contact = contacts.insert(address, -50);
+        EXPECT_EQ(contact == nullptr, address >= 12) << address;
+    }
+    EXPECT_EQ(contacts.size(), 12u);
+    EXPECT_EQ(contacts.dropped(), 8u);
+
+    // Known addresses still aggregate
+    EXPECT_NE(contacts.insert(3, -40), nullptr);
+    EXPECT_EQ(contacts.find(3)->sightings, 2);
+
+    contacts.clear();
+    EXPECT_TRUE(contacts.empty());
+    EXPECT_EQ(contacts.dropped(), 0u);
+    EXPECT_EQ(contacts.find(3), nullptr);
+}
+
+TEST(ContactSetTests, MatchesReferenceSet) {
+    std::mt19937_64 rng{5};
+    contact_set<1024> contacts;
+    std::set<ble_address_t> reference;
+
+    // Real addresses share their upper bytes, so mostly vary in the low bits
+    for (int i = 0; i < 3000; ++i) {
+        auto const address = 0x240AC4000000ULL | (rng() % 700);
+        ASSERT_NE(contacts.insert(address, -60), nullptr);
+        reference.insert(address);
+    }
+    EXPECT_EQ(contacts.size(), reference.size());
+    for (auto const address : reference) {
+        EXPECT_NE(contacts.find(address), nullptr);
+    }
+    EXPECT_EQ(contacts.find(0x240AC4000000ULL | 701), nullptr);
+}
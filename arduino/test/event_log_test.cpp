@@ -0,0 +1,229 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "event_log.h"
+#include "event_log_replay.h"
+#include "virtual_device.h"
+
+namespace {
+
+/** @returns records of @p wakes wakes of one virtual device beside a zombie */
+std::vector<EventLogRecord> play(int wakes) {
+    VirtualAir air{std::vector<float>{0.0f, 1.0f}, std::vector<float>{0.0f, 0.0f}, {}};
+    VirtualHal device{0, air, 1};
+    VirtualHal zombie{1, air, 1};
+    zombie.set_health(to_health(StateBounds::ZOMBIE));
+    for (int wake = 0; wake < wakes; ++wake) {
+        zombie.wake(false);
+        device.wake(wake % 5 == 0);
+        air.publish();
+    }
+    return device.event_history();
+}
+
+}  // namespace
+
+TEST(EventLogTests, EventsRoundTripAndSaturate) {
+    auto const exposure = unpack_event(pack_event(Event{ExposureEvent{3, 9}}));
+    ASSERT_EQ(exposure.type, Event::Type::EXPOSURE);
+    EXPECT_EQ(exposure.data.exposure.human, 3u);
+    EXPECT_EQ(exposure.data.exposure.cat, 9u);
+
+    auto const crowd = unpack_event(pack_event(Event{ExposureEvent{500, 200}}));
+    EXPECT_EQ(crowd.data.exposure.human, 127u);
+    EXPECT_EQ(crowd.data.exposure.cat, 127u);
+
+    EXPECT_EQ(unpack_event(pack_event(Event{TreatmentEvent{}})).type, Event::Type::TREATMENT);
+    EXPECT_FALSE(unpack_event(pack_event(Event{})).is_valid());
+}
+
+TEST(EventLogTests, LinesRoundTrip) {
+    auto record = begin_event_log_record(PlayerState{});
+    log_event(record, Event{TreatmentEvent{}});
+    log_event(record, Event{ExposureEvent{2, 1}});
+    record.tick       = 0x01020304;
+    record.end_health = 57;
+
+    char line[kEventLogLineSize];
+    ASSERT_GT(format_event_log_record(record, line, sizeof(line)), 0u);
+
+    // Serial output may precede the record on the same line
+    EventLogRecord parsed{};
+    ASSERT_TRUE(parse_event_log_record((std::string{"noise "} + line + "\r\n").c_str(), parsed));
+    EXPECT_EQ(std::memcmp(&parsed, &record, sizeof(record)), 0);
+
+    EXPECT_FALSE(parse_event_log_record("event_log,1,00ff", parsed));
+    EXPECT_FALSE(parse_event_log_record("event_log,2,00000000000000000000000000000000", parsed));
+    EXPECT_FALSE(parse_event_log_record("wake_profile,1,3", parsed));
+}
+
+TEST(EventLogTests, WakeCycleLogsEveryWake) {
+    auto const wakes   = static_cast<int>(2 * kEventLogSize + 5);
+    auto const records = play(wakes);
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(wakes));
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].tick, i + 1);
+        EXPECT_TRUE(verify_event_log_record(records[i])) << "wake " << i;
+        if (i > 0) {
+            EXPECT_EQ(records[i].start_health, records[i - 1].end_health);
+        }
+    }
+    // Treatment wakes log the treatment before the scan's exposure
+    EXPECT_EQ(unpack_event(records[0].events[0]).type, Event::Type::TREATMENT);
+    EXPECT_EQ(unpack_event(records[0].events[1]).type, Event::Type::EXPOSURE);
+    EXPECT_EQ(records[1].event_count, 1u);
+}
+
+TEST(EventLogTests, FullLogIsFlushed) {
+    VirtualAir air{std::vector<float>{0.0f}, std::vector<float>{0.0f}, {}};
+    VirtualHal device{0, air, 1};
+    for (std::size_t wake = 1; wake <= kEventLogSize + 3; ++wake) {
+        device.wake(false);
+        EXPECT_EQ(device.event_log().size(), wake % kEventLogSize);
+    }
+}
+
+TEST(EventLogTests, TruncatedRecordsAreNotVerified) {
+    auto record = begin_event_log_record(PlayerState{});
+    for (std::size_t i = 0; i <= kLoggedEventsPerWake; ++i) {
+        log_event(record, Event{ExposureEvent{}});
+    }
+    EXPECT_EQ(record.event_count, kLoggedEventsPerWake);
+    EXPECT_NE(record.flags & kEventLogTruncated, 0);
+    EXPECT_FALSE(verify_event_log_record(record));
+}
+
+TEST(EventLogTests, VerifyFindsTamperedRecords) {
+    auto records = play(50);
+    auto const path = testing::TempDir() + "event_log_test.sslog";
+    ASSERT_TRUE(write_event_log_file(path, 7, records.data(), records.size()));
+
+    MappedEventLog file;
+    std::string error;
+    ASSERT_TRUE(file.open(path, error)) << error;
+    auto const view = file.view();
+    EXPECT_EQ(view.device, 7u);
+    ASSERT_EQ(view.size, records.size());
+
+    thread_pool pool{3};
+    auto const clean = verify_event_logs({view, view}, pool);
+    EXPECT_EQ(clean.records, 2 * records.size());
+    EXPECT_EQ(clean.verified, 2 * records.size());
+    EXPECT_EQ(clean.mismatched, 0u);
+    EXPECT_EQ(clean.gaps, 0u);
+
+    records[20].end_health = records[20].end_health == 99 ? 50 : 99;
+    auto const tampered =
+        verify_event_logs({EventLogView{0, records.data(), records.size()}}, pool);
+    EXPECT_EQ(tampered.mismatched, 1u);
+    EXPECT_EQ(tampered.gaps, 1u);
+}
+
+TEST(EventLogTests, RejectsFilesThatAreNotLogs) {
+    MappedEventLog file;
+    std::string error;
+    EXPECT_FALSE(file.open(testing::TempDir() + "missing.sslog", error));
+    EXPECT_FALSE(error.empty());
+
+    auto const path = testing::TempDir() + "not_a_log.sslog";
+    auto* out       = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    std::fputs("event_log,1,00000000000000000000000000000000\n", out);
+    std::fclose(out);
+    EXPECT_FALSE(file.open(path, error));
+    EXPECT_EQ(file.view().size, 0u);
+}
+
+TEST(EventLogTests, ReplayFollowsLoggedGame) {
+    auto const records = play(60);
+    EventLogView const log{0, records.data(), records.size()};
+
+    auto const same = replay_game<HealthState>(log, PlayerEngine<DefaultRules>{});
+    EXPECT_EQ(same.replayed_health, same.logged_health);
+    EXPECT_EQ(same.replayed_zombie_tick, same.logged_zombie_tick);
+
+    // Skipped wakes are replayed as idle ticks, the same as wakes with no exposure
+    std::vector<EventLogRecord> quiet;
+    auto player          = new_player_state();
+    player.health.health = 40;
+    for (int tick = 0; tick < 30; ++tick) {
+        auto record = begin_event_log_record(player);
+        log_event(record, Event{ExposureEvent{}});
+        player.health = exposure_update(player.health, ExposureEvent{});
+        ++player.tick;
+        end_event_log_record(record, player);
+        if (tick % 7 == 0) {
+            quiet.push_back(record);
+        }
+    }
+    auto const idle = replay_game<HealthState>(EventLogView{0, quiet.data(), quiet.size()},
+                                               PlayerEngine<DefaultRules>{});
+    EXPECT_EQ(idle.replayed_health, idle.logged_health);
+
+    // Cats infect at half the rate under cat resistance, so the player turns later
+    std::vector<EventLogRecord> cats;
+    player = new_player_state();
+    for (int tick = 0; tick < 200; ++tick) {
+        auto record = begin_event_log_record(player);
+        log_event(record, Event{ExposureEvent{0, 1}});
+        player.health = exposure_update(player.health, ExposureEvent{0, 1});
+        ++player.tick;
+        end_event_log_record(record, player);
+        cats.push_back(record);
+    }
+    EventLogView const cat_log{0, cats.data(), cats.size()};
+    auto const logged    = replay_game<HealthState>(cat_log, PlayerEngine<DefaultRules>{});
+    auto const resistant =
+        replay_game<ResistantHealthState>(cat_log, PlayerEngine<CatResistantRules>{});
+    EXPECT_EQ(logged.replayed_health, logged.logged_health);
+    EXPECT_NE(logged.logged_zombie_tick, 0u);
+    EXPECT_GT(resistant.replayed_zombie_tick, logged.logged_zombie_tick);
+}
+
+TEST(EventLogTests, ReplayRestartsWithTheLog) {
+    // A game that turns zombie, then the device loses its state and starts again at tick 1
+    std::vector<EventLogRecord> records;
+    auto player = new_player_state();
+    for (int tick = 0; tick < 200; ++tick) {
+        auto record = begin_event_log_record(player);
+        log_event(record, Event{ExposureEvent{0, 1}});
+        player.health = exposure_update(player.health, ExposureEvent{0, 1});
+        ++player.tick;
+        end_event_log_record(record, player);
+        records.push_back(record);
+    }
+    ASSERT_GE(player.health.health, to_health(StateBounds::ZOMBIE));
+
+    auto const play_quietly = [&records](PlayerState& player, int ticks) {
+        for (int tick = 0; tick < ticks; ++tick) {
+            auto record = begin_event_log_record(player);
+            log_event(record, Event{ExposureEvent{}});
+            player.health = exposure_update(player.health, ExposureEvent{});
+            ++player.tick;
+            end_event_log_record(record, player);
+            records.push_back(record);
+        }
+    };
+    player = new_player_state();
+    play_quietly(player, 20);
+
+    EventLogView const log{0, records.data(), records.size()};
+    auto const reset = replay_game<HealthState>(log, PlayerEngine<DefaultRules>{});
+    EXPECT_EQ(reset.replayed_health, reset.logged_health);
+    EXPECT_LT(reset.replayed_health, to_health(StateBounds::ZOMBIE));
+    EXPECT_EQ(reset.replayed_zombie_tick, 0u);
+    EXPECT_EQ(reset.logged_zombie_tick, 0u);
+
+    // The tick carries on, but the health does not follow from the previous wake
+    player.health.health = 40;
+    play_quietly(player, 10);
+    EventLogView const broken{0, records.data(), records.size()};
+    auto const restarted = replay_game<HealthState>(broken, PlayerEngine<DefaultRules>{});
+    EXPECT_EQ(restarted.replayed_health, restarted.logged_health);
+}
@@ -0,0 +1,86 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <vector>
+
+// Superspreader
+#include "event_simulator.h"
+
+namespace {
+
+std::vector<health_t> all_health(EventSimulator const& simulator, std::size_t devices) {
+    std::vector<health_t> health(devices);
+    for (std::size_t id = 0; id < devices; ++id) {
+        health[id] = simulator.health(id);
+    }
+    return health;
+}
+
+}  // namespace
+
+TEST(EventSimulatorTests, ResultsIndependentOfThreadCount) {
+    EventSimConfig config;
+    config.devices             = 2000;
+    config.cats                = 20;
+    config.initial_zombie      = 50;
+    config.treatments_per_hour = 60.0;
+    config.venue_width         = 80.0f;
+    config.venue_height        = 80.0f;
+
+    thread_pool single{1};
+    thread_pool many{3};
+    EventSimulator reference{config, single};
+    EventSimulator parallel{config, many};
+    reference.run_until(120 * 1000);
+    parallel.run_until(120 * 1000);
+
+    EXPECT_EQ(reference.events(), parallel.events());
+    EXPECT_EQ(reference.game_updates(), parallel.game_updates());
+    EXPECT_EQ(all_health(reference, config.devices), all_health(parallel, config.devices));
+}
+
+TEST(EventSimulatorTests, DevicesWakeOnTheirOwnTimers) {
+    EventSimConfig config;
+    config.devices             = 500;
+    config.initial_zombie      = 0;
+    config.treatments_per_hour = 0.0;
+
+    thread_pool pool{2};
+    EventSimulator simulator{config, pool};
+    simulator.run_until(10 * 60 * 1000);
+    EXPECT_EQ(simulator.now_ms(), 10u * 60 * 1000);
+
+    // A cycle lasts setup + scan + 1 to 4 s of sleep
+    auto const per_device =
+        static_cast<double>(simulator.game_updates()) / static_cast<double>(config.devices);
+    EXPECT_GT(per_device, 600.0 / (0.25 + SCAN_SECONDS + TIME_TO_SLEEP - 1));
+    EXPECT_LT(per_device, 600.0 / (0.25 + SCAN_SECONDS + 1) + 1);
+
+    // Four events per cycle and no treatment presses
+    EXPECT_GE(simulator.events(), 4 * simulator.game_updates());
+    EXPECT_LT(simulator.events(), 4 * simulator.game_updates() + 4 * config.devices);
+
+    // Without zombies or treatment every device follows the idle rules
+    auto counts = simulator.class_counts();
+    EXPECT_EQ(counts[static_cast<std::size_t>(HealthClass::ZOMBIE)], 0u);
+}
+
+TEST(EventSimulatorTests, InfectionSpreadsThroughScans) {
+    EventSimConfig config;
+    config.devices             = 1000;
+    config.initial_zombie      = 20;
+    config.treatments_per_hour = 0.0;
+    config.venue_width         = 30.0f;
+    config.venue_height        = 30.0f;
+
+    thread_pool pool{2};
+    EventSimulator simulator{config, pool};
+    auto const before = simulator.class_counts();
+    simulator.run_until(5 * 60 * 1000);
+    auto const after = simulator.class_counts();
+
+    auto const zombie = static_cast<std::size_t>(HealthClass::ZOMBIE);
+    EXPECT_EQ(before[zombie], config.initial_zombie);
+    EXPECT_GT(after[zombie], 10 * config.initial_zombie);
+}
@@ -0,0 +1,213 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "exposure_scan.h"
+#include "scan_trace.h"
+#include "virtual_device.h"
+
+namespace {
+
+/** @returns trace read from @p path, relative to the source directory */
+ScanTrace load_trace(char const* path) {
+    ScanTrace trace;
+    std::ifstream in{path};
+    std::string line;
+    while (std::getline(in, line)) {
+        EXPECT_TRUE(trace.add_line(line.c_str())) << line;
+    }
+    return trace;
+}
+
+/** @brief Appends a monitor at @p address advertising @p state in binary form */
+void add_monitor(ScanTrace& trace, ble_address_t address, int rssi, AdvertisedState state) {
+    std::uint8_t payload[5 + kManufacturerDataSize] = {
+        0x02, 0x01, 0x06, kManufacturerDataSize + 1, 0xFF};
+    encode_manufacturer_data(state, 0, payload + 5);
+    trace.add(address, rssi, payload, sizeof(payload));
+}
+
+/**
+ * @returns exposure from every device in @p trace that was ever close, counted
+ *          once per address after the whole trace was collected
+ */
+ExposureEvent count_all(ScanTrace& trace) {
+    std::map<ble_address_t, AdvertisedState> close;
+    auto const collect = [&close](ble_address_t address,
+                                  int rssi,
+                                  std::uint8_t const* payload,
+                                  std::size_t length) {
+        if (is_close(rssi)) {
+            close[address] = classify_advertisement(payload, length);
+        }
+        return true;
+    };
+    trace.scan(SCAN_SECONDS, collect);
+
+    ExposureEvent exposure;
+    for (auto const& device : close) {
+        exposure.human += is_infected_human(device.second) ? 1 : 0;
+        exposure.cat += is_cat(device.second) ? 1 : 0;
+    }
+    return exposure;
+}
+
+}  // namespace
+
+TEST(ExposureScanTests, TraceLinesParse) {
+    ScanTrace trace;
+    EXPECT_TRUE(trace.add_line(""));
+    EXPECT_TRUE(trace.add_line("  # comment"));
+    EXPECT_TRUE(trace.add_line("24:0a:c4:12:34:56 -61 02010606ffffff5a1428\n"));
+    EXPECT_FALSE(trace.add_line("24:0a:c4:12:34:56 -61 02010"));
+    EXPECT_FALSE(trace.add_line("24:0a:c4:12:34:56 -61 0201zz"));
+    EXPECT_FALSE(trace.add_line("24:0a:c4:12:34:56 strong 020106"));
+    EXPECT_FALSE(trace.add_line("24:0a:c4:12:34 -61 020106"));
+    EXPECT_FALSE(trace.add_line("-61 02010606ffffff5a1428"));
+    ASSERT_EQ(trace.size(), 1u);
+
+    auto const check = [](ble_address_t address,
+                          int rssi,
+                          std::uint8_t const* payload,
+                          std::size_t length) {
+        EXPECT_EQ(address, 0x240AC4123456u);
+        EXPECT_EQ(rssi, -61);
+        EXPECT_EQ(length, 10u);
+        EXPECT_EQ(classify_advertisement(payload, length), AdvertisedState::ASYMPTOMATIC);
+        return true;
+    };
+    trace.scan(SCAN_SECONDS, check);
+}
+
+TEST(ExposureScanTests, RecordedTraceCountsCloseInfectedMonitors) {
+    auto trace = load_trace("test/data/crowded_scan.trace");
+    ASSERT_GT(trace.size(), 0u);
+
+    // A healthy player far from zombie reads the whole trace
+    auto const exposure = scan_exposure(trace, SCAN_SECONDS, HealthState{12});
+    auto const expected = count_all(trace);
+    EXPECT_EQ(exposure.human, expected.human);
+    EXPECT_EQ(exposure.cat, expected.cat);
+    EXPECT_GT(exposure.human + exposure.cat, 0u);
+}
+
+TEST(ExposureScanTests, UnsusceptiblePlayersDoNotScan) {
+    auto trace = load_trace("test/data/crowded_scan.trace");
+    for (health_t health : {0u, 1u, 40u, 75u, 95u, 99u}) {
+        auto const exposure = scan_exposure(trace, SCAN_SECONDS, HealthState{health});
+        EXPECT_EQ(exposure.human + exposure.cat, 0u) << health;
+        EXPECT_EQ(trace.delivered(), 0u) << health;
+    }
+}
+
+TEST(ExposureScanTests, StopsOnceZombieIsCertain) {
+    ScanTrace trace;
+    for (ble_address_t address = 0; address < 10; ++address) {
+        add_monitor(trace, address, -50, AdvertisedState::CAT);
+    }
+
+    // Health 38 progresses to 37, so the 4th cat (16 each) makes a zombie
+    HealthState const health{38};
+    auto const exposure = scan_exposure(trace, SCAN_SECONDS, health);
+    EXPECT_EQ(trace.delivered(), 4u);
+    EXPECT_EQ(exposure_update(health, exposure).health, to_health(StateBounds::ZOMBIE));
+    EXPECT_EQ(exposure_update(health, count_all(trace)).health, to_health(StateBounds::ZOMBIE));
+}
+
+TEST(ExposureScanTests, StopsAtAdvertisementCap) {
+    auto trace          = load_trace("test/data/crowded_scan.trace");
+    auto const exposure = scan_exposure(trace, SCAN_SECONDS, HealthState{2}, 5);
+    EXPECT_EQ(trace.delivered(), 5u);
+    EXPECT_LE(exposure.human + exposure.cat, 5u);
+}
+
+TEST(ExposureScanTests, EarlyStopNeverChangesTheOutcome) {
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<int> rssi{-90, -40};
+    std::uniform_int_distribution<int> state{0, static_cast<int>(AdvertisedState::CAT)};
+    std::uniform_int_distribution<int> sightings{0, 60};
+    std::uniform_int_distribution<ble_address_t> address{0, 20};
+
+    for (int run = 0; run < 500; ++run) {
+        // Devices are heard repeatedly, each always advertising the same state
+        std::map<ble_address_t, AdvertisedState> states;
+        ScanTrace trace;
+        for (int i = sightings(rng); i > 0; --i) {
+            auto const device = address(rng);
+            if (states.count(device) == 0) {
+                states[device] = static_cast<AdvertisedState>(state(rng));
+            }
+            add_monitor(trace, device, rssi(rng), states[device]);
+        }
+        for (health_t health = 0; health < kNumHealthValues; ++health) {
+            auto const streamed = scan_exposure(trace, SCAN_SECONDS, HealthState{health});
+            ASSERT_EQ(exposure_update(HealthState{health}, streamed).health,
+                      exposure_update(HealthState{health}, count_all(trace)).health)
+                << "run " << run << " health " << health;
+        }
+    }
+}
+
+TEST(ExposureScanTests, RepeatedDevicesCountOnce) {
+    ScanTrace trace;
+    // Heard out of range first, then close three times
+    add_monitor(trace, 7, -90, AdvertisedState::SICK);
+    add_monitor(trace, 7, -60, AdvertisedState::SICK);
+    add_monitor(trace, 7, -55, AdvertisedState::SICK);
+    add_monitor(trace, 7, -58, AdvertisedState::SICK);
+    add_monitor(trace, 8, -70, AdvertisedState::CAT);
+    add_monitor(trace, 8, -70, AdvertisedState::CAT);
+
+    ExposureScan scan{HealthState{12}};
+    auto const add = [&scan](ble_address_t address,
+                             int rssi,
+                             std::uint8_t const* payload,
+                             std::size_t length) {
+        return scan.add(address, rssi, payload, length);
+    };
+    trace.scan(SCAN_SECONDS, add);
+    EXPECT_EQ(scan.exposure().human, 1u);
+    EXPECT_EQ(scan.exposure().cat, 1u);
+    ASSERT_EQ(scan.contacts().size(), 2u);
+    auto const* sick = scan.contacts().find(7);
+    ASSERT_NE(sick, nullptr);
+    EXPECT_EQ(sick->sightings, 4);
+    EXPECT_EQ(sick->strongest_rssi, -55);
+    EXPECT_EQ(sick->mean_rssi(), -65);
+}
+
+TEST(ExposureScanTests, RecordedBeaconCountsOnce) {
+    auto trace          = load_trace("test/data/crowded_scan.trace");
+    auto const exposure = scan_exposure(trace, SCAN_SECONDS, HealthState{12});
+
+    // The trace has more close sightings than distinct close devices
+    std::size_t close_sightings = 0;
+    auto const count = [&close_sightings](ble_address_t,
+                                          int rssi,
+                                          std::uint8_t const* payload,
+                                          std::size_t length) {
+        auto const state = classify_advertisement(payload, length);
+        if (is_close(rssi) && (is_infected_human(state) || is_cat(state))) {
+            ++close_sightings;
+        }
+        return true;
+    };
+    trace.scan(SCAN_SECONDS, count);
+    EXPECT_LT(exposure.human + exposure.cat, close_sightings);
+}
+
+TEST(ExposureScanTests, ImmuneDeviceSkipsScanInWakeCycle) {
+    VirtualAir air{std::vector<float>{0.0f}, std::vector<float>{0.0f}, {}};
+    VirtualHal device{0, air, 1};
+    device.set_health(to_health(StateBounds::IMMUNE));
+
+    device.wake(false);
+    EXPECT_EQ(device.awake_us(), 0u);
+}
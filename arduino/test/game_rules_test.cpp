@@ -0,0 +1,134 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <vector>
+
+// Superspreader
+#include "game_rules.h"
+
+namespace {
+
+// The default engine runs entirely at compile time
+static_assert(PlayerEngine<DefaultRules>{}.exposure_update(HealthState{12}, ExposureEvent{1, 0})
+                      .health == 14,
+              "healthy players decay by one, then take a human exposure");
+static_assert(PlayerEngine<DefaultRules>{}.treatment_update(HealthState{95}).health ==
+                  to_health(StateBounds::IMMUNE),
+              "late infections are cured");
+
+// Cat resistant rules only compile with a state that keeps resistance
+static_assert(has_static_cat_resistance<CatResistantRules>::value &&
+                  !has_static_cat_resistance<DefaultRules>::value &&
+                  !has_static_cat_resistance<RuntimeRules>::value,
+              "only compile-time cat resistance is checked at compile time");
+static_assert(tracks_cat_resistance<ResistantHealthState>::value &&
+                  !tracks_cat_resistance<HealthState>::value,
+              "only the resistant state keeps resistance");
+
+/** @returns exposures covering none, humans only, cats only and both */
+std::vector<ExposureEvent> exposure_grid() {
+    std::vector<ExposureEvent> exposures;
+    for (health_t human = 0; human < 4; ++human) {
+        for (health_t cat = 0; cat < 3; ++cat) {
+            exposures.push_back(ExposureEvent{human, cat});
+        }
+    }
+    return exposures;
+}
+
+}  // namespace
+
+TEST(GameRulesTests, RuntimeDefaultRulesMatchShippingRules) {
+    PlayerEngine<RuntimeRules> const engine{RuntimeRules{kDefaultRuleSet}};
+    for (health_t health = 0; health < kNumHealthValues + 10; ++health) {
+        HealthState const state{health};
+        for (auto const exposure : exposure_grid()) {
+            EXPECT_EQ(engine.exposure_update(state, exposure).health,
+                      exposure_update(state, exposure).health)
+                << "health=" << health << " human=" << exposure.human << " cat=" << exposure.cat;
+        }
+        EXPECT_EQ(engine.treatment_update(state).health, treament_update(state).health)
+            << "health=" << health;
+        EXPECT_EQ(engine.idle_update(state, 25).health, idle_update(state, 25).health)
+            << "health=" << health;
+    }
+}
+
+TEST(GameRulesTests, CatResistanceAfterInfection) {
+    PlayerEngine<CatResistantRules> const engine;
+    ExposureEvent const cat{0, 1};
+    ExposureEvent const human{1, 0};
+
+    // Cats infect at the variant's rate until the player has been infected
+    ResistantHealthState state{30};
+    state = engine.exposure_update(state, cat);
+    EXPECT_EQ(state.health, 30u - 1u + kCatResistantRuleSet.cat_rate);
+    EXPECT_FALSE(state.cat_resistant);
+
+    state = engine.exposure_update(state, ExposureEvent{0, 2});
+    ASSERT_TRUE(engine.is_infected(state.health));
+    EXPECT_FALSE(state.cat_resistant);
+
+    // Resistance is gained on the first tick spent infected
+    state = engine.exposure_update(state, ExposureEvent{});
+    EXPECT_TRUE(state.cat_resistant);
+
+    // Treated back to healthy, only humans still infect
+    state = engine.treatment_update(engine.treatment_update(state));
+    ASSERT_TRUE(engine.is_healthy(state.health) || engine.is_super_healthy(state.health));
+    auto const idle    = engine.exposure_update(state, ExposureEvent{}).health;
+    EXPECT_EQ(engine.exposure_update(state, cat).health, idle);
+    EXPECT_EQ(engine.exposure_update(state, human).health, idle + kCatResistantRuleSet.human_rate);
+    EXPECT_TRUE(engine.exposure_update(state, cat).cat_resistant);
+}
+
+TEST(GameRulesTests, IdleUpdateMatchesLoopForRuleVariants) {
+    RuleSet slow_cats  = kDefaultRuleSet;
+    slow_cats.cat_rate = 4;
+    RuleSet fast_rates = kDefaultRuleSet;
+    fast_rates.super_healthy_rate = 3;
+    fast_rates.healthy_rate       = 2;
+    fast_rates.infected_rate      = 3;
+    RuleSet frozen                = kDefaultRuleSet;
+    frozen.super_healthy_rate     = 0;
+    frozen.healthy_rate           = 0;
+    frozen.infected_rate          = 0;
+
+    for (auto const& rules :
+         {kDefaultRuleSet, kCatResistantRuleSet, slow_cats, fast_rates, frozen}) {
+        PlayerEngine<RuntimeRules> const engine{RuntimeRules{rules}};
+        for (health_t health = 0; health < kNumHealthValues + 10; ++health) {
+            ResistantHealthState looped{health};
+            for (unsigned long ticks = 0; ticks <= 2 * kNumHealthValues; ++ticks) {
+                auto const advanced = engine.idle_update(ResistantHealthState{health}, ticks);
+                ASSERT_EQ(advanced.health, looped.health)
+                    << "health=" << health << " ticks=" << ticks;
+                ASSERT_EQ(advanced.cat_resistant, looped.cat_resistant)
+                    << "health=" << health << " ticks=" << ticks;
+                looped = engine.exposure_update(looped, ExposureEvent{});
+            }
+        }
+    }
+}
+
+TEST(GameRulesTests, RuntimeRulesSweepInfectionRate) {
+    // Faster human infection reaches zombie sooner; at 1 per tick healthy decay keeps up
+    int previous = 0;
+    for (health_t rate = 2; rate <= 6; ++rate) {
+        RuleSet rules    = kDefaultRuleSet;
+        rules.human_rate = rate;
+        PlayerEngine<RuntimeRules> const engine{RuntimeRules{rules}};
+
+        HealthState state;
+        int ticks = 0;
+        while (!engine.is_zombie(state.health)) {
+            state = engine.exposure_update(state, ExposureEvent{1, 0});
+            ++ticks;
+        }
+        if (previous != 0) {
+            EXPECT_LE(ticks, previous) << "rate=" << rate;
+        }
+        previous = ticks;
+    }
+}
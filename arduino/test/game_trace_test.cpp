@@ -0,0 +1,151 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "game_trace.h"
+#include "game_trace_histogram.h"
+#include "health_monitor_core.h"
+#include "virtual_device.h"
+
+namespace {
+
+/** @brief Runs the polling @c game_update on @p events, tracing into @p trace */
+template <typename TraceSinkT>
+PlayerState play(PlayerState player, std::vector<Event> const& events, TraceSinkT& trace) {
+    std::size_t next = 0;
+    game_update(
+        player,
+        [&events, &next]() { return next < events.size() ? events[next++] : Event{}; },
+        [](ExposureEvent const&) {},
+        [](TreatmentEvent const&) {},
+        trace);
+    return player;
+}
+
+}  // namespace
+
+TEST(GameTraceTests, TracesEveryPolledEvent) {
+    PlayerState player;
+    player.tick          = 6;
+    player.health.health = 50;
+    std::vector<Event> const events{Event{TreatmentEvent{}},
+                                    Event{ExposureEvent{2, 0}},
+                                    Event{TreatmentEvent{}}};
+
+    GameTraceBuffer<8> trace{};
+    auto const traced = play(player, events, trace);
+    NullTraceSink null;
+    auto const untraced = play(player, events, null);
+    EXPECT_EQ(traced.health.health, untraced.health.health);
+    EXPECT_EQ(traced.tick, untraced.tick);
+
+    ASSERT_EQ(trace.size(), 4u);
+    auto const* records = trace.begin();
+    EXPECT_EQ(records[0].type, GameTraceType::TREATMENT);
+    EXPECT_EQ(records[1].type, GameTraceType::EXPOSURE);
+    EXPECT_EQ(records[2].type, GameTraceType::TREATMENT_LATCHED);
+    EXPECT_EQ(records[3].type, GameTraceType::TICK);
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(records[i].tick, 7u);
+        EXPECT_EQ(records[i].events, i);
+        if (i > 0) {
+            EXPECT_EQ(records[i].health_before, records[i - 1].health_after);
+        }
+    }
+    EXPECT_EQ(records[0].health_before, 50);
+    EXPECT_EQ(records[2].health_before, records[2].health_after);
+    EXPECT_EQ(records[3].health_before, 50);
+    EXPECT_EQ(records[3].health_after, traced.health.health);
+    EXPECT_EQ(records[3].events, 3);
+}
+
+TEST(GameTraceTests, FullBufferCountsDropped) {
+    GameTraceBuffer<2> trace{};
+    std::vector<Event> const events(4, Event{ExposureEvent{}});
+    play(PlayerState{}, events, trace);
+    EXPECT_EQ(trace.size(), 2u);
+    EXPECT_EQ(trace.dropped(), 3u);
+    trace.clear();
+    EXPECT_EQ(trace.size(), 0u);
+    EXPECT_EQ(trace.dropped(), 0u);
+}
+
+TEST(GameTraceTests, DefaultInitializedBufferIsEmpty) {
+    // As the firmware declares it, without braces
+    GameTraceBuffer<2> trace;
+    EXPECT_EQ(trace.size(), 0u);
+    EXPECT_EQ(trace.dropped(), 0u);
+    EXPECT_EQ(trace.begin(), trace.end());
+}
+
+TEST(GameTraceTests, LinesRoundTrip) {
+    GameTraceRecord const record{0xFFFFFFF0, 1234, GameTraceType::TREATMENT_LATCHED, 75, 255, 3};
+    char small[10];
+    EXPECT_EQ(format_game_trace_record(record, small, sizeof(small)), 0u);
+    char line[kGameTraceLineSize];
+    ASSERT_GT(format_game_trace_record(record, line, sizeof(line)), 0u);
+
+    GameTraceRecord parsed{};
+    ASSERT_TRUE(parse_game_trace_record((std::string{"noise "} + line + "\r\n").c_str(), parsed));
+    EXPECT_EQ(std::memcmp(&parsed, &record, sizeof(record)), 0);
+
+    EXPECT_FALSE(parse_game_trace_record("game_trace,1,1,0,2,2,0,5", parsed));
+    EXPECT_FALSE(parse_game_trace_record("game_trace,1,1,9,2,2,0,5", parsed));
+    EXPECT_FALSE(parse_game_trace_record("game_trace,1,1,1,256,2,0,5", parsed));
+    EXPECT_FALSE(parse_game_trace_record("game_trace,2,1,1,2,2,0,5", parsed));
+    EXPECT_FALSE(parse_game_trace_record("game_trace,1,1,1,2", parsed));
+}
+
+TEST(GameTraceTests, HistogramAggregatesRecords) {
+    EXPECT_EQ(GameTraceHistogram::cycle_bucket(0), 0u);
+    EXPECT_EQ(GameTraceHistogram::cycle_bucket(1), 1u);
+    EXPECT_EQ(GameTraceHistogram::cycle_bucket(100), 7u);
+    EXPECT_EQ(GameTraceHistogram::cycle_bucket(0xFFFFFFFF), 32u);
+
+    GameTraceHistogram a;
+    GameTraceHistogram b;
+    for (std::uint32_t cycles = 1; cycles <= 100; ++cycles) {
+        a.record(GameTraceRecord{1, cycles, GameTraceType::EXPOSURE, 10, 11, 0});
+    }
+    b.record(GameTraceRecord{1, 90, GameTraceType::TICK, 10, 11, 2});
+    b.record(GameTraceRecord{2, 90, GameTraceType::TICK, 10, 11, 40});
+    a.merge(b);
+
+    EXPECT_EQ(a.count(GameTraceType::EXPOSURE), 100u);
+    EXPECT_EQ(a.count(GameTraceType::TICK), 2u);
+    EXPECT_EQ(a.total_cycles(GameTraceType::EXPOSURE), 5050u);
+    EXPECT_EQ(a.events_per_tick()[2], 1u);
+    EXPECT_EQ(a.events_per_tick().back(), 1u);
+    EXPECT_EQ(cycle_quantile(a, GameTraceType::EXPOSURE, 0.5), 63u);
+    EXPECT_EQ(cycle_quantile(a, GameTraceType::EXPOSURE, 0.99), 127u);
+    EXPECT_EQ(cycle_quantile(a, GameTraceType::TREATMENT, 0.5), 0u);
+}
+
+TEST(GameTraceTests, FleetTracesEveryWake) {
+    thread_pool pool{2};
+    FleetConfig config;
+    config.devices        = 50;
+    config.treatment_prob = 0.2;
+    config.trace          = true;
+    VirtualFleet fleet{config, pool};
+    for (int round = 0; round < 10; ++round) {
+        fleet.run_round();
+    }
+
+    auto const trace = fleet.game_trace();
+    EXPECT_EQ(trace.count(GameTraceType::TICK), 500u);
+    EXPECT_EQ(trace.count(GameTraceType::EXPOSURE), 500u);
+    EXPECT_GT(trace.count(GameTraceType::TREATMENT), 0u);
+    EXPECT_EQ(trace.events_per_tick()[1] + trace.events_per_tick()[2], 500u);
+    EXPECT_EQ(trace.events_per_tick()[2], trace.count(GameTraceType::TREATMENT));
+
+    config.trace = false;
+    VirtualFleet untraced{config, pool};
+    untraced.run_round();
+    EXPECT_EQ(untraced.game_trace().count(GameTraceType::TICK), 0u);
+}
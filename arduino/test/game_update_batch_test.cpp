@@ -0,0 +1,157 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <random>
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+namespace {
+
+/** @brief Player state and callbacks seen by one run of @c game_update */
+struct Outcome {
+    PlayerState player;
+    std::string callbacks;
+};
+
+/** @returns outcome of the polling @c game_update on @p events */
+Outcome poll(PlayerState player, std::vector<Event> const& events) {
+    Outcome outcome;
+    std::size_t next = 0;
+    game_update(
+        player,
+        [&events, &next]() { return next < events.size() ? events[next++] : Event{}; },
+        [&outcome](ExposureEvent const& exposure) {
+            outcome.callbacks += "e" + std::to_string(exposure.human) + "," +
+                                 std::to_string(exposure.cat) + " ";
+        },
+        [&outcome](TreatmentEvent const&) { outcome.callbacks += "t "; });
+    outcome.player = player;
+    return outcome;
+}
+
+/** @returns outcome of the batch @c game_update on @p events */
+Outcome batch(PlayerState player, std::vector<Event> const& events) {
+    Outcome outcome;
+    game_update(
+        player,
+        events.data(),
+        events.size(),
+        [&outcome](ExposureEvent const& exposure) {
+            outcome.callbacks += "e" + std::to_string(exposure.human) + "," +
+                                 std::to_string(exposure.cat) + " ";
+        },
+        [&outcome](TreatmentEvent const&) { outcome.callbacks += "t "; });
+    outcome.player = player;
+    return outcome;
+}
+
+void expect_same(PlayerState const& player, std::vector<Event> const& events) {
+    auto const expected = poll(player, events);
+    auto const actual   = batch(player, events);
+    EXPECT_EQ(actual.player.tick, expected.player.tick);
+    EXPECT_EQ(actual.player.health.health, expected.player.health.health);
+    EXPECT_EQ(actual.callbacks, expected.callbacks);
+}
+
+}  // namespace
+
+TEST(GameUpdateBatchTests, EmptyBatchOnlyTicks) {
+    auto player = new_player_state();
+    game_update(
+        player,
+        static_cast<Event const*>(nullptr),
+        0,
+        [](ExposureEvent const&) { FAIL(); },
+        [](TreatmentEvent const&) { FAIL(); });
+    EXPECT_EQ(player.tick, 1);
+    EXPECT_EQ(player.health.health, new_player_state().health.health);
+}
+
+TEST(GameUpdateBatchTests, MutableBufferAndNamedCallbacks) {
+    // A non-const buffer and lvalue callbacks must still pick the batch overload
+    std::vector<Event> events{Event{ExposureEvent{1, 0}}, Event{TreatmentEvent{}}};
+    int exposures     = 0;
+    int treatments    = 0;
+    auto on_exposure  = [&exposures](ExposureEvent const&) { ++exposures; };
+    auto on_treatment = [&treatments](TreatmentEvent const&) { ++treatments; };
+
+    PlayerState player;
+    player.health.health = 20;
+    game_update(player, events.data(), events.size(), on_exposure, on_treatment);
+    EXPECT_EQ(player.tick, 1);
+    EXPECT_EQ(exposures, 1);
+    EXPECT_EQ(treatments, 1);
+    EXPECT_EQ(player.health.health, batch(PlayerState{0, {20}}, events).player.health.health);
+}
+
+TEST(GameUpdateBatchTests, DuplicateTreatmentsAreDropped) {
+    std::vector<Event> const events{Event{TreatmentEvent{}},
+                                    Event{ExposureEvent{1, 0}},
+                                    Event{TreatmentEvent{}},
+                                    Event{TreatmentEvent{}}};
+    PlayerState player;
+    player.health.health = 75;
+    auto const outcome   = batch(player, events);
+    EXPECT_EQ(outcome.callbacks, "t e1,0 ");
+    expect_same(player, events);
+}
+
+TEST(GameUpdateBatchTests, StopsAtFirstInvalidEvent) {
+    std::vector<Event> const events{
+        Event{ExposureEvent{1, 0}}, Event{}, Event{ExposureEvent{0, 1}}, Event{TreatmentEvent{}}};
+    auto const outcome = batch(new_player_state(), events);
+    EXPECT_EQ(outcome.callbacks, "e1,0 ");
+    expect_same(new_player_state(), events);
+}
+
+TEST(GameUpdateBatchTests, EveryHealthWithMixedEvents) {
+    std::vector<Event> const events{Event{ExposureEvent{}},
+                                    Event{ExposureEvent{2, 0}},
+                                    Event{ExposureEvent{}},
+                                    Event{TreatmentEvent{}},
+                                    Event{ExposureEvent{0, 1}},
+                                    Event{TreatmentEvent{}},
+                                    Event{ExposureEvent{}},
+                                    Event{ExposureEvent{5, 1}}};
+    for (health_t health = 0; health < kNumHealthValues + 5; ++health) {
+        PlayerState player;
+        player.tick          = 3;
+        player.health.health = health;
+        SCOPED_TRACE(health);
+        expect_same(player, events);
+    }
+}
+
+TEST(GameUpdateBatchTests, MatchesPollingOnRandomQueues) {
+    std::mt19937 rng{16};
+    std::uniform_int_distribution<int> length{0, 40};
+    std::uniform_int_distribution<int> kind{0, 9};
+    std::uniform_int_distribution<health_t> human{0, 3};
+    std::uniform_int_distribution<health_t> cat{0, 1};
+    std::uniform_int_distribution<health_t> health{0, kNumHealthValues};
+
+    for (int run = 0; run < 20000; ++run) {
+        std::vector<Event> events;
+        for (int i = length(rng); i > 0; --i) {
+            auto const k = kind(rng);
+            if (k == 0) {
+                events.emplace_back(TreatmentEvent{});
+            } else if (k < 5) {
+                events.emplace_back(ExposureEvent{});
+            } else {
+                events.emplace_back(ExposureEvent{human(rng), cat(rng)});
+            }
+        }
+        PlayerState player;
+        player.health.health = health(rng);
+        SCOPED_TRACE(run);
+        expect_same(player, events);
+        if (HasFailure()) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,165 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_batch.h"
+
+namespace {
+
+/** @returns every kernel this CPU can run */
+std::vector<BatchKernel> supported_kernels() {
+    std::vector<BatchKernel> kernels;
+    for (auto const kernel : {BatchKernel::SCALAR, BatchKernel::SSE4_1, BatchKernel::AVX2}) {
+        if (is_supported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+/** @returns health values covering every state, its bounds, and wrap-around cases */
+std::vector<health_t> interesting_health_values() {
+    std::vector<health_t> values;
+    for (health_t health = 0; health <= 130; ++health) {
+        values.push_back(health);
+    }
+    for (auto const health : {1000u,
+                              std::numeric_limits<health_t>::max() - 35,
+                              std::numeric_limits<health_t>::max() - 1,
+                              std::numeric_limits<health_t>::max()}) {
+        values.push_back(health);
+    }
+    return values;
+}
+
+/** @returns exposure counts from none to large enough to wrap the health value */
+std::vector<health_t> interesting_exposure_counts() {
+    std::vector<health_t> values;
+    for (health_t count = 0; count <= 40; ++count) {
+        values.push_back(count);
+    }
+    for (auto const count : {1000u, 0x10000000u, 0x55555555u, std::numeric_limits<health_t>::max()}) {
+        values.push_back(count);
+    }
+    return values;
+}
+
+}  // namespace
+
+TEST(BranchlessUpdateTests, ExposureMatchesScalarRules) {
+    for (auto const health : interesting_health_values()) {
+        for (auto const human : interesting_exposure_counts()) {
+            for (auto const cat : interesting_exposure_counts()) {
+                auto const expected =
+                    exposure_update(HealthState{health}, ExposureEvent{human, cat}).health;
+                ASSERT_EQ(exposure_update_branchless(health, human, cat), expected)
+                    << "health=" << health << " human=" << human << " cat=" << cat;
+            }
+        }
+    }
+}
+
+TEST(BranchlessUpdateTests, TreatmentMatchesScalarRules) {
+    for (auto const health : interesting_health_values()) {
+        ASSERT_EQ(treament_update_branchless(health), treament_update(HealthState{health}).health)
+            << "health=" << health;
+    }
+}
+
+TEST(BatchUpdateTests, ExposureBatchMatchesScalarRules) {
+    // Cross product of health and exposures, with a length that leaves a vector tail
+    std::vector<health_t> health;
+    std::vector<health_t> human;
+    std::vector<health_t> cat;
+    for (auto const h : interesting_health_values()) {
+        for (auto const u : interesting_exposure_counts()) {
+            for (auto const c : {0u, 1u, 2u, 0x10000000u}) {
+                health.push_back(h);
+                human.push_back(u);
+                cat.push_back(c);
+            }
+        }
+    }
+    health.push_back(5);
+    human.push_back(1);
+    cat.push_back(1);
+
+    std::vector<health_t> expected(health.size());
+    std::vector<ExposureEvent> exposures(health.size());
+    for (std::size_t i = 0; i < health.size(); ++i) {
+        expected[i]  = exposure_update(HealthState{health[i]}, ExposureEvent{human[i], cat[i]}).health;
+        exposures[i] = ExposureEvent{human[i], cat[i]};
+    }
+
+    for (auto const kernel : supported_kernels()) {
+        auto soa = health;
+        exposure_update_batch(soa.data(), human.data(), cat.data(), soa.size(), kernel);
+        EXPECT_EQ(soa, expected) << "kernel=" << static_cast<int>(kernel);
+
+        auto aos = health;
+        exposure_update_batch(aos.data(), exposures.data(), aos.size(), kernel);
+        EXPECT_EQ(aos, expected) << "kernel=" << static_cast<int>(kernel);
+    }
+}
+
+TEST(BatchUpdateTests, TreatmentBatchMatchesScalarRules) {
+    auto const health = interesting_health_values();
+
+    std::vector<std::uint8_t> treated(health.size());
+    std::vector<health_t> expected_all(health.size());
+    std::vector<health_t> expected_masked(health.size());
+    for (std::size_t i = 0; i < health.size(); ++i) {
+        treated[i]         = static_cast<std::uint8_t>((i % 3) * 7);
+        expected_all[i]    = treament_update(HealthState{health[i]}).health;
+        expected_masked[i] = treated[i] ? expected_all[i] : health[i];
+    }
+
+    for (auto const kernel : supported_kernels()) {
+        auto all = health;
+        treament_update_batch(all.data(), all.size(), kernel);
+        EXPECT_EQ(all, expected_all) << "kernel=" << static_cast<int>(kernel);
+
+        auto masked = health;
+        treament_update_batch(masked.data(), treated.data(), masked.size(), kernel);
+        EXPECT_EQ(masked, expected_masked) << "kernel=" << static_cast<int>(kernel);
+    }
+}
+
+TEST(BatchUpdateTests, RandomPopulationMatchesScalarRules) {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<health_t> health_dist{0, 110};
+    std::uniform_int_distribution<health_t> exposure_dist{0, 6};
+
+    static constexpr std::size_t kPlayers = 10007;
+    std::vector<health_t> health(kPlayers);
+    std::vector<health_t> human(kPlayers);
+    std::vector<health_t> cat(kPlayers);
+    for (std::size_t i = 0; i < kPlayers; ++i) {
+        health[i] = health_dist(gen);
+        human[i]  = exposure_dist(gen);
+        cat[i]    = exposure_dist(gen) / 4;
+    }
+
+    for (auto const kernel : supported_kernels()) {
+        auto batch = health;
+        auto ref   = health;
+        for (int tick = 0; tick < 20; ++tick) {
+            exposure_update_batch(batch.data(), human.data(), cat.data(), kPlayers, kernel);
+            for (std::size_t i = 0; i < kPlayers; ++i) {
+                ref[i] = exposure_update(HealthState{ref[i]}, ExposureEvent{human[i], cat[i]}).health;
+            }
+            ASSERT_EQ(batch, ref) << "kernel=" << static_cast<int>(kernel) << " tick=" << tick;
+        }
+    }
+}
+
+TEST(BatchUpdateTests, DefaultKernelIsSupported) {
+    EXPECT_TRUE(is_supported(BatchKernel::SCALAR));
+    EXPECT_TRUE(is_supported(default_batch_kernel()));
+}
@@ -0,0 +1,133 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Superspreader
+#include "game_rules.h"
+#include "health_monitor_c.h"
+#include "health_monitor_core.h"
+
+namespace {
+
+constexpr ss_health_t kMaxHealth = 120;  // past zombie, as out of range values must match too
+
+struct Population {
+    std::vector<ss_health_t> health;
+    std::vector<ss_health_t> human;
+    std::vector<ss_health_t> cat;
+    std::vector<std::uint8_t> flag;
+};
+
+/** @returns @p count players of random health, exposure and flag */
+Population random_population(std::size_t count) {
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<ss_health_t> health{0, kMaxHealth};
+    std::uniform_int_distribution<ss_health_t> exposure{0, 4};
+    Population population;
+    for (std::size_t i = 0; i < count; ++i) {
+        population.health.push_back(health(rng));
+        population.human.push_back(exposure(rng));
+        population.cat.push_back(exposure(rng) / 2);
+        population.flag.push_back(static_cast<std::uint8_t>(rng() % 2));
+    }
+    return population;
+}
+
+}  // namespace
+
+TEST(HealthMonitorCTests, ReportsVersionAndBounds) {
+    EXPECT_EQ(ss_abi_version(), static_cast<std::uint32_t>(SS_ABI_VERSION));
+    EXPECT_EQ(ss_zombie_health(), to_health(StateBounds::ZOMBIE));
+}
+
+TEST(HealthMonitorCTests, SinglePlayerMatchesCore) {
+    for (ss_health_t health = 0; health <= kMaxHealth; ++health) {
+        for (ss_health_t human = 0; human < 4; ++human) {
+            for (ss_health_t cat = 0; cat < 3; ++cat) {
+                EXPECT_EQ(ss_exposure_update(health, human, cat),
+                          exposure_update(HealthState{health}, ExposureEvent{human, cat}).health);
+            }
+        }
+        EXPECT_EQ(ss_treatment_update(health), treament_update(HealthState{health}).health);
+        for (std::uint64_t ticks : {0, 1, 7, 1000}) {
+            EXPECT_EQ(ss_idle_update(health, ticks),
+                      idle_update(HealthState{health}, static_cast<unsigned long>(ticks)).health);
+        }
+        // Ticks past a 32-bit unsigned long are clamped, not truncated to a few ticks
+        auto const settled =
+            idle_update(HealthState{health}, std::numeric_limits<unsigned long>::max()).health;
+        auto const wide = std::uint64_t{1} << 32;
+        for (std::uint64_t ticks : {wide, wide + 1, std::numeric_limits<std::uint64_t>::max()}) {
+            EXPECT_EQ(ss_idle_update(health, ticks), settled) << "ticks=" << ticks;
+        }
+    }
+}
+
+TEST(HealthMonitorCTests, BatchesMatchSinglePlayer) {
+    auto population = random_population(1001);
+    auto const n    = population.health.size();
+
+    auto exposed = population.health;
+    ss_exposure_update_batch(exposed.data(), population.human.data(), population.cat.data(), n);
+    std::vector<ss_exposure> events(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        events[i] = ss_exposure{population.human[i], population.cat[i]};
+    }
+    auto exposed_events = population.health;
+    ss_exposure_update_events_batch(exposed_events.data(), events.data(), n);
+
+    auto treated_all = population.health;
+    ss_treatment_update_batch(treated_all.data(), nullptr, n);
+    auto treated_some = population.health;
+    ss_treatment_update_batch(treated_some.data(), population.flag.data(), n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const health = population.health[i];
+        auto const next   = ss_exposure_update(health, population.human[i], population.cat[i]);
+        EXPECT_EQ(exposed[i], next);
+        EXPECT_EQ(exposed_events[i], next);
+        EXPECT_EQ(treated_all[i], ss_treatment_update(health));
+        EXPECT_EQ(treated_some[i], population.flag[i] ? ss_treatment_update(health) : health);
+    }
+}
+
+TEST(HealthMonitorCTests, CatResistantMatchesEngine) {
+    auto population   = random_population(500);
+    auto const n      = population.health.size();
+    auto const before = population;
+    PlayerEngine<CatResistantRules> const rules{};
+
+    ss_cat_resistant_exposure_update_batch(population.health.data(),
+                                           population.flag.data(),
+                                           population.human.data(),
+                                           population.cat.data(),
+                                           n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const expected =
+            rules.exposure_update(ResistantHealthState{before.health[i], before.flag[i] != 0},
+                                  ExposureEvent{before.human[i], before.cat[i]});
+        EXPECT_EQ(population.health[i], expected.health);
+        EXPECT_EQ(population.flag[i] != 0, expected.cat_resistant);
+
+        auto flag = before.flag[i];
+        EXPECT_EQ(ss_cat_resistant_exposure_update(
+                      before.health[i], &flag, before.human[i], before.cat[i]),
+                  expected.health);
+        EXPECT_EQ(flag, population.flag[i]);
+    }
+
+    // Cats no longer infect once the player has been infected
+    std::uint8_t flag = 0;
+    EXPECT_EQ(ss_cat_resistant_exposure_update(45, &flag, 0, 0), 46u);
+    EXPECT_EQ(flag, 1);
+    EXPECT_EQ(ss_cat_resistant_exposure_update(20, &flag, 0, 3), 19u);
+}
+
+TEST(HealthMonitorCTests, CatResistantWithoutFlagKeepsHealth) {
+    EXPECT_EQ(ss_cat_resistant_exposure_update(45, nullptr, 2, 3), 45u);
+}
@@ -0,0 +1,105 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <limits>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+namespace {
+
+// Every health value settles within this many idle ticks
+constexpr unsigned long kSettleTicks = 2 * kNumHealthValues;
+
+// Covers every valid health value plus out of range values
+constexpr health_t kMaxHealth = kNumHealthValues + 20;
+
+}  // namespace
+
+TEST(IdleTicksTests, MatchesPerTickLoop) {
+    for (health_t health = 0; health < kMaxHealth; ++health) {
+        HealthState looped{health};
+        for (unsigned long ticks = 0; ticks <= kSettleTicks; ++ticks) {
+            ASSERT_EQ(idle_update(HealthState{health}, ticks).health, looped.health)
+                << "health=" << health << " ticks=" << ticks;
+            looped = exposure_update(looped, ExposureEvent{});
+        }
+    }
+}
+
+TEST(IdleTicksTests, SettledPlayersStaySettled) {
+    for (health_t health = 0; health < kMaxHealth; ++health) {
+        auto const settled = idle_update(HealthState{health}, kSettleTicks).health;
+        EXPECT_EQ(exposure_update(HealthState{settled}, ExposureEvent{}).health, settled)
+            << "health=" << health;
+        for (auto const ticks : {1000ul, 123456789ul, std::numeric_limits<unsigned long>::max()}) {
+            EXPECT_EQ(idle_update(HealthState{health}, ticks).health, settled)
+                << "health=" << health << " ticks=" << ticks;
+        }
+    }
+}
+
+TEST(IdleTicksTests, SettlesAtRuleFixedPoints) {
+    auto const settle = [](health_t health) {
+        return idle_update(HealthState{health}, kSettleTicks).health;
+    };
+    EXPECT_EQ(settle(0), to_health(StateBounds::IMMUNE));
+    EXPECT_EQ(settle(to_health(StateBounds::SUPER_HEALTHY)), to_health(StateBounds::HEALTHY));
+    EXPECT_EQ(settle(to_health(StateBounds::INFECTED_ASYM) - 1),
+              to_health(StateBounds::HEALTHY) + to_health(ProgressRate::HEALTHY));
+    EXPECT_EQ(settle(to_health(StateBounds::INFECTED_ASYM)), to_health(StateBounds::ZOMBIE));
+    EXPECT_EQ(settle(std::numeric_limits<health_t>::max()), to_health(StateBounds::ZOMBIE));
+}
+
+TEST(IdleTicksTests, AdvanceMatchesGameUpdate) {
+    auto const ignore    = [](auto const&) {};
+    for (health_t health = 0; health < kMaxHealth; ++health) {
+        PlayerState looped;
+        looped.tick          = 7;
+        looped.health.health = health;
+        PlayerState advanced = looped;
+        for (unsigned long ticks = 1; ticks <= kSettleTicks; ++ticks) {
+            // An idle tick is an exposure update with no exposure, as the wake cycle sends it
+            bool sent       = false;
+            auto const next = [&sent] {
+                auto const event = sent ? Event{} : Event{ExposureEvent{}};
+                sent             = true;
+                return event;
+            };
+            game_update(looped, next, ignore, ignore);
+
+            advance_idle_ticks(advanced, 1);
+            ASSERT_EQ(advanced.tick, looped.tick);
+            ASSERT_EQ(advanced.health.health, looped.health.health)
+                << "health=" << health << " ticks=" << ticks;
+        }
+    }
+}
+
+TEST(IdleTicksTests, AdvanceCountsTicks) {
+    auto player = new_player_state();
+    advance_idle_ticks(player, 0);
+    EXPECT_EQ(player.tick, 0);
+    EXPECT_EQ(player.health.health, new_player_state().health.health);
+
+    advance_idle_ticks(player, 3600);
+    EXPECT_EQ(player.tick, 3600);
+    EXPECT_EQ(player.health.health, to_health(StateBounds::HEALTHY));
+}
+
+TEST(IdleTicksTests, AdvanceSaturatesTick) {
+    constexpr auto max_tick = std::numeric_limits<int>::max();
+    auto player             = new_player_state();
+    advance_idle_ticks(player, static_cast<unsigned long>(max_tick) + 1);
+    EXPECT_EQ(player.tick, max_tick);
+    EXPECT_EQ(player.health.health, to_health(StateBounds::HEALTHY));
+
+    player.tick = 10;
+    advance_idle_ticks(player, std::numeric_limits<unsigned long>::max());
+    EXPECT_EQ(player.tick, max_tick);
+
+    // Saturated players can still be stepped without overflowing
+    advance_idle_ticks(player, 1);
+    EXPECT_EQ(player.tick, max_tick);
+}
@@ -0,0 +1,74 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <limits>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_core.h"
+
+namespace {
+
+/** @returns every valid health value plus out of range values */
+std::vector<health_t> all_health_values() {
+    std::vector<health_t> values;
+    for (health_t health = 0; health < kNumHealthValues + 20; ++health) {
+        values.push_back(health);
+    }
+    values.push_back(std::numeric_limits<health_t>::max());
+    return values;
+}
+
+}  // namespace
+
+TEST(TransitionTableTests, TreatmentMatchesRules) {
+    for (auto const health : all_health_values()) {
+        EXPECT_EQ(treament_update_lut(HealthState{health}).health,
+                  treament_update(HealthState{health}).health)
+            << "health=" << health;
+    }
+}
+
+TEST(TransitionTableTests, ProgressionMatchesIdleTick) {
+    for (health_t health = 0; health < kNumHealthValues; ++health) {
+        EXPECT_EQ(kTransitionTables.progression[health],
+                  exposure_update(HealthState{health}, ExposureEvent{}).health)
+            << "health=" << health;
+    }
+}
+
+TEST(TransitionTableTests, SusceptibilityMatchesStates) {
+    for (health_t health = 0; health < kNumHealthValues; ++health) {
+        bool const susceptible = is_super_healthy(health) || is_healthy(health);
+        EXPECT_EQ(kTransitionTables.susceptibility[health], susceptible ? 1 : 0)
+            << "health=" << health;
+    }
+}
+
+TEST(TransitionTableTests, ExposureMatchesRulesOnExposureGrid) {
+    for (auto const health : all_health_values()) {
+        for (health_t human = 0; human <= 64; ++human) {
+            for (health_t cat = 0; cat <= 64; ++cat) {
+                ExposureEvent const exposure{human, cat};
+                ASSERT_EQ(exposure_update_lut(HealthState{health}, exposure).health,
+                          exposure_update(HealthState{health}, exposure).health)
+                    << "health=" << health << " human=" << human << " cat=" << cat;
+            }
+        }
+    }
+}
+
+TEST(TransitionTableTests, ExposureMatchesRulesWhenLoadWraps) {
+    auto const max = std::numeric_limits<health_t>::max();
+    for (auto const health : all_health_values()) {
+        for (auto const human : {0x55555555u, 0x55555556u, max}) {
+            for (auto const cat : {0u, 0x10000000u, max}) {
+                ExposureEvent const exposure{human, cat};
+                ASSERT_EQ(exposure_update_lut(HealthState{health}, exposure).health,
+                          exposure_update(HealthState{health}, exposure).health)
+                    << "health=" << health << " human=" << human << " cat=" << cat;
+            }
+        }
+    }
+}
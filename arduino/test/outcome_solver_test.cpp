@@ -0,0 +1,145 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <vector>
+
+// Superspreader
+#include "outcome_solver.h"
+
+namespace {
+
+/** @returns first-passage chances by stepping a dense distribution through the rule functions */
+OutcomeDistribution solve_with_rules(OutcomeSetting const& setting, int ticks) {
+    auto const& human = setting.exposure.human;
+    auto const& cat   = setting.exposure.cat;
+    std::vector<double> health(kNumHealthValues, 0.0);
+    health[setting.initial_health] = 1.0;
+
+    OutcomeDistribution outcome;
+    auto zombie = health[to_health(StateBounds::ZOMBIE)];
+    auto immune = health[0] + health[1];
+    for (int t = 0; t < ticks; ++t) {
+        std::vector<double> next(kNumHealthValues, 0.0);
+        for (health_t h = 0; h < kNumHealthValues; ++h) {
+            auto const treated = treament_update(HealthState{h}).health;
+            for (std::size_t k = 0; k < human.size(); ++k) {
+                for (std::size_t c = 0; c < cat.size(); ++c) {
+                    ExposureEvent const exposure{static_cast<health_t>(k), static_cast<health_t>(c)};
+                    auto const chance = health[h] * human[k] * cat[c];
+                    next[exposure_update(HealthState{h}, exposure).health] +=
+                        (1.0 - setting.treatment_prob) * chance;
+                    next[exposure_update(HealthState{treated}, exposure).health] +=
+                        setting.treatment_prob * chance;
+                }
+            }
+        }
+        health = next;
+        outcome.zombie.push_back(health[to_health(StateBounds::ZOMBIE)] - zombie);
+        outcome.immune.push_back(health[0] + health[1] - immune);
+        zombie += outcome.zombie.back();
+        immune += outcome.immune.back();
+    }
+    return outcome;
+}
+
+}  // namespace
+
+TEST(OutcomeSolverTests, PoissonDistributionSumsToOne) {
+    auto const exposure = ExposureDistribution::poisson(2.5, 0.1);
+    EXPECT_NEAR(total_probability(exposure.human), 1.0, 1e-14);
+    EXPECT_NEAR(total_probability(exposure.cat), 1.0, 1e-14);
+
+    double mean = 0.0;
+    for (std::size_t k = 0; k < exposure.human.size(); ++k) {
+        mean += static_cast<double>(k) * exposure.human[k];
+    }
+    EXPECT_NEAR(mean, 2.5, 1e-12);
+}
+
+TEST(OutcomeSolverTests, DeterministicProgressionReachesZombie) {
+    // Infected players progress one health per tick with no exposure
+    OutcomeSetting setting;
+    setting.exposure       = ExposureDistribution::poisson(0.0, 0.0);
+    setting.initial_health = to_health(StateBounds::INFECTED_ASYM);
+
+    thread_pool pool{1};
+    auto const outcome = solve_outcomes({setting}, 100, pool)[0];
+    auto const ticks   = static_cast<int>(to_health(StateBounds::ZOMBIE) -
+                                        to_health(StateBounds::INFECTED_ASYM));
+    EXPECT_DOUBLE_EQ(outcome.zombie[ticks - 1], 1.0);
+    EXPECT_DOUBLE_EQ(total_probability(outcome.zombie), 1.0);
+    EXPECT_DOUBLE_EQ(mean_ticks(outcome.zombie), ticks);
+    EXPECT_EQ(ticks_to_probability(outcome.zombie, 0.5), ticks);
+    EXPECT_EQ(total_probability(outcome.immune), 0.0);
+}
+
+TEST(OutcomeSolverTests, CertainTreatmentCuresLateInfection) {
+    OutcomeSetting setting;
+    setting.exposure       = ExposureDistribution::poisson(1.0, 0.0);
+    setting.treatment_prob = 1.0;
+    setting.initial_health = to_health(StateBounds::INFECTED_SYM_LATE);
+
+    thread_pool pool{1};
+    auto const outcome = solve_outcomes({setting}, 10, pool)[0];
+    EXPECT_DOUBLE_EQ(outcome.immune[0], 1.0);
+    EXPECT_EQ(ticks_to_probability(outcome.immune, 0.5), 1);
+    EXPECT_EQ(total_probability(outcome.zombie), 0.0);
+}
+
+TEST(OutcomeSolverTests, MatchesRuleFunctions) {
+    std::vector<OutcomeSetting> settings;
+    for (double human : {0.0, 0.3, 1.5}) {
+        for (double cat : {0.0, 0.2}) {
+            for (double treatment : {0.0, 0.02, 0.3}) {
+                for (health_t initial : {2u, 25u, 60u}) {
+                    OutcomeSetting setting;
+                    setting.exposure       = ExposureDistribution::poisson(human, cat);
+                    setting.treatment_prob = treatment;
+                    setting.initial_health = initial;
+                    settings.push_back(setting);
+                }
+            }
+        }
+    }
+    // Measured distributions need not be Poisson
+    OutcomeSetting measured;
+    measured.exposure.human = {0.7, 0.1, 0.0, 0.2};
+    measured.exposure.cat   = {0.95, 0.05};
+    settings.push_back(measured);
+
+    constexpr int kTicks = 150;
+    thread_pool pool{3};
+    for (auto const kernel : {BatchKernel::SCALAR, default_batch_kernel()}) {
+        auto const outcomes = solve_outcomes(settings, kTicks, pool, kernel);
+        ASSERT_EQ(outcomes.size(), settings.size());
+        for (std::size_t i = 0; i < settings.size(); ++i) {
+            auto const expected = solve_with_rules(settings[i], kTicks);
+            for (int t = 0; t < kTicks; ++t) {
+                ASSERT_NEAR(outcomes[i].zombie[t], expected.zombie[t], 1e-12)
+                    << "setting " << i << " tick " << t;
+                ASSERT_NEAR(outcomes[i].immune[t], expected.immune[t], 1e-12)
+                    << "setting " << i << " tick " << t;
+            }
+        }
+    }
+}
+
+TEST(OutcomeSolverTests, ResultsIndependentOfThreadCount) {
+    std::vector<OutcomeSetting> settings;
+    for (int i = 0; i < 37; ++i) {
+        OutcomeSetting setting;
+        setting.exposure       = ExposureDistribution::poisson(0.05 * i, 0.01 * (i % 5));
+        setting.treatment_prob = 0.001 * i;
+        settings.push_back(setting);
+    }
+
+    thread_pool single{1};
+    thread_pool many{4};
+    auto const reference = solve_outcomes(settings, 300, single);
+    auto const parallel  = solve_outcomes(settings, 300, many);
+    for (std::size_t i = 0; i < settings.size(); ++i) {
+        EXPECT_EQ(reference[i].zombie, parallel[i].zombie) << i;
+        EXPECT_EQ(reference[i].immune, parallel[i].immune) << i;
+    }
+}
@@ -0,0 +1,167 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstring>
+#include <vector>
+
+// Superspreader
+#include "persistent_state.h"
+#include "virtual_device.h"
+
+namespace {
+
+PlayerState make_player(int tick, health_t health) {
+    PlayerState player;
+    player.tick          = tick;
+    player.health.health = health;
+    return player;
+}
+
+/** @returns state saved over @p wakes wakes, one tick and one health step each */
+PersistentState saved_state(int wakes) {
+    PersistentState stored{};
+    reset_persistent_state(new_player_state(), stored);
+    for (int tick = 1; tick <= wakes; ++tick) {
+        auto const player = make_player(tick, static_cast<health_t>(10 + tick % 30));
+        save_player_state(player, make_wake_record(player, ExposureEvent{1, 0}, tick % 4 == 0), stored);
+    }
+    return stored;
+}
+
+}  // namespace
+
+TEST(PersistentStateTests, Crc32MatchesReferenceValue) {
+    char const check[] = "123456789";
+    EXPECT_EQ(crc32(check, 9), 0xCBF43926u);
+    EXPECT_EQ(crc32(check, 0), 0u);
+}
+
+TEST(PersistentStateTests, PowerOnIsEmpty) {
+    PersistentState stored{};
+    auto player = make_player(0, 2);
+    EXPECT_EQ(load_player_state(stored, player), LoadResult::EMPTY);
+    EXPECT_EQ(player.tick, 0);
+    EXPECT_EQ(player.health.health, 2u);
+
+    // The empty state is replaced by a valid one
+    EXPECT_EQ(load_player_state(stored, player), LoadResult::RESTORED);
+    EXPECT_EQ(stored.history_size, 0u);
+}
+
+TEST(PersistentStateTests, SaveThenLoadRoundTrips) {
+    auto stored = saved_state(5);
+    PlayerState player;
+    ASSERT_EQ(load_player_state(stored, player), LoadResult::RESTORED);
+    EXPECT_EQ(player.tick, 5);
+    EXPECT_EQ(player.health.health, 15u);
+
+    ASSERT_EQ(stored.history_size, 5u);
+    for (std::size_t age = 0; age < 5; ++age) {
+        auto const wake = wake_history(stored, age);
+        EXPECT_EQ(wake.tick, 5 - age);
+        EXPECT_EQ(wake.health, 15 - age);
+        EXPECT_EQ(wake.humans(), 1u);
+        EXPECT_EQ(wake.cats(), 0u);
+        EXPECT_EQ(wake.treated(), (5 - age) % 4 == 0);
+    }
+}
+
+TEST(PersistentStateTests, HistoryKeepsMostRecentWakes) {
+    auto const stored = saved_state(static_cast<int>(3 * kWakeHistorySize + 1));
+    ASSERT_EQ(stored.history_size, kWakeHistorySize);
+    for (std::size_t age = 0; age < kWakeHistorySize; ++age) {
+        EXPECT_EQ(wake_history(stored, age).tick, 3 * kWakeHistorySize + 1 - age);
+    }
+}
+
+TEST(PersistentStateTests, WakeRecordSaturates) {
+    auto const wake = make_wake_record(make_player(70000, 99), ExposureEvent{40, 9}, true);
+    EXPECT_EQ(wake.tick, static_cast<std::uint16_t>(70000));
+    EXPECT_EQ(wake.health, 99u);
+    EXPECT_EQ(wake.humans(), 15u);
+    EXPECT_EQ(wake.cats(), 7u);
+    EXPECT_TRUE(wake.treated());
+}
+
+TEST(PersistentStateTests, EverySingleBitFlipIsDetected) {
+    auto const good = saved_state(7);
+    for (std::size_t bit = 0; bit < 8 * sizeof(PersistentState); ++bit) {
+        auto stored = good;
+        reinterpret_cast<std::uint8_t*>(&stored)[bit / 8] ^= 1u << (bit % 8);
+
+        auto player       = make_player(0, 2);
+        auto const result = load_player_state(stored, player);
+        EXPECT_NE(result, LoadResult::RESTORED) << "bit " << bit;
+        EXPECT_NE(result, LoadResult::MIGRATED) << "bit " << bit;
+        EXPECT_EQ(player.tick, 0) << "bit " << bit;
+        EXPECT_EQ(player.health.health, 2u) << "bit " << bit;
+    }
+}
+
+TEST(PersistentStateTests, CheckedFieldsOutOfRangeAreCorrupt) {
+    auto stored   = saved_state(3);
+    stored.health = 150;
+    stored.crc    = crc32(&stored, offsetof(PersistentState, crc));
+    PlayerState player;
+    EXPECT_EQ(load_player_state(stored, player), LoadResult::CORRUPT);
+
+    stored              = saved_state(3);
+    stored.history_size = kWakeHistorySize + 1;
+    stored.crc          = crc32(&stored, offsetof(PersistentState, crc));
+    EXPECT_EQ(load_player_state(stored, player), LoadResult::CORRUPT);
+}
+
+TEST(PersistentStateTests, MigratesVersion1) {
+    PersistentStateV1 v1{kPersistentStateMagic, 1, 47, 1234, 0};
+    v1.crc = crc32(&v1, offsetof(PersistentStateV1, crc));
+
+    PersistentState stored{};
+    std::memcpy(&stored, &v1, sizeof(v1));
+    PlayerState player;
+    ASSERT_EQ(load_player_state(stored, player), LoadResult::MIGRATED);
+    EXPECT_EQ(player.tick, 1234);
+    EXPECT_EQ(player.health.health, 47u);
+
+    // Rewritten in the current layout with an empty history
+    EXPECT_EQ(stored.version, kPersistentStateVersion);
+    EXPECT_EQ(stored.history_size, 0u);
+    PlayerState reloaded;
+    EXPECT_EQ(load_player_state(stored, reloaded), LoadResult::RESTORED);
+    EXPECT_EQ(reloaded.tick, 1234);
+}
+
+TEST(PersistentStateTests, CorruptVersion1IsRejected) {
+    PersistentStateV1 v1{kPersistentStateMagic, 1, 47, 1234, 0};
+    v1.crc = crc32(&v1, offsetof(PersistentStateV1, crc)) ^ 1;
+
+    PersistentState stored{};
+    std::memcpy(&stored, &v1, sizeof(v1));
+    auto player = new_player_state();
+    EXPECT_EQ(load_player_state(stored, player), LoadResult::CORRUPT);
+    EXPECT_EQ(player.tick, 0);
+}
+
+TEST(PersistentStateTests, NewerVersionIsNotTrusted) {
+    auto stored    = saved_state(3);
+    stored.version = kPersistentStateVersion + 1;
+    stored.crc     = crc32(&stored, offsetof(PersistentState, crc));
+    auto player    = new_player_state();
+    EXPECT_EQ(load_player_state(stored, player), LoadResult::UNKNOWN_VERSION);
+    EXPECT_EQ(player.tick, 0);
+}
+
+TEST(PersistentStateTests, WakeCycleRecoversFromBrownout) {
+    VirtualAir air{std::vector<float>{0.0f}, std::vector<float>{0.0f}, {}};
+    VirtualHal device{0, air, 1};
+    device.wake(false);
+    device.wake(false);
+    EXPECT_EQ(device.player_state().tick, 2);
+    EXPECT_EQ(device.persistent_state().history_size, 2u);
+
+    // A write cut short by a brownout leaves a torn tick
+    device.persistent_state().tick = 0x00FF0002;
+    device.wake(false);
+    EXPECT_EQ(device.player_state().tick, 1);
+    EXPECT_EQ(device.persistent_state().history_size, 1u);
+}
@@ -0,0 +1,184 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <vector>
+
+// Superspreader
+#include "population_simulator.h"
+
+TEST(PopulationSimulatorTests, ClassCountsCoverEveryPlayer) {
+    SimulationConfig config;
+    config.players = 1000;
+    thread_pool pool{2};
+    PopulationSimulator simulator{config, pool};
+
+    for (int t = 0; t < 10; ++t) {
+        simulator.step();
+        std::size_t total = 0;
+        for (auto const count : simulator.class_counts()) {
+            total += count;
+        }
+        EXPECT_EQ(total, config.players);
+    }
+    EXPECT_EQ(simulator.tick(), 10);
+}
+
+TEST(PopulationSimulatorTests, ResultsIndependentOfThreadCount) {
+    SimulationConfig config;
+    config.players        = 5000;
+    config.cats           = 50;
+    config.initial_zombie = 500;
+    config.contacts       = 8;
+    config.treatment_prob = 0.05;
+
+    thread_pool single{1};
+    thread_pool many{4};
+    PopulationSimulator reference{config, single};
+    PopulationSimulator parallel{config, many};
+
+    for (int t = 0; t < 50; ++t) {
+        reference.step();
+        parallel.step();
+    }
+
+    ASSERT_EQ(reference.health(), parallel.health());
+}
+
+TEST(PopulationSimulatorTests, MatchesScalarPlayerEngine) {
+    SimulationConfig config;
+    config.players        = 64;
+    config.cats           = 0;
+    config.initial_zombie = 0;
+    config.treatment_prob = 0.0;
+
+    thread_pool pool{2};
+    PopulationSimulator simulator{config, pool};
+
+    // Without contagious players or treatment every player follows the idle rules
+    PlayerState player = new_player_state();
+    for (int t = 0; t < 30; ++t) {
+        simulator.step();
+        player.health = exposure_update(player.health, ExposureEvent{});
+        for (auto const health : simulator.health()) {
+            ASSERT_EQ(health, player.health.health);
+        }
+    }
+}
+
+TEST(PopulationSimulatorTests, VenueMatchesScalarPlayerEngine) {
+    SimulationConfig config;
+    config.players        = 2000;
+    config.cats           = 20;
+    config.initial_zombie = 100;
+    config.treatment_prob = 0.3;
+    config.venue_width    = 60.0f;
+    config.venue_height   = 60.0f;
+
+    thread_pool pool{2};
+    PopulationSimulator simulator{config, pool};
+    ContactEngine contacts{config.venue_width, config.venue_height, config.rssi, pool};
+
+    std::vector<Beacon> beacons(config.players + config.cats, Beacon::CAT);
+    std::vector<health_t> human(config.players);
+    std::vector<health_t> cat(config.players);
+    for (int t = 0; t < 20; ++t) {
+        auto const before = simulator.health();
+        simulator.step();
+
+        // Count every player's contacts from where devices ended up, whatever its health
+        for (std::size_t i = 0; i < config.players; ++i) {
+            beacons[i] = is_contagious(before[i]) ? Beacon::INFECTED_HUMAN : Beacon::NONE;
+        }
+        auto const& x = simulator.x();
+        auto const& y = simulator.y();
+        contacts.build(x.data(), y.data(), beacons.data(), beacons.size());
+        contacts.count_exposures(
+            x.data(), y.data(), config.players, nullptr, human.data(), cat.data());
+
+        // The firmware enqueues the wakeup treatment, then the scan exposure
+        for (std::size_t i = 0; i < config.players; ++i) {
+            std::vector<Event> events;
+            if (simulator.treated()[i]) {
+                events.emplace_back(TreatmentEvent{});
+            }
+            events.emplace_back(ExposureEvent{human[i], cat[i]});
+
+            PlayerState player;
+            player.health.health = before[i];
+            game_update(
+                player,
+                events.data(),
+                events.size(),
+                [](ExposureEvent const&) {},
+                [](TreatmentEvent const&) {});
+            ASSERT_EQ(simulator.health()[i], player.health.health)
+                << "player " << i << ", tick " << t;
+        }
+    }
+}
+
+TEST(PopulationSimulatorTests, ZombiesSpreadWithoutTreatment) {
+    SimulationConfig config;
+    config.players        = 2000;
+    config.cats           = 0;
+    config.initial_zombie = 200;
+    config.contacts       = 8;
+    config.treatment_prob = 0.0;
+
+    thread_pool pool{2};
+    PopulationSimulator simulator{config, pool};
+    for (int t = 0; t < 200; ++t) {
+        simulator.step();
+    }
+
+    auto const counts = simulator.class_counts();
+    EXPECT_GT(counts[static_cast<std::size_t>(HealthClass::ZOMBIE)], config.initial_zombie);
+}
+
+TEST(PopulationSimulatorTests, VenueResultsIndependentOfThreadCount) {
+    SimulationConfig config;
+    config.players        = 5000;
+    config.cats           = 20;
+    config.initial_zombie = 50;
+    config.treatment_prob = 0.02;
+    config.venue_width    = 80.0f;
+    config.venue_height   = 50.0f;
+
+    thread_pool single{1};
+    thread_pool many{3};
+    PopulationSimulator reference{config, single};
+    PopulationSimulator parallel{config, many};
+
+    for (int t = 0; t < 50; ++t) {
+        reference.step();
+        parallel.step();
+    }
+
+    ASSERT_EQ(reference.health(), parallel.health());
+    auto const counts = reference.class_counts();
+    EXPECT_GT(counts[static_cast<std::size_t>(HealthClass::ZOMBIE)], config.initial_zombie);
+}
+
+TEST(PopulationSimulatorTests, SlowCrowdIndependentOfThreadCount) {
+    SimulationConfig config;
+    config.players        = 5000;
+    config.cats           = 20;
+    config.initial_zombie = 20;
+    config.treatment_prob = 0.02;
+    config.venue_width    = 80.0f;
+    config.venue_height   = 60.0f;
+    config.move_prob      = 0.02;
+
+    thread_pool single{1};
+    thread_pool many{4};
+    PopulationSimulator reference{config, single};
+    PopulationSimulator parallel{config, many};
+
+    for (int t = 0; t < 50; ++t) {
+        reference.step();
+        parallel.step();
+    }
+
+    ASSERT_EQ(reference.health(), parallel.health());
+}
@@ -0,0 +1,143 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Superspreader
+#include "health_monitor_core.h"
+#include "spsc_ring_buffer.h"
+
+TEST(SpscRingBufferTests, StartsEmpty) {
+    spsc_ring_buffer<Event, 4> buffer;
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.size(), 0u);
+
+    Event event;
+    EXPECT_FALSE(buffer.try_pop_front(event));
+    EXPECT_FALSE(event.is_valid());
+}
+
+TEST(SpscRingBufferTests, RejectsPushWhenFull) {
+    spsc_ring_buffer<int, 3> buffer;
+    EXPECT_TRUE(buffer.try_emplace_back(1));
+    EXPECT_TRUE(buffer.try_emplace_back(2));
+    EXPECT_TRUE(buffer.try_emplace_back(3));
+    EXPECT_EQ(buffer.size(), 3u);
+    EXPECT_FALSE(buffer.try_emplace_back(4));
+
+    int value = 0;
+    ASSERT_TRUE(buffer.try_pop_front(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(buffer.try_emplace_back(4));
+    EXPECT_EQ(buffer.size(), 3u);
+}
+
+TEST(SpscRingBufferTests, PreservesOrderAcrossWrap) {
+    spsc_ring_buffer<int, 5> buffer;
+    int next_in  = 0;
+    int next_out = 0;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 1 + round % 5; ++i) {
+            ASSERT_TRUE(buffer.try_emplace_back(next_in++));
+        }
+        while (!buffer.empty()) {
+            EXPECT_EQ(buffer.front(), next_out++);
+            buffer.pop_front();
+        }
+    }
+    EXPECT_EQ(next_in, next_out);
+}
+
+TEST(SpscRingBufferTests, HoldsEvents) {
+    spsc_ring_buffer<Event, 2> buffer;
+    ASSERT_TRUE(buffer.try_emplace_back(TreatmentEvent{}));
+    ASSERT_TRUE(buffer.try_emplace_back(ExposureEvent{2, 1}));
+
+    Event event;
+    ASSERT_TRUE(buffer.try_pop_front(event));
+    EXPECT_EQ(event.type, Event::Type::TREATMENT);
+    ASSERT_TRUE(buffer.try_pop_front(event));
+    EXPECT_EQ(event.type, Event::Type::EXPOSURE);
+    EXPECT_EQ(event.data.exposure.human, 2u);
+    EXPECT_EQ(event.data.exposure.cat, 1u);
+}
+
+TEST(SpscRingBufferTests, DestroysRemainingValues) {
+    auto const tracker = std::make_shared<int>(0);
+    {
+        spsc_ring_buffer<std::shared_ptr<int>, 4> buffer;
+        buffer.try_emplace_back(tracker);
+        buffer.try_emplace_back(tracker);
+        buffer.try_emplace_back(tracker);
+        std::shared_ptr<int> out;
+        ASSERT_TRUE(buffer.try_pop_front(out));
+        EXPECT_EQ(tracker.use_count(), 4);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(SpscRingBufferTests, ConcurrentEventStream) {
+    static constexpr int kEvents = 100000;
+    spsc_ring_buffer<Event, 4> buffer;
+
+    std::thread producer{[&buffer]() {
+        for (int i = 0; i < kEvents;) {
+            if (buffer.try_emplace_back(ExposureEvent{static_cast<health_t>(i), 0})) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    int consumed = 0;
+    bool valid   = true;
+    Event event;
+    while (consumed < kEvents) {
+        if (buffer.try_pop_front(event)) {
+            valid = valid && event.type == Event::Type::EXPOSURE &&
+                    event.data.exposure.human == static_cast<health_t>(consumed);
+            ++consumed;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(valid);
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(SpscRingBufferTests, ConcurrentProducerConsumerStress) {
+    static constexpr std::uint64_t kItems = 200000;
+    spsc_ring_buffer<std::uint64_t, 64> buffer;
+
+    std::thread producer{[&buffer]() {
+        for (std::uint64_t i = 0; i < kItems;) {
+            if (buffer.try_emplace_back(i * 2654435761u)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    std::uint64_t expected = 0;
+    std::uint64_t value    = 0;
+    bool in_order          = true;
+    while (expected < kItems) {
+        if (buffer.try_pop_front(value)) {
+            in_order = in_order && value == expected * 2654435761u;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(buffer.empty());
+}
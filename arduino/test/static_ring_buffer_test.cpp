@@ -0,0 +1,241 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Superspreader
+#include "health_monitor_core.h"
+#include "static_ring_buffer.h"
+
+namespace {
+
+/** @returns values of @p buffer's readable segments, in order */
+template <typename BufferT>
+std::vector<int> segment_values(BufferT const& buffer) {
+    auto const segments = buffer.readable();
+    std::vector<int> values(segments.first.begin(), segments.first.end());
+    values.insert(values.end(), segments.second.begin(), segments.second.end());
+    return values;
+}
+
+/** @returns sum of 0 .. 19, pushed and popped through a buffer that wraps several times */
+constexpr int sum_through_buffer() {
+    static_ring_buffer<int, 3, ring_buffer_returns_status> buffer;
+    int sum = 0;
+    for (int i = 0; i < 20; i += 2) {
+        int const pair[] = {i, i + 1};
+        buffer.push_n(pair, 2);
+        sum += buffer.front();
+        buffer.pop_front();
+        int drained = 0;
+        buffer.drain_into(&drained);
+        sum += drained;
+    }
+    return buffer.empty() ? sum : -1;
+}
+
+}  // namespace
+
+template <typename BufferT>
+class StaticRingBufferTests : public testing::Test {};
+
+// Power-of-two and non-power-of-two capacities take different wrapping paths
+using Capacities = testing::Types<static_ring_buffer<int, 8>, static_ring_buffer<int, 7>>;
+TYPED_TEST_SUITE(StaticRingBufferTests, Capacities);
+
+TYPED_TEST(StaticRingBufferTests, EmplaceAndPopPreserveOrderAcrossWrap) {
+    TypeParam buffer;
+    int next_in  = 0;
+    int next_out = 0;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < 1 + round % 5; ++i) {
+            buffer.emplace_back(next_in++);
+        }
+        while (!buffer.empty()) {
+            EXPECT_EQ(buffer.front(), next_out++);
+            buffer.pop_front();
+        }
+    }
+    EXPECT_EQ(next_in, next_out);
+}
+
+TYPED_TEST(StaticRingBufferTests, PushNAndDrainIntoAcrossWrap) {
+    TypeParam buffer;
+    std::vector<int> source(TypeParam::capacity());
+    std::iota(source.begin(), source.end(), 0);
+
+    for (std::size_t offset = 0; offset < TypeParam::capacity(); ++offset) {
+        // Move the read position so the pushed values wrap at every possible point
+        buffer.push_n(source.begin(), offset);
+        std::vector<int> discard;
+        buffer.drain_into(std::back_inserter(discard));
+        EXPECT_EQ(discard.size(), offset);
+
+        buffer.push_n(source.begin(), source.size());
+        EXPECT_TRUE(buffer.full());
+        EXPECT_EQ(segment_values(buffer), source);
+
+        std::vector<int> drained;
+        buffer.drain_into(std::back_inserter(drained), 3);
+        buffer.drain_into(std::back_inserter(drained));
+        EXPECT_EQ(drained, source);
+        EXPECT_TRUE(buffer.empty());
+    }
+}
+
+TYPED_TEST(StaticRingBufferTests, SegmentsSplitAtEndOfStorage) {
+    TypeParam buffer;
+    auto const capacity = TypeParam::capacity();
+    for (std::size_t i = 0; i < capacity - 2; ++i) {
+        buffer.emplace_back(-1);
+    }
+    buffer.consume(capacity - 2);
+
+    for (int i = 0; i < 5; ++i) {
+        buffer.emplace_back(i);
+    }
+    auto const segments = buffer.readable();
+    EXPECT_EQ(segments.first.size, 2u);
+    EXPECT_EQ(segments.second.size, 3u);
+    EXPECT_EQ(segment_values(buffer), (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TYPED_TEST(StaticRingBufferTests, IteratesOldestToNewest) {
+    TypeParam buffer;
+    for (int i = 0; i < 5; ++i) {
+        buffer.emplace_back(i);
+    }
+    buffer.pop_front();
+    buffer.pop_front();
+    for (int i = 5; i < 9; ++i) {
+        buffer.emplace_back(i);
+    }
+
+    std::vector<int> const expected{2, 3, 4, 5, 6, 7, 8};
+    std::vector<int> const iterated(buffer.begin(), buffer.end());
+    EXPECT_EQ(iterated, expected);
+    EXPECT_EQ(static_cast<std::size_t>(std::distance(buffer.cbegin(), buffer.cend())),
+              buffer.size());
+}
+
+TYPED_TEST(StaticRingBufferTests, SafeModeThrowsOnOverflowAndUnderflow) {
+    TypeParam buffer;
+    EXPECT_THROW(buffer.pop_front(), std::range_error);
+    EXPECT_THROW(buffer.consume(1), std::range_error);
+
+    std::vector<int> const too_many(TypeParam::capacity() + 1, 0);
+    EXPECT_THROW(buffer.push_n(too_many.begin(), too_many.size()), std::range_error);
+    EXPECT_TRUE(buffer.empty());
+
+    buffer.push_n(too_many.begin(), TypeParam::capacity());
+    EXPECT_THROW(buffer.emplace_back(0), std::range_error);
+}
+
+TEST(StaticRingBufferOwnershipTests, DestroysValuesOnDrainConsumeAndDestruction) {
+    auto const tracker = std::make_shared<int>(0);
+    {
+        static_ring_buffer<std::shared_ptr<int>, 6> buffer;
+        std::vector<std::shared_ptr<int>> const copies(6, tracker);
+        buffer.push_n(copies.begin(), copies.size());
+        EXPECT_EQ(tracker.use_count(), 13);
+
+        buffer.consume(2);
+        EXPECT_EQ(tracker.use_count(), 11);
+
+        std::vector<std::shared_ptr<int>> drained;
+        buffer.drain_into(std::back_inserter(drained), 2);
+        EXPECT_EQ(tracker.use_count(), 11);
+        drained.clear();
+        EXPECT_EQ(tracker.use_count(), 9);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(StaticRingBufferOwnershipTests, HoldsEvents) {
+    static_ring_buffer<Event, 4> buffer;
+    Event const events[] = {Event{TreatmentEvent{}}, Event{ExposureEvent{1, 2}}};
+    buffer.push_n(std::begin(events), 2);
+
+    Event drained[4];
+    auto const end = buffer.drain_into(std::begin(drained));
+    ASSERT_EQ(end - std::begin(drained), 2);
+    EXPECT_EQ(drained[0].type, Event::Type::TREATMENT);
+    EXPECT_EQ(drained[1].type, Event::Type::EXPOSURE);
+    EXPECT_EQ(drained[1].data.exposure.cat, 2u);
+}
+
+TEST(StaticRingBufferPolicyTests, ReturnsStatusAndLeavesBufferUnchanged) {
+    static_ring_buffer<int, 3, ring_buffer_returns_status> buffer;
+    EXPECT_FALSE(buffer.pop_front());
+    EXPECT_FALSE(buffer.consume(1));
+
+    int const values[] = {1, 2, 3, 4};
+    EXPECT_FALSE(buffer.push_n(values, 4));
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_TRUE(buffer.push_n(values, 2));
+    EXPECT_TRUE(buffer.emplace_back(3));
+    EXPECT_FALSE(buffer.emplace_back(4));
+    EXPECT_EQ(std::vector<int>(buffer.begin(), buffer.end()), (std::vector<int>{1, 2, 3}));
+
+    EXPECT_TRUE(buffer.consume(2));
+    EXPECT_TRUE(buffer.pop_front());
+    EXPECT_FALSE(buffer.pop_front());
+}
+
+TEST(StaticRingBufferPolicyTests, AssertsOnOverflowAndUnderflow) {
+#if defined(NDEBUG)
+    GTEST_SKIP() << "asserts are compiled out";
+#else
+    static_ring_buffer<int, 2, ring_buffer_asserts> buffer;
+    EXPECT_DEATH(buffer.pop_front(), "out of bounds");
+    EXPECT_DEATH(buffer.consume(1), "out of bounds");
+    buffer.emplace_back(1);
+    buffer.emplace_back(2);
+    EXPECT_DEATH(buffer.emplace_back(3), "out of bounds");
+    int const values[] = {3};
+    EXPECT_DEATH(buffer.push_n(values, 1), "out of bounds");
+#endif
+}
+
+TEST(StaticRingBufferPolicyTests, UncheckedAndAssertReturnNothing) {
+    static_assert(!ring_buffer_unchecked::kChecked, "unchecked buffers compile the checks out");
+    static_assert(std::is_void<static_ring_buffer<int, 2, ring_buffer_unchecked>::status>::value,
+                  "unchecked operations return nothing");
+    static_assert(std::is_void<static_ring_buffer<int, 2, ring_buffer_asserts>::status>::value,
+                  "asserting operations return nothing");
+    static_assert(std::is_same<static_ring_buffer<int, 2>::error_policy, ring_buffer_throws>::value,
+                  "buffers throw by default when exceptions are enabled");
+
+    static_ring_buffer<int, 2, ring_buffer_unchecked> buffer;
+    buffer.emplace_back(1);
+    buffer.emplace_back(2);
+    EXPECT_TRUE(buffer.full());
+    buffer.consume(1);
+    EXPECT_EQ(buffer.front(), 2);
+}
+
+TEST(StaticRingBufferTrivialTests, TrivialValuesNeedNoDestructor) {
+    static_assert(std::is_trivially_destructible<static_ring_buffer<int, 4>>::value,
+                  "int buffers are trivially destructible");
+    static_assert(std::is_trivially_destructible<static_ring_buffer<Event, 4>>::value,
+                  "Event buffers are trivially destructible");
+    static_assert(std::is_trivially_copyable<static_ring_buffer<Event, 4>>::value,
+                  "Event buffers are trivially copyable");
+    static_assert(!std::is_trivially_destructible<static_ring_buffer<std::shared_ptr<int>, 4>>::value,
+                  "buffers of values with destructors destroy them");
+    static_assert(sizeof(static_ring_buffer<Event, 4>) ==
+                      4 * sizeof(Event) + 2 * sizeof(std::size_t),
+                  "no space is spent on the policy or storage choice");
+}
+
+TEST(StaticRingBufferTrivialTests, TrivialValuesWorkInConstantExpressions) {
+    constexpr int sum = sum_through_buffer();
+    static_assert(sum == 190, "buffer of ints evaluated at compile time");
+    EXPECT_EQ(sum_through_buffer(), 190);
+}
@@ -0,0 +1,103 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Superspreader
+#include "counter_rng.h"
+#include "timing_wheel.h"
+
+namespace {
+
+using Fired = std::vector<std::pair<std::uint64_t, int>>;
+
+/** @returns (time, payload) of every event @p wheel fires up to @p until */
+template <typename WheelT>
+Fired drain(WheelT& wheel, std::uint64_t until) {
+    Fired fired;
+    wheel.advance(until, [&fired](std::uint64_t time, int payload) {
+        fired.emplace_back(time, payload);
+    });
+    return fired;
+}
+
+}  // namespace
+
+TEST(TimingWheelTests, FiresInTimeOrderAcrossLevels) {
+    // Small levels so a few thousand ticks cross every level and the horizon
+    timing_wheel<int, 2, 6> wheel;
+    std::vector<std::uint64_t> times;
+    for (int i = 0; i < 2000; ++i) {
+        counter_rng rng{7, 0, static_cast<std::uint64_t>(i)};
+        times.push_back(rng.below(20000));
+        wheel.schedule(times.back(), i);
+    }
+    EXPECT_EQ(wheel.size(), 2000u);
+
+    auto const fired = drain(wheel, 30000);
+    ASSERT_EQ(fired.size(), times.size());
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.now(), 30000u);
+    for (std::size_t i = 0; i < fired.size(); ++i) {
+        EXPECT_EQ(fired[i].first, times[static_cast<std::size_t>(fired[i].second)]);
+        if (i > 0) {
+            EXPECT_LE(fired[i - 1].first, fired[i].first);
+        }
+    }
+}
+
+TEST(TimingWheelTests, SameTimeFiresInScheduleOrder) {
+    timing_wheel<int> wheel;
+    for (int i = 0; i < 5; ++i) {
+        wheel.schedule(70000, i);
+    }
+    wheel.schedule(3, 10);
+    auto const fired = drain(wheel, 70000);
+    ASSERT_EQ(fired.size(), 6u);
+    EXPECT_EQ(fired[0], std::make_pair(std::uint64_t{3}, 10));
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(fired[static_cast<std::size_t>(i) + 1].second, i);
+    }
+}
+
+TEST(TimingWheelTests, StopsAtUntilAndResumes) {
+    timing_wheel<int> wheel{100};
+    wheel.schedule(50, 1);  // in the past, fires at once
+    wheel.schedule(400, 2);
+    wheel.schedule(100000, 3);
+
+    auto fired = drain(wheel, 399);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0], std::make_pair(std::uint64_t{100}, 1));
+    EXPECT_EQ(wheel.now(), 399u);
+
+    fired = drain(wheel, 99999);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].first, 400u);
+
+    fired = drain(wheel, 100000);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].first, 100000u);
+}
+
+TEST(TimingWheelTests, CallbacksCanSchedule) {
+    timing_wheel<int> wheel;
+    wheel.schedule(0, 0);
+    std::vector<std::uint64_t> times;
+    auto const fired = wheel.advance(1000000, [&wheel, &times](std::uint64_t time, int hops) {
+        times.push_back(time);
+        if (hops < 20) {
+            // Same tick, then ever longer gaps
+            wheel.schedule(hops % 2 == 0 ? time : time + (std::uint64_t{1} << hops), hops + 1);
+        }
+    });
+    EXPECT_EQ(fired, 21u);
+    ASSERT_EQ(times.size(), 21u);
+    EXPECT_TRUE(std::is_sorted(times.begin(), times.end()));
+    EXPECT_EQ(times[1], 0u);
+    EXPECT_TRUE(wheel.empty());
+}
@@ -0,0 +1,177 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// POSIX
+#include <unistd.h>
+
+// Superspreader
+#include "counter_rng.h"
+#include "game_trace.h"
+#include "population_simulator.h"
+#include "trajectory.h"
+
+namespace {
+
+constexpr std::size_t kPlayers = 1000;
+constexpr std::size_t kTicks   = 40;
+
+std::string temp_path(char const* name) {
+    return "/tmp/" + std::string{name} + "." + std::to_string(::getpid()) + ".sstj";
+}
+
+/** @returns @c kTicks ticks of health, mostly unchanged from one tick to the next */
+std::vector<std::vector<health_t>> make_ticks() {
+    std::vector<std::vector<health_t>> ticks(kTicks, std::vector<health_t>(kPlayers));
+    for (std::size_t player = 0; player < kPlayers; ++player) {
+        ticks[0][player] = static_cast<health_t>(player % 3 == 0 ? 0 : 100 + player % 400);
+    }
+    for (std::size_t t = 1; t < kTicks; ++t) {
+        for (std::size_t player = 0; player < kPlayers; ++player) {
+            counter_rng rng{3, t, player};
+            auto const health = ticks[t - 1][player];
+            ticks[t][player]  = rng.below(10) == 0 ? static_cast<health_t>(rng.below(600)) : health;
+        }
+    }
+    return ticks;
+}
+
+std::uint8_t expected(health_t health, TrajectoryColumn column) {
+    return column == TrajectoryColumn::HEALTH
+               ? to_trace_health(health)
+               : static_cast<std::uint8_t>(to_health_class(health));
+}
+
+void write(std::string const& path,
+           std::vector<std::vector<health_t>> const& ticks,
+           TrajectoryOptions const& options) {
+    thread_pool pool{3};
+    TrajectoryWriter writer{pool};
+    std::string error;
+    ASSERT_TRUE(writer.open(path, kPlayers, options, error)) << error;
+    for (auto const& tick : ticks) {
+        ASSERT_TRUE(writer.append(tick.data(), error)) << error;
+    }
+    EXPECT_EQ(writer.ticks(), ticks.size());
+    ASSERT_TRUE(writer.close(error)) << error;
+}
+
+}  // namespace
+
+TEST(TrajectoryTests, RoundTripsWithAndWithoutCompression) {
+    auto const ticks = make_ticks();
+    auto const path  = temp_path("round_trip");
+    for (auto const compress : {false, true}) {
+        TrajectoryOptions options;
+        options.block_players     = 300;  // three full blocks and a short one
+        options.keyframe_interval = 8;
+        options.compress          = compress;
+        write(path, ticks, options);
+
+        TrajectoryReader reader;
+        std::string error;
+        ASSERT_TRUE(reader.open(path, error)) << error;
+        EXPECT_EQ(reader.players(), kPlayers);
+        EXPECT_EQ(reader.ticks(), kTicks);
+        EXPECT_EQ(reader.blocks(), 4u);
+
+        for (auto const column : {TrajectoryColumn::HEALTH, TrajectoryColumn::STATE}) {
+            std::vector<std::uint8_t> out(kTicks * kPlayers);
+            ASSERT_TRUE(reader.read(column, 0, kTicks, 0, kPlayers, out.data(), error)) << error;
+            for (std::size_t t = 0; t < kTicks; ++t) {
+                for (std::size_t player = 0; player < kPlayers; ++player) {
+                    ASSERT_EQ(out[t * kPlayers + player], expected(ticks[t][player], column))
+                        << "tick " << t << " player " << player;
+                }
+            }
+        }
+
+        // Compressed chunks are smaller, uncompressed chunks are all raw
+        std::size_t encoded = 0;
+        for (std::uint64_t t = 0; t < kTicks; ++t) {
+            for (std::size_t block = 0; block < reader.blocks(); ++block) {
+                encoded += reader.chunk(t, TrajectoryColumn::STATE, block).encoding !=
+                           TrajectoryEncoding::RAW;
+            }
+        }
+        if (compress) {
+            EXPECT_GT(encoded, 0u);
+        } else {
+            EXPECT_EQ(encoded, 0u);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TrajectoryTests, CursorSeeksToAnyTickAndPlayerRange) {
+    auto const ticks = make_ticks();
+    auto const path  = temp_path("seek");
+    TrajectoryOptions options;
+    options.block_players     = 128;
+    options.keyframe_interval = 16;
+    write(path, ticks, options);
+
+    TrajectoryReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.open(path, error)) << error;
+
+    // Ranges inside one block, across blocks and up to the short last block
+    std::size_t const ranges[][2] = {{0, 1}, {5, 100}, {120, 300}, {900, 100}, {999, 1}};
+    for (auto const& range : ranges) {
+        TrajectoryCursor cursor{reader, TrajectoryColumn::HEALTH, range[0], range[1]};
+        for (std::uint64_t start : {0u, 15u, 16u, 17u, 39u}) {
+            ASSERT_TRUE(cursor.seek(start, error)) << error;
+            for (auto t = start; t < kTicks; ++t) {
+                if (t > start) {
+                    ASSERT_TRUE(cursor.next(error)) << error;
+                }
+                ASSERT_EQ(cursor.tick(), t);
+                ASSERT_EQ(cursor.size(), range[1]);
+                for (std::size_t i = 0; i < range[1]; ++i) {
+                    ASSERT_EQ(cursor.values()[i], to_trace_health(ticks[t][range[0] + i]))
+                        << "tick " << t << " player " << range[0] + i;
+                }
+            }
+            EXPECT_FALSE(cursor.next(error));
+        }
+    }
+
+    TrajectoryCursor outside{reader, TrajectoryColumn::STATE, 900, 101};
+    EXPECT_FALSE(outside.seek(0, error));
+    TrajectoryCursor inside{reader, TrajectoryColumn::STATE, 0, 1};
+    EXPECT_FALSE(inside.seek(kTicks, error));
+    std::remove(path.c_str());
+}
+
+TEST(TrajectoryTests, RejectsUnfinishedAndCorruptFiles) {
+    auto const ticks = make_ticks();
+    auto const path  = temp_path("corrupt");
+    std::string error;
+    {
+        // Killed before close: no index
+        thread_pool pool{1};
+        TrajectoryWriter writer{pool};
+        ASSERT_TRUE(writer.open(path, kPlayers, TrajectoryOptions{}, error)) << error;
+        ASSERT_TRUE(writer.append(ticks[0].data(), error)) << error;
+
+        TrajectoryReader reader;
+        EXPECT_FALSE(reader.open(path, error));
+        EXPECT_FALSE(error.empty());
+    }
+
+    write(path, ticks, TrajectoryOptions{});
+    TrajectoryReader reader;
+    ASSERT_TRUE(reader.open(path, error)) << error;
+
+    // Cut off the end of the index
+    ASSERT_EQ(::truncate(path.c_str(), 200), 0);
+    EXPECT_FALSE(reader.open(path, error));
+
+    EXPECT_FALSE(reader.open(temp_path("missing"), error));
+    std::remove(path.c_str());
+}
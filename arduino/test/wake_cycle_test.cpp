@@ -0,0 +1,105 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <vector>
+
+// Superspreader
+#include "virtual_device.h"
+
+namespace {
+
+/** @brief Two devices 1 m apart, or further apart if @p distance is given */
+VirtualAir make_pair_air(float distance = 1.0f) {
+    return VirtualAir{std::vector<float>{0.0f, distance}, std::vector<float>{0.0f, 0.0f}, {}};
+}
+
+}  // namespace
+
+TEST(WakeCycleTests, FreshDeviceProgressesAndSleeps) {
+    auto air = make_pair_air();
+    VirtualHal device{0, air, 1};
+
+    device.wake(false);
+
+    // Nobody advertised yet, so this is an idle tick
+    auto const expected = exposure_update(new_player_state().health, ExposureEvent{});
+    EXPECT_EQ(device.health(), expected.health);
+    EXPECT_EQ(device.player_state().tick, 1);
+    EXPECT_TRUE(device.led(Led::BLUE));
+    EXPECT_GE(device.sleep_us(), 1 * uS_TO_S_FACTOR);
+    EXPECT_LT(device.sleep_us(), static_cast<std::uint64_t>(TIME_TO_SLEEP) * uS_TO_S_FACTOR);
+    EXPECT_EQ(device.awake_us(), static_cast<std::uint64_t>(SCAN_SECONDS) * uS_TO_S_FACTOR);
+}
+
+TEST(WakeCycleTests, ScanCountsNearbyZombies) {
+    auto air = make_pair_air();
+    VirtualHal zombie{0, air, 1};
+    VirtualHal player{1, air, 1};
+    zombie.set_health(to_health(StateBounds::ZOMBIE));
+
+    // First round advertises, second round hears it
+    zombie.wake(false);
+    player.wake(false);
+    air.publish();
+    auto const before = player.health();
+    player.wake(false);
+
+    auto const expected = exposure_update(HealthState{before}, ExposureEvent{1, 0});
+    EXPECT_EQ(player.health(), expected.health);
+    EXPECT_TRUE(zombie.led(Led::RED));
+}
+
+TEST(WakeCycleTests, DistantZombiesAreIgnored) {
+    auto air = make_pair_air(RssiModel{}.range() * 2.0f);
+    VirtualHal zombie{0, air, 1};
+    VirtualHal player{1, air, 1};
+    zombie.set_health(to_health(StateBounds::ZOMBIE));
+
+    zombie.wake(false);
+    air.publish();
+    auto const before = player.health();
+    player.wake(false);
+
+    EXPECT_EQ(player.health(), exposure_update(HealthState{before}, ExposureEvent{}).health);
+}
+
+TEST(WakeCycleTests, TreatmentWakeAppliesTreatmentOnce) {
+    auto air = make_pair_air();
+    VirtualHal device{0, air, 1};
+    device.set_health(95);
+
+    // Woken by the pin and pressed again while awake: only one treatment per tick
+    device.press_treatment();
+    device.wake(true);
+
+    EXPECT_EQ(device.health(),
+              exposure_update(treament_update(HealthState{95}), ExposureEvent{}).health);
+    EXPECT_TRUE(device.interrupt_queue().empty());
+    // Treated to immune, so exposure cannot matter: no scan, only the treatment animation
+    EXPECT_EQ(device.awake_us(), 2 * 2000000 + 8 * 200000);
+}
+
+TEST(WakeCycleTests, FleetResultsIndependentOfThreadCount) {
+    FleetConfig config;
+    config.devices        = 300;
+    config.initial_zombie = 5;
+    config.treatment_prob = 0.05;
+    config.venue_width    = 30.0f;
+    config.venue_height   = 20.0f;
+
+    thread_pool single{1};
+    thread_pool many{3};
+    VirtualFleet reference{config, single};
+    VirtualFleet parallel{config, many};
+    for (int r = 0; r < 30; ++r) {
+        reference.run_round();
+        parallel.run_round();
+    }
+
+    for (std::size_t id = 0; id < config.devices; ++id) {
+        ASSERT_EQ(reference.device(id).health(), parallel.device(id).health()) << "device " << id;
+    }
+    EXPECT_GT(reference.class_counts()[static_cast<std::size_t>(HealthClass::ZOMBIE)],
+              config.initial_zombie);
+}
@@ -0,0 +1,122 @@
+// GTest
+#include <gtest/gtest.h>
+
+// C++ Standard Library
+#include <string>
+#include <vector>
+
+// Superspreader
+#include "virtual_device.h"
+#include "wake_profile.h"
+#include "wake_profile_report.h"
+
+namespace {
+
+std::uint64_t phase_us(WakeProfile const& profile, WakePhase phase) {
+    return profile.duration_us[static_cast<std::size_t>(phase)];
+}
+
+std::uint64_t phase_nj(WakeProfile const& profile, WakePhase phase) {
+    return profile.energy_nj[static_cast<std::size_t>(phase)];
+}
+
+}  // namespace
+
+TEST(WakeProfileTests, ProfilerChargesTimeToThePhaseBeingLeft) {
+    WakeProfile profile{};
+    WakeProfiler profiler{profile, 100};
+
+    profiler.enter(WakePhase::SCAN, 300);
+    profiler.enter(WakePhase::GAME_UPDATE, 1300);
+    profiler.finish(1400, 5000);
+
+    EXPECT_EQ(profile.wakes, 1u);
+    EXPECT_EQ(phase_us(profile, WakePhase::SETUP), 200u);
+    EXPECT_EQ(phase_us(profile, WakePhase::SCAN), 1000u);
+    EXPECT_EQ(phase_us(profile, WakePhase::GAME_UPDATE), 100u);
+    EXPECT_EQ(phase_us(profile, WakePhase::DEEP_SLEEP), 5000u);
+    EXPECT_EQ(phase_nj(profile, WakePhase::SCAN),
+              1000u * kPhasePowerUw[static_cast<std::size_t>(WakePhase::SCAN)] / 1000);
+}
+
+TEST(WakeProfileTests, RecordRoundTrips) {
+    WakeProfile profile{};
+    profile.wakes = 42;
+    for (std::size_t i = 0; i < kNumWakePhases; ++i) {
+        profile.duration_us[i] = 1000000000000ULL + i;
+        profile.energy_nj[i]   = 18000000000000000000ULL + i;
+    }
+
+    char line[kWakeProfileLineSize];
+    auto const length = format_wake_profile(profile, line, sizeof(line));
+    ASSERT_LT(length, sizeof(line));
+
+    // Serial log lines may carry a prefix and a line ending
+    auto const logged = "[I] " + std::string(line) + "\r\n";
+    WakeProfile parsed{};
+    ASSERT_TRUE(parse_wake_profile(logged.c_str(), parsed));
+    EXPECT_EQ(parsed.wakes, profile.wakes);
+    for (std::size_t i = 0; i < kNumWakePhases; ++i) {
+        EXPECT_EQ(parsed.duration_us[i], profile.duration_us[i]);
+        EXPECT_EQ(parsed.energy_nj[i], profile.energy_nj[i]);
+    }
+}
+
+TEST(WakeProfileTests, TruncatedRecordWritesNothing) {
+    WakeProfile profile{};
+    profile.energy_nj[kNumWakePhases - 1] = 18000000000000000000ULL;
+
+    char line[kWakeProfileLineSize];
+    auto const length = format_wake_profile(profile, line, sizeof(line));
+    ASSERT_GT(length, 0u);
+    EXPECT_EQ(format_wake_profile(profile, line, length), 0u);
+    EXPECT_EQ(format_wake_profile(profile, line, 8), 0u);
+    EXPECT_EQ(format_wake_profile(profile, line, length + 1), length);
+}
+
+TEST(WakeProfileTests, MalformedRecordsAreRejected) {
+    WakeProfile parsed{};
+    parsed.wakes = 7;
+
+    EXPECT_FALSE(parse_wake_profile("Start Health: 90", parsed));
+    EXPECT_FALSE(parse_wake_profile("wake_profile,1,3,10,20", parsed));
+    EXPECT_FALSE(parse_wake_profile("wake_profile,2,3,1,1,1,1,1,1,1,1,1,1,1,1", parsed));
+    EXPECT_FALSE(parse_wake_profile("wake_profile,1,3,1,1,1,1,x,1,1,1,1,1,1,1", parsed));
+    EXPECT_EQ(parsed.wakes, 7u);
+
+    EXPECT_TRUE(parse_wake_profile("wake_profile,1,3,1,1,1,1,1,1,1,1,1,1,1,1", parsed));
+    EXPECT_EQ(parsed.wakes, 3u);
+}
+
+TEST(WakeProfileTests, WakeCycleChargesEveryPhase) {
+    VirtualAir air{std::vector<float>{0.0f}, std::vector<float>{0.0f}, {}};
+    VirtualHal device{0, air, 1};
+
+    device.wake(false);
+    auto const& profile = device.wake_profile();
+    EXPECT_EQ(profile.wakes, 1u);
+    EXPECT_EQ(phase_us(profile, WakePhase::SCAN),
+              static_cast<std::uint64_t>(SCAN_SECONDS) * uS_TO_S_FACTOR);
+    EXPECT_EQ(phase_us(profile, WakePhase::TREATMENT), 0u);
+    EXPECT_EQ(phase_us(profile, WakePhase::DEEP_SLEEP), device.sleep_us());
+
+    // Two slow blinks and eight fast blinks
+    device.wake(true);
+    EXPECT_EQ(profile.wakes, 2u);
+    EXPECT_EQ(phase_us(profile, WakePhase::TREATMENT), 5600000u);
+    EXPECT_EQ(device.awake_us(),
+              phase_us(profile, WakePhase::SCAN) + phase_us(profile, WakePhase::TREATMENT));
+}
+
+TEST(WakeProfileTests, BatteryLifeFollowsAveragePower) {
+    WakeProfile profile{};
+    EXPECT_EQ(battery_life_hours(profile, 1000.0), 0.0);
+
+    // One hour at 330 mW
+    WakeProfiler profiler{profile, 0};
+    profiler.enter(WakePhase::SCAN, 0);
+    profiler.finish(3600ULL * uS_TO_S_FACTOR, 0);
+
+    EXPECT_NEAR(average_power_mw(profile), 330.0, 1e-6);
+    EXPECT_NEAR(battery_life_hours(profile, 100.0), 1.0, 1e-6);
+}
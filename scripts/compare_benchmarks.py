@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Flags benchmarks that got slower than the committed baseline
+#
+# Usage: compare_benchmarks.py baseline.json results.json [--threshold 0.10]
+# Both files are Google Benchmark JSON output (--benchmark_out_format=json).
+# Exits with status 1 if any benchmark regressed by more than the threshold.
+import argparse
+import json
+import sys
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    """Returns {benchmark name: cpu time in ns} for the runs in a results file"""
+    with open(path) as f:
+        data = json.load(f)
+
+    times = {}
+    for bench in data["benchmarks"]:
+        if bench.get("error_occurred"):
+            continue
+        # With --benchmark_repetitions only the median is compared
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") != "median":
+                continue
+            name = bench["run_name"]
+        elif "run_name" in bench and bench.get("repetitions", 1) > 1:
+            continue
+        else:
+            name = bench["name"]
+        times[name] = bench["cpu_time"] * TIME_UNIT_NS[bench.get("time_unit", "ns")]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare Google Benchmark results against a baseline"
+    )
+    parser.add_argument("baseline", help="committed baseline JSON")
+    parser.add_argument("results", help="JSON from the current build")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.10,
+        help="relative slowdown that counts as a regression (default: 0.10)",
+    )
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    results = load(args.results)
+
+    regressions = []
+    width = max((len(name) for name in results), default=0)
+    for name, time in results.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'new':>8}")
+            continue
+        change = time / baseline[name] - 1.0
+        flag = "  REGRESSION" if change > args.threshold else ""
+        print(f"{name:<{width}}  {change:+8.1%}{flag}")
+        if flag:
+            regressions.append(name)
+
+    for name in baseline.keys() - results.keys():
+        print(f"{name:<{width}}  {'missing':>8}")
+
+    if regressions:
+        print(
+            f"\n{len(regressions)} benchmark(s) slower than baseline by more than "
+            f"{args.threshold:.0%}"
+        )
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
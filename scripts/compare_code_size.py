@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Flags object files whose code grew past the committed baseline
+#
+# Usage: compare_code_size.py baseline.json object.o... [--size-tool size] [--update]
+# Sizes are the text column of Berkeley `size` output: code, constants and unwind
+# tables. Exits with status 1 if any object grew. --update rewrites the baseline.
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+
+def name_of(path):
+    """Returns the source name of an object, such as health_monitor_core for health_monitor_core.cpp.o"""
+    return os.path.basename(path).split(".")[0]
+
+
+def text_size(size_tool, path):
+    """Returns the text size of an object file in bytes"""
+    output = subprocess.run(
+        [size_tool, path], check=True, capture_output=True, text=True
+    ).stdout
+    # First line is the header, then: text data bss dec hex filename
+    return int(output.splitlines()[1].split()[0])
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare object code sizes against a baseline"
+    )
+    parser.add_argument("baseline", help="committed baseline JSON")
+    parser.add_argument("objects", nargs="+", help="object files from the current build")
+    parser.add_argument(
+        "--size-tool", default="size", help="binutils size for the target (default: size)"
+    )
+    parser.add_argument(
+        "--update", action="store_true", help="write the current sizes to the baseline"
+    )
+    args = parser.parse_args()
+
+    # CMake passes the objects of a target as one semicolon separated list
+    objects = [path for arg in args.objects for path in arg.split(";") if path]
+    sizes = {name_of(path): text_size(args.size_tool, path) for path in objects}
+
+    if args.update:
+        with open(args.baseline, "w") as f:
+            json.dump(sizes, f, indent=2, sort_keys=True)
+            f.write("\n")
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    grown = []
+    width = max(len(name) for name in sizes)
+    for name, size in sorted(sizes.items()):
+        if name not in baseline:
+            print(f"{name:<{width}}  {size:>6}  {'new':>6}")
+            continue
+        change = size - baseline[name]
+        flag = "  GREW" if change > 0 else ""
+        print(f"{name:<{width}}  {size:>6}  {change:+6}{flag}")
+        if flag:
+            grown.append(name)
+
+    if grown:
+        print(f"\n{len(grown)} object(s) larger than baseline")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
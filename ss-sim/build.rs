@@ -0,0 +1,23 @@
+// Links the C++ health monitor library when the `firmware` feature is enabled.
+//
+// Build the library first, then point SUPERSPREADER_LIB_DIR at the build directory:
+//   cmake -S ../arduino -B ../arduino/build
+//   cmake --build ../arduino/build --target superspreader_health_monitor
+//   cargo test --features firmware
+use std::env;
+
+fn main() {
+    println!("cargo:rerun-if-env-changed=SUPERSPREADER_LIB_DIR");
+    if env::var_os("CARGO_FEATURE_FIRMWARE").is_none() {
+        return;
+    }
+
+    let lib_dir = env::var("SUPERSPREADER_LIB_DIR").unwrap_or_else(|_| {
+        let manifest_dir = env::var("CARGO_MANIFEST_DIR").expect("set by cargo");
+        format!("{manifest_dir}/../arduino/build")
+    });
+    println!("cargo:rustc-link-search=native={lib_dir}");
+    println!("cargo:rustc-link-lib=static=superspreader_health_monitor");
+    println!("cargo:rustc-link-lib=dylib=stdc++");
+    println!("cargo:rerun-if-changed={lib_dir}/libsuperspreader_health_monitor.a");
+}
@@ -0,0 +1,257 @@
+// Shipping player engine rules from the C++ health monitor library, through its C ABI
+// (arduino/health_monitor/health_monitor_c.h)
+use crate::player::{ExposureEvent, Player};
+
+/// Version of the C ABI these bindings were written against
+pub const ABI_VERSION: u32 = 1;
+
+mod ffi {
+    use crate::player::ExposureEvent;
+
+    extern "C" {
+        pub fn ss_abi_version() -> u32;
+        pub fn ss_zombie_health() -> u32;
+        pub fn ss_exposure_update(health: u32, human: u32, cat: u32) -> u32;
+        pub fn ss_treatment_update(health: u32) -> u32;
+        pub fn ss_idle_update(health: u32, ticks: u64) -> u32;
+        pub fn ss_exposure_update_batch(
+            health: *mut u32,
+            human: *const u32,
+            cat: *const u32,
+            count: usize,
+        );
+        pub fn ss_exposure_update_events_batch(
+            health: *mut u32,
+            exposures: *const ExposureEvent,
+            count: usize,
+        );
+        pub fn ss_treatment_update_batch(health: *mut u32, treated: *const u8, count: usize);
+        pub fn ss_cat_resistant_exposure_update(
+            health: u32,
+            cat_resistant: *mut u8,
+            human: u32,
+            cat: u32,
+        ) -> u32;
+        pub fn ss_cat_resistant_exposure_update_batch(
+            health: *mut u32,
+            cat_resistant: *mut u8,
+            human: *const u32,
+            cat: *const u32,
+            count: usize,
+        );
+    }
+}
+
+// Every C function is pure over its arguments and only touches the slices it is
+// given, so the safe wrappers only need to check slice lengths.
+
+pub fn abi_version() -> u32 {
+    unsafe { ffi::ss_abi_version() }
+}
+
+pub fn zombie_health() -> u32 {
+    unsafe { ffi::ss_zombie_health() }
+}
+
+pub fn exposure_update(health: u32, exposure: &ExposureEvent) -> u32 {
+    unsafe { ffi::ss_exposure_update(health, exposure.human, exposure.cat) }
+}
+
+pub fn treatment_update(health: u32) -> u32 {
+    unsafe { ffi::ss_treatment_update(health) }
+}
+
+pub fn idle_update(health: u32, ticks: u64) -> u32 {
+    unsafe { ffi::ss_idle_update(health, ticks) }
+}
+
+/// Updates every player in place, player i exposed to human[i] infected humans and cat[i] cats
+pub fn exposure_update_batch(health: &mut [u32], human: &[u32], cat: &[u32]) {
+    assert!(human.len() == health.len() && cat.len() == health.len());
+    unsafe {
+        ffi::ss_exposure_update_batch(
+            health.as_mut_ptr(),
+            human.as_ptr(),
+            cat.as_ptr(),
+            health.len(),
+        )
+    }
+}
+
+/// Updates every player in place, player i seeing exposures[i]
+pub fn exposure_update_events_batch(health: &mut [u32], exposures: &[ExposureEvent]) {
+    assert_eq!(exposures.len(), health.len());
+    unsafe {
+        ffi::ss_exposure_update_events_batch(health.as_mut_ptr(), exposures.as_ptr(), health.len())
+    }
+}
+
+/// Treats every player in place, or only those with a non-zero entry in `treated`
+pub fn treatment_update_batch(health: &mut [u32], treated: Option<&[u8]>) {
+    let treated = match treated {
+        Some(treated) => {
+            assert_eq!(treated.len(), health.len());
+            treated.as_ptr()
+        }
+        None => std::ptr::null(),
+    };
+    unsafe { ffi::ss_treatment_update_batch(health.as_mut_ptr(), treated, health.len()) }
+}
+
+/// Cat resistant rules over every player in place, tracking each player's resistance flag
+pub fn cat_resistant_exposure_update_batch(
+    health: &mut [u32],
+    cat_resistant: &mut [u8],
+    human: &[u32],
+    cat: &[u32],
+) {
+    assert!(
+        cat_resistant.len() == health.len()
+            && human.len() == health.len()
+            && cat.len() == health.len()
+    );
+    unsafe {
+        ffi::ss_cat_resistant_exposure_update_batch(
+            health.as_mut_ptr(),
+            cat_resistant.as_mut_ptr(),
+            human.as_ptr(),
+            cat.as_ptr(),
+            health.len(),
+        )
+    }
+}
+
+impl Player {
+    /// Same as `exposure_update`, computed by the firmware's cat resistant rules
+    pub fn firmware_exposure_update(&mut self, exposure: &ExposureEvent) {
+        let mut cat_resistant = u8::from(self.cat_resistance);
+        self.health = unsafe {
+            ffi::ss_cat_resistant_exposure_update(
+                self.health,
+                &mut cat_resistant,
+                exposure.human,
+                exposure.cat,
+            )
+        };
+        self.cat_resistance = cat_resistant != 0;
+    }
+
+    /// Same as `treatment_update`, computed by the firmware
+    pub fn firmware_treatment_update(&mut self) {
+        self.health = treatment_update(self.health);
+    }
+}
+
+// TESTS ///////////////////////////////////////////////////
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const MAX_HEALTH: u32 = 120;
+
+    /// Where the hand-written rules have drifted from the firmware: immune is 0 here
+    /// and 1 on the firmware, and zombie starts at 100 here but at 99 on the
+    /// firmware, which also caps health there and cannot be treated.
+    fn is_known_drift(health: u32, rust: u32, firmware: u32) -> bool {
+        (rust == 0 && firmware == 1) || (rust >= 99 && firmware == 99) || health == 99
+    }
+
+    #[test]
+    fn abi_version_matches() {
+        assert_eq!(abi_version(), ABI_VERSION);
+        assert_eq!(zombie_health(), 99);
+    }
+
+    #[test]
+    fn exposure_update_differs_only_by_known_drift() {
+        for health in 0..=MAX_HEALTH {
+            for cat_resistance in [false, true] {
+                for human in 0..4 {
+                    for cat in 0..3 {
+                        let exposure = ExposureEvent { human, cat };
+                        let mut rust = Player {
+                            health,
+                            cat_resistance,
+                            ..Player::default()
+                        };
+                        let mut firmware = rust.clone();
+                        rust.exposure_update(&exposure);
+                        firmware.firmware_exposure_update(&exposure);
+
+                        assert!(
+                            rust == firmware
+                                || is_known_drift(health, rust.health, firmware.health),
+                            "health {health} resistant {cat_resistance} exposure {exposure:?}: \
+                             {rust:?} != {firmware:?}"
+                        );
+                        assert_eq!(rust.cat_resistance, firmware.cat_resistance);
+                    }
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn treatment_update_differs_only_by_known_drift() {
+        for health in 0..=MAX_HEALTH {
+            let mut rust = Player {
+                health,
+                ..Player::default()
+            };
+            let mut firmware = rust.clone();
+            rust.treatment_update();
+            firmware.firmware_treatment_update();
+            assert!(
+                rust == firmware || is_known_drift(health, rust.health, firmware.health),
+                "health {health}: {rust:?} != {firmware:?}"
+            );
+        }
+    }
+
+    #[test]
+    fn batches_match_single_player() {
+        let health: Vec<u32> = (0..=MAX_HEALTH).collect();
+        let human: Vec<u32> = health.iter().map(|h| h % 4).collect();
+        let cat: Vec<u32> = health.iter().map(|h| h % 3).collect();
+        let exposures: Vec<ExposureEvent> = human
+            .iter()
+            .zip(&cat)
+            .map(|(&human, &cat)| ExposureEvent { human, cat })
+            .collect();
+        let treated: Vec<u8> = health.iter().map(|h| (h % 2) as u8).collect();
+
+        let mut exposed = health.clone();
+        exposure_update_batch(&mut exposed, &human, &cat);
+        let mut exposed_events = health.clone();
+        exposure_update_events_batch(&mut exposed_events, &exposures);
+        let mut treated_all = health.clone();
+        treatment_update_batch(&mut treated_all, None);
+        let mut treated_some = health.clone();
+        treatment_update_batch(&mut treated_some, Some(&treated));
+        let mut resistant = health.clone();
+        let mut flags = vec![0u8; health.len()];
+        cat_resistant_exposure_update_batch(&mut resistant, &mut flags, &human, &cat);
+
+        for (i, &h) in health.iter().enumerate() {
+            assert_eq!(exposed[i], exposure_update(h, &exposures[i]));
+            assert_eq!(exposed_events[i], exposed[i]);
+            assert_eq!(treated_all[i], treatment_update(h));
+            let expected = if treated[i] != 0 {
+                treatment_update(h)
+            } else {
+                h
+            };
+            assert_eq!(treated_some[i], expected);
+
+            let mut player = Player {
+                health: h,
+                ..Player::default()
+            };
+            player.firmware_exposure_update(&exposures[i]);
+            assert_eq!(resistant[i], player.health);
+            assert_eq!(flags[i] != 0, player.cat_resistance);
+        }
+        assert_eq!(idle_update(5, 1000), 10);
+    }
+}
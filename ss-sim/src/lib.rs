@@ -1 +1,3 @@
+#[cfg(feature = "firmware")]
+pub mod firmware;
 pub mod player;
@@ -5,7 +5,7 @@ use std::convert::From;
 pub struct Player {
     pub tick: u32,
     pub health: u32,
-    cat_resistance: bool,
+    pub(crate) cat_resistance: bool,
 }
 
 // health starts at 2 for the starting condition of player
@@ -19,6 +19,8 @@ impl Default for Player {
     }
 }
 
+// Laid out as the firmware's ss_exposure, so slices pass to it without copying
+#[repr(C)]
 #[derive(Debug, Default)]
 pub struct ExposureEvent {
     pub human: u32,
@@ -33,8 +35,9 @@ impl Player {
         match state {
             HealthState::Zombie | HealthState::Immune => (),
             _ => {
-                self.health +=
-                    self.time_increase() - self.time_decrease() + self.exposure_increase(exposure);
+                // Decrease last, healthy decay alone would underflow
+                self.health = self.health + self.time_increase() + self.exposure_increase(exposure)
+                    - self.time_decrease();
             }
         }
 